@@ -1,12 +1,17 @@
 ﻿#include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <cassert>
 #include <vector>
 #include <iostream>
 #include <random>
 #include <sstream>
 #include <fstream>
 #include <string>
+#include <chrono>
+#include <cstddef>
+#include <algorithm>
+#include <memory>
 
 #include <glm/vec3.hpp>
 #include <glm/glm.hpp>
@@ -16,15 +21,42 @@
 #include <SOIL/SOIL.h>
 
 #include "source/stl.h"
-#include "source/shader.h"
+#include "source/Log.h"
 #include "source/LightSource.h"
 #include "source/Material.h"
 #include "source/Triangle.h"
 #include "source/MeshModifier.h"
+#include "source/MeshCleanup.h"
+#include "source/MeshTransform.h"
+#include "source/MeshRegistry.h"
+#include "source/Scene.h"
+#include "source/InstanceBuffer.h"
+#include "source/RenderQueue.h"
+#include "source/GlStateCache.h"
+#include "source/UniformBlocks.h"
+#include "source/UniformRing.h"
+#include "source/IndirectDraws.h"
+#include "source/ProgramCache.h"
+#include "source/ShaderPreprocessor.h"
+#include "source/ShaderScheduler.h"
+#include "source/MipChain.h"
+#include "source/BlockCompression.h"
+#include "source/TextureLoader.h"
+#include "source/Profiler.h"
+#include "source/GpuProfiler.h"
+#include "source/JobSystem.h"
+#include "source/Simulation.h"
+#include "source/FramePacer.h"
+#include "source/FrameArena.h"
+#include "source/AllocationCounter.h"
+#include "source/AssetMemory.h"
+#include "source/ChunkedMesh.h"
+#include "source/ChunkStreamer.h"
+#include "source/ChunkBufferPool.h"
 
 static void error_callback(int /*error*/, const char* description)
 {
-	std::cerr << "Error: " << description << std::endl;
+	Log(LogLevel::Error) << "GLFW : " << description;
 }
 
 static void key_callback(GLFWwindow* window, int key, int /*scancode*/, int action, int /*mods*/)
@@ -41,15 +73,39 @@ void APIENTRY opengl_error_callback(GLenum source,
 	const GLchar* message,
 	const void* userParam)
 {
-	std::cout << message << std::endl;
+	// Appelé sur le thread du contexte (GL_DEBUG_OUTPUT_SYNCHRONOUS) : le message est seulement copié dans le journal
+	const auto level = severity == GL_DEBUG_SEVERITY_HIGH ? LogLevel::Error
+		: severity == GL_DEBUG_SEVERITY_MEDIUM ? LogLevel::Warning
+		: severity == GL_DEBUG_SEVERITY_LOW ? LogLevel::Info
+		: LogLevel::Debug;
+	Log(level) << "GL : " << message;
 }
 
+// GL_EXT_texture_compression_s3tc, absent du loader glad (4.6 core sans extensions)
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+// Façon de soumettre les entités au GPU
+enum class RenderMode
+{
+	Direct,           // un glDrawArrays par entité, ordonnés par la file de commandes
+	Instanced,        // un glDrawArraysInstancedBaseInstance par maillage, données dans un buffer d'instances
+	MultiDrawIndirect // un seul glMultiDrawArraysIndirect, données de draw lues avec gl_DrawIDARB
+};
+
 std::ostream& operator<<(std::ostream& os, const glm::vec3& v)
 {
 	os << '(' << v.x << ", " << v.y << ", " << v.z << ')' << '\n';
 	return os;
 }
 
+std::ostream& operator<<(std::ostream& os, const CleanupReport& r)
+{
+	os << r.kept << " kept, " << r.degenerate << " degenerate, " << r.nearDegenerate << " near degenerate, " << r.duplicate << " duplicate";
+	return os;
+}
+
 int main(void)
 {
 #pragma region Create and open a window
@@ -73,13 +129,26 @@ int main(void)
 
 	glfwSetKeyCallback(window, key_callback);
 	glfwMakeContextCurrent(window);
-	glfwSwapInterval(1);
+
+	// Mode de présentation : Vsync, Uncapped, Limited (limitedFps) ou JustInTime (entrées lues juste avant le
+	// rendu, calé sur la fréquence de l'écran). L'histogramme des durées de frame est affiché à la fin pour comparer.
+	const PresentMode presentMode = PresentMode::Vsync;
+	const double limitedFps = 144.0;
+	const auto videoMode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+	const double refreshRate = videoMode ? videoMode->refreshRate : 60.0;
+	FramePacer framePacer(presentMode, presentMode == PresentMode::Limited ? limitedFps : refreshRate);
+	glfwSwapInterval(framePacer.SwapInterval());
+
+	// Pool commun des chargements, des traitements de maillages et de la mise à jour : créé ici, le thread
+	// principal (celui du contexte GL) est celui qui exécute les tâches SubmitMain
+	auto& jobs = JobSystem::Instance();
+	Log(LogLevel::Info) << "Job system : " << jobs.ThreadCount() << " threads";
 #pragma endregion
 
 #pragma region Read and bind shader program
 	// R�cup�re les fonctions pointeurs d'OpenGL du driver
 	if (!gladLoadGL()) {
-		std::cerr << "Something went wrong!" << std::endl;
+		Log(LogLevel::Error) << "Something went wrong!";
 		exit(-1);
 	}
 
@@ -88,65 +157,237 @@ int main(void)
 	glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
 
 	// Charge et lie les shaders au contexte open gl
-	// Shader
-	const auto vertex = MakeShader(GL_VERTEX_SHADER, "resources/shaders/shader.vert");
-	const auto fragment = MakeShader(GL_FRAGMENT_SHADER, "resources/shaders/shader.frag");
+	// Les binaires liés sont gardés sur disque : les lancements suivants évitent la compilation.
+	// Tous les programmes sont soumis ici et compilés par le driver pendant le chargement des modèles et textures.
+	const ProgramCache programCache("cache/programs");
+	ShaderScheduler shaders(&programCache, glfwGetProcAddress);
+	const auto startupStart = std::chrono::steady_clock::now();
+
+	// Permutation du fragment shader : sans texture, l'échantillonnage disparaît à la compilation
+	const bool textured = true;
+	const ShaderDefines fragmentDefines = { { "TEXTURED", textured ? "1" : "0" } };
+
+	const auto programId = shaders.Submit("shader", {
+		{ GL_VERTEX_SHADER, "resources/shaders/shader.vert" },
+		{ GL_FRAGMENT_SHADER, "resources/shaders/shader.frag", fragmentDefines } });
+
+	// multidraw.vert exige GL_ARB_shader_draw_parameters, qui n'est pas core en 4.5 : sans elle on se rabat sur
+	// l'instanciation, et le programme n'est ni soumis ni lié
+	const RenderMode requestedRenderMode = RenderMode::Direct;
+	const auto drawParameters = glfwExtensionSupported("GL_ARB_shader_draw_parameters") == GLFW_TRUE;
+	const RenderMode renderMode = requestedRenderMode == RenderMode::MultiDrawIndirect && !drawParameters ? RenderMode::Instanced : requestedRenderMode;
+	if (renderMode != requestedRenderMode)
+		Log(LogLevel::Warning) << "GL_ARB_shader_draw_parameters not supported : multi draw indirect replaced by instancing";
+
+	const auto instancedProgramId = shaders.Submit("instanced", {
+		{ GL_VERTEX_SHADER, "resources/shaders/instanced.vert" },
+		{ GL_FRAGMENT_SHADER, "resources/shaders/shader.frag", fragmentDefines } });
+
+	const auto multiDrawProgramId = renderMode == RenderMode::MultiDrawIndirect ? shaders.Submit("multidraw", {
+		{ GL_VERTEX_SHADER, "resources/shaders/multidraw.vert" },
+		{ GL_FRAGMENT_SHADER, "resources/shaders/shader.frag", fragmentDefines } }) : 0;
+
+	// Filtre les changements d'état et d'uniforms redondants
+	GlStateCache glState(MakeGlDispatch());
+#pragma endregion
 
-	const auto program = AttachAndLink({ vertex, fragment });
+#pragma region Static transforms
+	// Transformations fixes de chaque modèle
+	glm::mat4 yodaTransform(glm::mat4(1.0f));
+	yodaTransform = glm::rotate(yodaTransform, glm::radians(180.0f), glm::vec3(0, 1, 0));
+	yodaTransform = glm::rotate(yodaTransform, glm::radians(-90.0f), glm::vec3(1, 0, 0));
+	yodaTransform = glm::scale(yodaTransform, glm::vec3(0.01f, 0.01f, 0.01f));
 
-	glUseProgram(program);
+	glm::mat4 djinnTransform(glm::mat4(1.0f));
+	djinnTransform = glm::rotate(djinnTransform, glm::radians(90.0f), glm::vec3(1, 0, 0));
+	djinnTransform = glm::rotate(djinnTransform, glm::radians(-135.0f), glm::vec3(0, 1, 0));
+	djinnTransform = glm::scale(djinnTransform, glm::vec3(0.01f, 0.01f, 0.01f));
+
+	// Applique les transformations aux vertices au chargement au lieu de chaque frame dans shader.vert.
+	// L'éclairage est calculé dans l'espace du modèle : le rendu change d'aspect une fois les vertices transformés.
+	const bool bakeStaticTransforms = false;
+
+	// Modèle plus grand que la mémoire, découpé en morceaux sur disque puis streamé autour du curseur ; nullptr pour s'en passer.
+	// Le découpage n'est refait que si le STL ou les options changent.
+	const char* outOfCoreModel = nullptr; // ex. "resources/models/djinn_mars.stl"
+	const glm::mat4 outOfCoreTransform = djinnTransform;
+	const glm::vec2 outOfCoreTranslate(0.5f, 0.0f);
 #pragma endregion
 
 #pragma region Setup vertex buffers
+	// Décodage, atlas, mips et compression BC1 des textures dans le pool pendant le chargement des modèles
+	// (BC1 : 4 bits par pixel au lieu de 24 en GL_RGB8, si le driver expose S3TC)
+	TextureOptions textureOptions;
+	textureOptions.channels = SOIL_LOAD_RGB;
+	textureOptions.filter = MipFilter::Box;
+	textureOptions.compression = glfwExtensionSupported("GL_EXT_texture_compression_s3tc") ? TextureCompression::Bc1 : TextureCompression::None;
+	textureOptions.quality = Bc1Quality::Normal;
+
+	const TextureCache textureCache("cache/textures");
+	// Une image par modèle, toutes dans le même atlas : changer de matériau ne change que la zone lue, jamais la texture
+	const std::vector<std::string> texturePaths = { "resources/textures/david_goodenough.jpg" };
+	const size_t yodaTexture = 0, djinnTexture = 0;
+	AtlasOptions atlasOptions;
+	atlasOptions.padding = 8; // bordures intactes jusqu'au mip 3
+	atlasOptions.alignment = 4;
+	auto textureLoad = LoadTextureAtlasAsync(texturePaths, textureOptions, atlasOptions, &textureCache);
+
 	// D�finie les matrices de donn�es stockants les vertices du mod�les
 	// Buffers
-	GLuint vbo, vao;
-	glGenBuffers(1, &vbo);
+	GLuint vao;
 	glGenVertexArrays(1, &vao);
 
+	// Lecture des deux modèles en parallèle dans le pool
+	auto yodaRead = jobs.Async([]() { return ReadStl("resources/models/baby_yoda.stl"); });
+	auto djinnRead = jobs.Async([]() { return ReadStl("resources/models/djinn_mars.stl"); });
+
+	// Découpage du modèle streamé, en parallèle du reste du chargement
+	const ChunkBuildOptions chunkOptions;
+	const auto chunkKey = outOfCoreModel ? MakeChunkFileKey(outOfCoreModel, chunkOptions) : 0;
+	const auto chunkPath = ChunkFilePath("cache/chunks", chunkKey);
+	auto chunkBuild = jobs.Async([&]()
+	{
+		if (!outOfCoreModel || ChunkFile::Matches(chunkPath, chunkKey))
+			return ChunkBuildReport{};
+		return BuildChunkFile(outOfCoreModel, chunkPath, chunkKey, chunkOptions);
+	});
+
 	// Modèle brute
-	auto babyYodaRaw = ReadStl("resources/models/baby_yoda.stl");
-	std::cout << babyYodaRaw.size() << std::endl;
+	auto babyYodaRaw = yodaRead.Get();
+	Log(LogLevel::Info) << babyYodaRaw.size();
+	Log(LogLevel::Info) << "Yoda Cleanup : " << RemoveDegenerateTriangles(babyYodaRaw);
 	const auto nTrianglesYoda = babyYodaRaw.size();
 
-	auto djinnMarsRaw = ReadStl("resources/models/djinn_mars.stl");
-	std::cout << djinnMarsRaw.size() << std::endl;
+	auto djinnMarsRaw = djinnRead.Get();
+	Log(LogLevel::Info) << djinnMarsRaw.size();
+	Log(LogLevel::Info) << "Djinn Cleanup : " << RemoveDegenerateTriangles(djinnMarsRaw);
 	const auto nTrianglesDjinn = djinnMarsRaw.size();
+	shaders.Poll();
 
-	// Fusionne les modèles en un buffer
-	std::vector<TriangleWithNormal> tris;
-	tris.reserve(nTrianglesYoda + nTrianglesDjinn);
+	TriangleWithNormalList yodaTris;
+	yodaTris.reserve(nTrianglesYoda);
 	CenterAllVertex(babyYodaRaw);
-	CreateTriangleWithNormals(babyYodaRaw, tris);
+	CreateTriangleWithNormals(babyYodaRaw, yodaTris);
+
+	TriangleWithNormalList djinnTris;
+	djinnTris.reserve(nTrianglesDjinn);
 	CenterAllVertex(djinnMarsRaw);
-	CreateTriangleWithNormals(djinnMarsRaw, tris);
+	CreateTriangleWithNormals(djinnMarsRaw, djinnTris);
+
+	// Les modèles bruts ne servent plus : rendus tout de suite plutôt qu'à la fin du main
+	TriangleList().swap(babyYodaRaw);
+	TriangleList().swap(djinnMarsRaw);
+
+	if (bakeStaticTransforms)
+	{
+		const auto bakeStart = std::chrono::steady_clock::now();
+		BakeTransform(yodaTris, yodaTransform);
+		BakeTransform(djinnTris, djinnTransform);
+		const std::chrono::duration<double, std::milli> bakeTime = std::chrono::steady_clock::now() - bakeStart;
+
+		// Coût unique au chargement, à comparer aux 3 * nTriangles multiplications matricielles économisées par frame
+		Log(LogLevel::Info) << "Bake : " << bakeTime.count() << " ms for " << (nTrianglesYoda + nTrianglesDjinn) * 3 << " vertices";
+
+		yodaTransform = glm::mat4(1.0f);
+		djinnTransform = glm::mat4(1.0f);
+	}
+
+	const auto nTriangles = nTrianglesYoda + nTrianglesDjinn;
 
-	const auto nTriangles = tris.size();
+	Log(LogLevel::Info) << "Yoda Size : " << nTrianglesYoda;
+	Log(LogLevel::Info) << "Djinn Size : " << nTrianglesDjinn;
+	Log(LogLevel::Info) << "Total Size : " << nTriangles * sizeof(TriangleWithNormal);
 
-	std::cout << "Yoda Size : " << nTrianglesYoda << std::endl;
-	std::cout << "Djinn Size : " << nTrianglesDjinn << std::endl;
-	std::cout << "Total Size : " << nTriangles * sizeof(TriangleWithNormal) << std::endl;
+	// Un seul VBO partagé par tous les modèles, avec de la place pour en ajouter à l'exécution
+	MeshRegistry meshes(2 * nTriangles * sizeof(TriangleWithNormal));
+	const auto yodaMesh = meshes.Add(yodaTris);
+	const auto djinnMesh = meshes.Add(djinnTris);
 
-	glBindVertexArray(vao);
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-	glBufferData(GL_ARRAY_BUFFER, nTriangles * sizeof(TriangleWithNormal), tris.data(), GL_STATIC_DRAW);
+	const auto meshStats = meshes.Stats();
+	Log(LogLevel::Info) << "Mesh buffer : " << meshStats.used << " / " << meshStats.capacity << " bytes, " << meshStats.allocationCount << " meshes";
+
+	glState.BindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, meshes.Buffer());
+	shaders.Poll();
 #pragma endregion
 
 #pragma region Setup Textures
-	int width(1280);
-	int height(720);
-	auto texture = SOIL_load_image("resources/textures/david_goodenough.jpg", &width, &height, 0, SOIL_LOAD_RGB);
-
-	// Create an OpenGL texture
-	GLuint texC;
-	glCreateTextures(GL_TEXTURE_2D, 1, &texC);
-	glTextureStorage2D(texC, 5, GL_RGB8, width, height);
-
-	// Send the data
-	glPixelStorei(GL_PACK_ALIGNMENT, 1);
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-	glTextureSubImage2D(texC, 0, 0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, texture);
-	glGenerateTextureMipmap(texC);
+	// Les appels GL ne se font que sur le thread principal : l'envoi est une tâche SubmitMain qui part à la fin du
+	// chargement, Wait l'exécute ici
+	LoadedTexture loadedTexture;
+	GLuint texC = 0;
+	TrackedBytes textureBytes(MemoryCategory::GpuTexture);
+	const auto textureUpload = jobs.SubmitMain([&]()
+	{
+		loadedTexture = textureLoad.Get();
+		const auto& textureLevels = loadedTexture.levels;
+		if (loadedTexture.fromCache)
+			Log(LogLevel::Info) << "Texture : " << textureLevels.size() << " levels from cache";
+		else
+		{
+			Log(LogLevel::Info) << "Texture : decode " << loadedTexture.decodeMs << " ms, " << textureLevels.size() << " levels in " << loadedTexture.mipMs << " ms";
+			Log(LogLevel::Info) << "Atlas : " << texturePaths.size() << " images, " << textureLevels[0].width << "x" << textureLevels[0].height
+				<< " packed in " << loadedTexture.packMs << " ms, " << loadedTexture.occupancy * 100.0 << " % occupancy";
+		}
+
+		const auto compressed = loadedTexture.compression == TextureCompression::Bc1;
+		if (compressed && !loadedTexture.fromCache)
+		{
+			size_t texels = 0;
+			for (const auto& image : textureLevels)
+				texels += (size_t) image.width * image.height;
+			Log(LogLevel::Info) << "Texture BC1 : " << texels / (loadedTexture.compressMs * 1000.0) << " MPix/s, PSNR " << loadedTexture.psnr << " dB";
+		}
+
+		// Create an OpenGL texture
+		glCreateTextures(GL_TEXTURE_2D, 1, &texC);
+		glTextureStorage2D(texC, (GLsizei) textureLevels.size(), compressed ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_RGB8,
+			textureLevels[0].width, textureLevels[0].height);
+
+		// Send the data, mips comprises : plus de glGenerateTextureMipmap
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		for (size_t level = 0; level < textureLevels.size(); level++)
+		{
+			const auto& image = textureLevels[level];
+			if (compressed)
+				glCompressedTextureSubImage2D(texC, (GLint) level, 0, 0, image.width, image.height, GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+					(GLsizei) image.pixels.size(), image.pixels.data());
+			else
+				glTextureSubImage2D(texC, (GLint) level, 0, 0, image.width, image.height, GL_RGB, GL_UNSIGNED_BYTE, image.pixels.data());
+			textureBytes.Set(textureBytes.Bytes() + image.pixels.size());
+		}
+
+		// La copie CPU n'est plus utile une fois envoyée, seuls les rectangles UV restent
+		std::vector<TextureImage>().swap(loadedTexture.levels);
+	}, { textureLoad.Job() });
+	jobs.Wait(textureUpload);
+#pragma endregion
+
+#pragma region Wait for shader programs
+	// Premier usage des programmes : on attend ceux qui compilent encore
+	shaders.WaitAll();
+	const auto startupTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupStart).count();
+
+	Log(LogLevel::Info) << "Shader compile : " << (shaders.ParallelCompile() ? "parallel" : "driver default");
+	for (size_t i = 0; i < shaders.Size(); i++)
+	{
+		const auto& timing = shaders.Timing(i);
+		Log(LogLevel::Info) << "  " << shaders.Name(i) << " : submit " << timing.submitMs << " ms, ready after " << timing.readyMs << " ms"
+			<< (timing.fromCache ? " (cache)" : "");
+	}
+	Log(LogLevel::Info) << "Startup until programs ready : " << startupTime << " ms";
+	Log(LogLevel::Info) << "Shader sources : " << shaders.Preprocessor().CacheMisses() << " expanded, "
+		<< shaders.Preprocessor().CacheHits() << " reused, " << shaders.Deduplicated() << " duplicate programs";
+
+	const auto program = shaders.Program(programId);
+	const auto instancedProgram = shaders.Program(instancedProgramId);
+	const GLuint multiDrawProgram = renderMode == RenderMode::MultiDrawIndirect ? shaders.Program(multiDrawProgramId) : 0;
+
+	const auto activeProgram = renderMode == RenderMode::Instanced ? instancedProgram
+		: renderMode == RenderMode::MultiDrawIndirect ? multiDrawProgram
+		: program;
+	glState.UseProgram(activeProgram);
 #pragma endregion
 
 #pragma region Vertex Shader Loc
@@ -165,115 +406,409 @@ int main(void)
 	glVertexAttribPointer(locNormal, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3), (const void*) sizeof(glm::vec3));
 	glEnableVertexAttribArray(locNormal);
 
-
-	const auto locTranslate(glGetUniformLocation(program, "translate"));
-	assert(locTranslate != -1);
-
-	const auto locTransform(glGetUniformLocation(program, "transform"));
-	assert(locTransform != -1);
 #pragma endregion
 
 #pragma region Fragment Shader Loc
-	const auto locLightPosition(glGetUniformLocation(program, "lightPosition"));
-	assert(locLightPosition != -1);
+	const auto locTexture(glGetUniformLocation(activeProgram, "tex"));
+	assert(!textured || locTexture != -1);
+#pragma endregion
 
-	const auto locLightEmitted(glGetUniformLocation(program, "lightEmitted"));
-	assert(locLightEmitted != -1);
+#pragma region Instancing
+	// Même VBO de maillages, plus un buffer d'instances lu une fois par instance (emplacements fixés dans instanced.vert)
+	GLuint instanceVao, instanceVbo;
+	glGenVertexArrays(1, &instanceVao);
+	glCreateBuffers(1, &instanceVbo);
+	TrackedBytes instanceBytes(MemoryCategory::GpuBuffer);
+
+	glState.BindVertexArray(instanceVao);
+	glBindBuffer(GL_ARRAY_BUFFER, meshes.Buffer());
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3), nullptr);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3), (const void*) sizeof(glm::vec3));
+	glEnableVertexAttribArray(1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	for (GLuint column = 0; column < 4; column++)
+	{
+		glVertexAttribPointer(2 + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (const void*) (offsetof(InstanceData, transform) + column * sizeof(glm::vec4)));
+		glEnableVertexAttribArray(2 + column);
+		glVertexAttribDivisor(2 + column, 1);
+	}
+
+	glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (const void*) offsetof(InstanceData, translate));
+	glEnableVertexAttribArray(6);
+	glVertexAttribDivisor(6, 1);
+
+	glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (const void*) offsetof(InstanceData, albedo));
+	glEnableVertexAttribArray(7);
+	glVertexAttribDivisor(7, 1);
 
-	const auto locAlbedo(glGetUniformLocation(program, "albedo"));
-	assert(locAlbedo != -1);
+	glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData), (const void*) offsetof(InstanceData, uvRect));
+	glEnableVertexAttribArray(8);
+	glVertexAttribDivisor(8, 1);
 
-	const auto locTexture(glGetUniformLocation(program, "tex"));
-	assert(locTexture != -1);
+	std::vector<InstanceData> instances;
+	std::vector<InstanceBatch> batches;
 #pragma endregion
 
+#pragma region Multi draw indirect
+	// Sommets seuls (emplacements fixés dans multidraw.vert) ; commandes et données de draw régénérées à chaque frame
+	GLuint multiDrawVao, indirectBuffer, drawBuffer;
+	glGenVertexArrays(1, &multiDrawVao);
+	glCreateBuffers(1, &indirectBuffer);
+	glCreateBuffers(1, &drawBuffer);
+	TrackedBytes indirectBytes(MemoryCategory::GpuBuffer);
+	TrackedBytes drawBytes(MemoryCategory::GpuBuffer);
+
+	glState.BindVertexArray(multiDrawVao);
+	glBindBuffer(GL_ARRAY_BUFFER, meshes.Buffer());
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3), nullptr);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3), (const void*) sizeof(glm::vec3));
+	glEnableVertexAttribArray(1);
+
+	// Plages des maillages indexées par identifiant, recopiées du registre dès qu'il change
+	// (ajout, retrait ou défragmentation à l'exécution)
+	std::vector<DrawRange> meshRanges;
+	auto meshRangesGeneration = meshes.Generation() + 1;
+
+	std::vector<DrawArraysIndirectCommand> indirectCommands;
+	std::vector<DrawUniforms> indirectDraws;
+#pragma endregion
+
+#pragma region Out-of-core model
+	// Seule la table des morceaux est en mémoire ; les triangles passent du disque au cache CPU puis à des
+	// emplacements fixes d'un VBO, dessinés par le programme de base quel que soit le mode
+	std::unique_ptr<ChunkFile> chunkFile;
+	std::unique_ptr<ChunkStreamer> chunkStreamer;
+	std::unique_ptr<ChunkBufferPool> chunkBuffers;
+	GLuint chunkVao = 0;
+	std::vector<GLint> chunkFirsts;
+	std::vector<GLsizei> chunkCounts;
+
+	const auto chunkReport = chunkBuild.Get();
+	if (outOfCoreModel)
+	{
+		if (chunkReport.chunks > 0)
+			Log(LogLevel::Info) << "Chunks : " << chunkReport.triangles << " triangles (" << chunkReport.degenerate << " degenerate) in "
+				<< chunkReport.chunks << " chunks over " << chunkReport.cells << " cells, built in " << chunkReport.ms << " ms";
+
+		chunkFile = std::make_unique<ChunkFile>(chunkPath, chunkKey);
+		ChunkStreamerOptions streamerOptions;
+		streamerOptions.cpuBudgetBytes = 32 * 1024 * 1024;
+		streamerOptions.gpuSlots = 48;
+		chunkStreamer = std::make_unique<ChunkStreamer>(*chunkFile, streamerOptions, jobs);
+		chunkBuffers = std::make_unique<ChunkBufferPool>(chunkStreamer->GpuSlots(), chunkStreamer->SlotTriangles());
+		Log(LogLevel::Info) << "Chunk file : " << chunkFile->TriangleCount() << " triangles in " << chunkFile->Chunks().size() << " chunks, "
+			<< chunkStreamer->GpuSlots() << " GPU slots of " << chunkStreamer->SlotTriangles() << " triangles";
+
+		glGenVertexArrays(1, &chunkVao);
+		glState.BindVertexArray(chunkVao);
+		glBindBuffer(GL_ARRAY_BUFFER, chunkBuffers->Buffer());
+		glVertexAttribPointer(locPosition, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3), nullptr);
+		glEnableVertexAttribArray(locPosition);
+		glVertexAttribPointer(locNormal, 3, GL_FLOAT, GL_FALSE, 2 * sizeof(glm::vec3), (const void*) sizeof(glm::vec3));
+		glEnableVertexAttribArray(locNormal);
+
+		chunkFirsts.reserve(chunkStreamer->GpuSlots());
+		chunkCounts.reserve(chunkStreamer->GpuSlots());
+	}
+#pragma endregion
+
+	glState.BindVertexArray(renderMode == RenderMode::Instanced ? instanceVao
+		: renderMode == RenderMode::MultiDrawIndirect ? multiDrawVao
+		: vao);
+
 	// glPointSize(20.f);
 	//
 	glEnable(GL_DEPTH_TEST);
 
-	const glm::vec2 SPEED(0.01f, 0.02f);
-	const glm::vec2 LIMIT(1.7f, 1.7f);
-	
-	float x = 0.2f;
-	float y = -0.4f;
-
-	glm::vec2 direction(1, 1);
-
 #pragma region Uniform variables
 	LightSource lightSource{ glm::vec3(50 * cos(glfwGetTime()), -150, 50), glm::vec3(40000, 40000, 40000) };
 
-	// Texture du modèle
-	glBindTextureUnit(0, texC);
-	glUniform1i(locTexture, 0);
+	// Atlas des textures des modèles, lié une fois pour toute la boucle
+	glState.BindTextureUnit(0, texC);
+	glState.Uniform1i(locTexture, 0);
 
 	// Intialisation des composantes de la scene (lumière...)
-	// Variables pour chaque buffer
-	glm::mat4 yodaTransform(glm::mat4(1.0f));
-	yodaTransform = glm::rotate(yodaTransform, glm::radians(180.0f), glm::vec3(0, 1, 0));
-	yodaTransform = glm::rotate(yodaTransform, glm::radians(-90.0f), glm::vec3(1, 0, 0));
-	yodaTransform = glm::scale(yodaTransform, glm::vec3(0.01f, 0.01f, 0.01f));
-	
-	const Material yodaMaterial{ glm::vec3(0.1f, 0.8f, 0.15f) };
+	// Entités de la scène : Yoda rebondit sur les bords, le Djinn reste fixe
+	Scene scene;
+	const auto yodaMaterial = scene.AddMaterial({ glm::vec3(0.1f, 0.8f, 0.15f), loadedTexture.uvRects[yodaTexture] });
+	const auto djinnMaterial = scene.AddMaterial({ glm::vec3(0.75f, 0.2f, 0.1f), loadedTexture.uvRects[djinnTexture] });
 
+	scene.AddEntity(yodaMesh.id, yodaMaterial, yodaTransform, BoundingRadius(yodaTris, yodaTransform), glm::vec2(0.2f, -0.4f), glm::vec2(0.6f, 1.2f));
+	scene.AddEntity(djinnMesh.id, djinnMaterial, djinnTransform, BoundingRadius(djinnTris, djinnTransform), glm::vec2(-0.5f, 0.0f));
 
-	glm::mat4 djinnTransform(glm::mat4(1.0f));
-	djinnTransform = glm::rotate(djinnTransform, glm::radians(90.0f), glm::vec3(1, 0, 0));
-	djinnTransform = glm::rotate(djinnTransform, glm::radians(-135.0f), glm::vec3(0, 1, 0));
-	djinnTransform = glm::scale(djinnTransform, glm::vec3(0.01f, 0.01f, 0.01f));
+	// Les sommets sont dans le VBO partagé
+	TriangleWithNormalList().swap(yodaTris);
+	TriangleWithNormalList().swap(djinnTris);
+
+	RenderQueue renderQueue;
+	renderQueue.Reserve(scene.Size());
+
+	// Blocs d'uniforms écrits dans un buffer mappé en permanence : un bloc de frame, un bloc par draw et celui du modèle streamé
+	UniformRing uniformRing(scene.Size() + 2, std::max(sizeof(FrameUniforms), sizeof(DrawUniforms)));
+
+	// Coût CPU de la soumission des entités et nombre de draw calls
+	double submitSeconds = 0.0;
+	size_t drawCalls = 0;
+	size_t frames = 0;
 
-	const Material djinnMaterial{ glm::vec3(0.75f, 0.2f, 0.1f) };
+	// Profilage : intervalles CPU de chaque section, mesures GPU relues trois frames plus tard, trace écrite à la fin
+	Profiler::Instance().NameTrack(Profiler::Instance().ThreadTrack(), "Main");
+	GpuProfiler gpuProfiler;
+
+	// Déplacement des modèles et animation de la lumière à 60 pas par seconde sur leur propre thread,
+	// indépendamment de la fréquence d'affichage ; le rendu interpole entre les deux derniers pas
+	Simulation simulation(scene, 1.0 / 60.0, [](double seconds)
+	{
+		return glm::vec3(100 * sin(seconds), 150 * cos(seconds), 50);
+	});
+	simulation.Start();
+
+	// Mémoire temporaire de la frame (listes de visibilité, histogrammes de tri...), gardée deux frames.
+	// En debug, passé les premières frames, la boucle ne doit plus rien allouer sur le tas depuis ce thread.
+	FrameArena frameArena(256 * 1024, 2);
+	const size_t warmupFrames = 8;
 #pragma endregion
 
 	// Boucle de rendu
 	while (!glfwWindowShouldClose(window))
 	{
+		{
+			const ProfileScope pacingScope("Frame pacing");
+			framePacer.BeginFrame();
+		}
+		// Entrées lues au début de la frame qui les affiche, pas après le swap de la précédente
+		glfwPollEvents();
+
+		frameArena.BeginFrame();
+		auto& frameMemory = frameArena.ThreadArena();
+		const auto heapAllocationsBefore = ThreadHeapAllocations();
+
+		const ProfileScope frameScope("Frame");
+		gpuProfiler.BeginFrame();
+		gpuProfiler.Begin("Frame");
+
+		glState.BeginFrame();
+
 		int width, height;
 		glfwGetFramebufferSize(window, &width, &height);
 		glViewport(0, 0, width, height);
 
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-		// Lumière
-		lightSource.position = glm::vec3(100 * sin(glfwGetTime()), 150 * cos(glfwGetTime()), 50);
-		glUniform3fv(locLightPosition, 1, glm::value_ptr(lightSource.position));
-		glUniform3fv(locLightEmitted, 1, glm::value_ptr(lightSource.radianceEmitted));
-
-		/* ------------------------------------ Yoda ------------------------------------ */ 
-		// Vertex Shader
-		glUniform3f(locTranslate, x, y, 0.0f);
-		glUniformMatrix4fv(locTransform, 1, GL_FALSE, glm::value_ptr(yodaTransform));
+		// Lumière et entités à l'instant de la frame
+		uniformRing.BeginFrame();
 
-		// Fragment Shader
-		glUniform3fv(locAlbedo, 1, glm::value_ptr(yodaMaterial.albedo));
-		glDrawArrays(GL_TRIANGLES, 0, nTrianglesYoda * 3);
-
-
-		/* ------------------------------------ Djinn ------------------------------------ */
-		// Vertex Shader
-		glUniform3f(locTranslate, -0.5, 0, 0);
-		glUniformMatrix4fv(locTransform, 1, GL_FALSE, glm::value_ptr(djinnTransform));
+		{
+			const ProfileScope lightScope("Interpolate");
+			lightSource.position = simulation.Interpolate(scene);
+			const FrameUniforms frameUniforms{ glm::vec4(lightSource.position, 0.0f), glm::vec4(lightSource.radianceEmitted, 0.0f) };
+			glState.BindBufferRange(GL_UNIFORM_BUFFER, FrameDataBinding, uniformRing.Buffer(), uniformRing.Write(frameUniforms), sizeof(FrameUniforms));
+		}
 
-		// Fragment Shader
-		glUniform3fv(locAlbedo, 1, glm::value_ptr(djinnMaterial.albedo));
-		glDrawArrays(GL_TRIANGLES, nTrianglesYoda * 3, nTrianglesDjinn * 3);
+		// Entités
+		const auto submitStart = std::chrono::steady_clock::now();
+		if (renderMode == RenderMode::Instanced)
+		{
+			// Instances visibles regroupées par maillage, un draw call par maillage
+			BuildInstances(scene, instances, batches, &frameMemory);
+			glNamedBufferData(instanceVbo, instances.size() * sizeof(InstanceData), instances.data(), GL_STREAM_DRAW);
+			instanceBytes.Set(instances.size() * sizeof(InstanceData));
+
+			for (auto&& batch : batches)
+			{
+				const ProfileScope drawScope("Draw instances");
+				const GpuScope gpuDrawScope(&gpuProfiler, "Draw instances");
+				const auto range = meshes.Range({ batch.mesh });
+				glDrawArraysInstancedBaseInstance(GL_TRIANGLES, range.first, range.count, batch.instanceCount, batch.firstInstance);
+			}
+			drawCalls += batches.size();
+		}
+		else if (renderMode == RenderMode::MultiDrawIndirect)
+		{
+			// Une commande par entité visible, toutes soumises en un appel
+			if (meshRangesGeneration != meshes.Generation())
+			{
+				meshRanges.clear();
+				for (auto&& range : meshes.Ranges())
+					meshRanges.push_back({ (uint32_t) range.first, (uint32_t) range.count });
+				meshRangesGeneration = meshes.Generation();
+			}
+			BuildIndirectDraws(scene, meshRanges, indirectCommands, indirectDraws, &frameMemory);
+			glNamedBufferData(indirectBuffer, indirectCommands.size() * sizeof(DrawArraysIndirectCommand), indirectCommands.data(), GL_STREAM_DRAW);
+			glNamedBufferData(drawBuffer, indirectDraws.size() * sizeof(DrawUniforms), indirectDraws.data(), GL_STREAM_DRAW);
+			indirectBytes.Set(indirectCommands.size() * sizeof(DrawArraysIndirectCommand));
+			drawBytes.Set(indirectDraws.size() * sizeof(DrawUniforms));
+
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, drawBuffer);
+			{
+				const ProfileScope drawScope("Multi-draw");
+				const GpuScope gpuDrawScope(&gpuProfiler, "Multi-draw");
+				glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, (GLsizei) indirectCommands.size(), 0);
+			}
+			drawCalls++;
+		}
+		else
+		{
+			// Enregistre un draw par entité, trié par état (programme, matériau, maillage) puis d'avant en arrière
+			renderQueue.Clear();
+			for (size_t i = 0; i < scene.Size(); i++)
+			{
+				const auto center = scene.ClipCenter(i);
+				const auto depth = 0.5f + 0.5f * center.z / center.w;
+				renderQueue.Push(MakeSortKey(0, scene.materialIndices[i], scene.meshes[i], depth), (uint32_t) i);
+			}
+			renderQueue.Sort(&frameMemory);
+
+			// Seuls les changements d'état donnent lieu à des appels GL
+			MeshRange range{};
+			glm::vec4 albedo, uvRect;
+			drawCalls += renderQueue.Submit(
+				[&](uint32_t entity) { return DrawState{ 0, scene.materialIndices[entity], scene.meshes[entity] }; },
+				[&](uint32_t) { glState.UseProgram(program); },
+				[&](uint32_t material)
+				{
+					// Pas de rebind : le matériau ne change que la zone lue dans l'atlas
+					albedo = glm::vec4(scene.materials[material].albedo, 0.0f);
+					uvRect = scene.materials[material].uvRect;
+				},
+				[&](uint32_t mesh) { range = meshes.Range({ mesh }); },
+				[&](const RenderCommand& command)
+				{
+					const ProfileScope drawScope("Draw model");
+					const GpuScope gpuDrawScope(&gpuProfiler, "Draw model");
+					const auto i = command.entity;
+					const DrawUniforms drawUniforms{ scene.transforms[i], glm::vec4(scene.translateX[i], scene.translateY[i], 0.0f, 0.0f), albedo, uvRect };
+					glState.BindBufferRange(GL_UNIFORM_BUFFER, DrawDataBinding, uniformRing.Buffer(), uniformRing.Write(drawUniforms), sizeof(DrawUniforms));
+					glDrawArrays(GL_TRIANGLES, range.first, range.count);
+				}).draws;
+		}
+		submitSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - submitStart).count();
+		frames++;
 
-		// Déplacement du modèle
-		x += (float)direction.x * SPEED.x;
-		if (x < -LIMIT.x || LIMIT.x < x)
+		if (chunkStreamer)
 		{
-			direction.x *= -1;
+			const ProfileScope streamScope("Stream chunks");
+			const GpuScope gpuStreamScope(&gpuProfiler, "Stream chunks");
+
+			// Pas de caméra : la vue est le point du plan proche sous le curseur, ramené dans l'espace du maillage
+			// (position * transform + translate dans shader.vert)
+			double cursorX, cursorY;
+			glfwGetCursorPos(window, &cursorX, &cursorY);
+			int windowWidth, windowHeight;
+			glfwGetWindowSize(window, &windowWidth, &windowHeight);
+			const glm::vec3 clip(2.0f * (float) cursorX / (float) std::max(windowWidth, 1) - 1.0f,
+				1.0f - 2.0f * (float) cursorY / (float) std::max(windowHeight, 1), -1.0f);
+			const auto view = (clip - glm::vec3(outOfCoreTranslate, 0.0f)) * glm::inverse(glm::mat3(outOfCoreTransform));
+			chunkStreamer->Update(view);
+
+			for (const auto& upload : chunkStreamer->Uploads())
+				chunkBuffers->Upload(upload.slot, upload.triangles, upload.triangleCount);
+
+			chunkFirsts.clear();
+			chunkCounts.clear();
+			for (const auto& draw : chunkStreamer->Draws())
+			{
+				chunkFirsts.push_back(chunkBuffers->First(draw.slot));
+				chunkCounts.push_back((GLsizei) draw.triangleCount * 3);
+			}
+
+			if (!chunkFirsts.empty())
+			{
+				glState.UseProgram(program);
+				glState.BindVertexArray(chunkVao);
+				const DrawUniforms drawUniforms{ outOfCoreTransform, glm::vec4(outOfCoreTranslate, 0.0f, 0.0f),
+					glm::vec4(scene.materials[djinnMaterial].albedo, 0.0f), scene.materials[djinnMaterial].uvRect };
+				glState.BindBufferRange(GL_UNIFORM_BUFFER, DrawDataBinding, uniformRing.Buffer(), uniformRing.Write(drawUniforms), sizeof(DrawUniforms));
+				glMultiDrawArrays(GL_TRIANGLES, chunkFirsts.data(), chunkCounts.data(), (GLsizei) chunkFirsts.size());
+				drawCalls++;
+
+				glState.BindVertexArray(renderMode == RenderMode::Instanced ? instanceVao
+					: renderMode == RenderMode::MultiDrawIndirect ? multiDrawVao
+					: vao);
+				glState.UseProgram(activeProgram);
+			}
 		}
 
-		y += (float)direction.y * SPEED.y;
-		if (y < -LIMIT.y || LIMIT.y < y)
+		uniformRing.EndFrame();
+
+		gpuProfiler.End();
+		gpuProfiler.EndFrame();
 		{
-			direction.y *= -1;
+			const ProfileScope swapScope("glfwSwapBuffers");
+			framePacer.Present([&]()
+			{
+				glfwSwapBuffers(window);
+				// Un driver qui met les frames en file rend la main avant l'affichage : JustInTime compte
+				// son échéance depuis le retour du swap, il faut donc attendre que la frame soit vraiment partie
+				if (presentMode == PresentMode::JustInTime)
+					glFinish();
+			});
 		}
 
-		glfwSwapBuffers(window);
-		glfwPollEvents();
+		// Tâches GL postées par les threads du pool
+		jobs.RunMainThreadJobs();
+
+		// Les anneaux des threads sont vidés à chaque frame pour ne jamais déborder
+		Profiler::Instance().Collect();
+
+		// Toute l'itération compte, collecte du profiler comprise
+		assert((frames <= warmupFrames || ThreadHeapAllocations() == heapAllocationsBefore) && "heap allocation in the frame loop");
 	}
 
+	simulation.Stop();
+	const auto simulationStats = simulation.Stats();
+	Log(LogLevel::Info) << "Simulation : " << simulationStats.steps << " steps, " << simulationStats.skippedSteps << " skipped, state age at render "
+		<< simulationStats.meanSnapshotAgeMs << " ms mean, " << simulationStats.maxSnapshotAgeMs << " ms max";
+
+	const auto pacing = framePacer.Stats();
+	Log(LogLevel::Info) << "Frames (" << ToString(presentMode) << ") : " << pacing.frames << " frames, " << pacing.meanMs << " ms mean, "
+		<< pacing.p99Ms << " ms p99, " << pacing.maxMs << " ms max, 1% low " << pacing.low1Fps << " fps, 0.1% low " << pacing.low01Fps << " fps, "
+		<< pacing.missedDeadlines << " missed deadlines";
+	for (const auto& line : framePacer.Histogram().Lines())
+		Log(LogLevel::Info) << "  " << line;
+
+	const auto arenaStats = frameArena.Stats();
+	Log(LogLevel::Info) << "Frame arena : " << arenaStats.frameBytes << " bytes last frame, " << arenaStats.peakFrameBytes << " bytes peak, "
+		<< arenaStats.capacity << " bytes reserved in " << arenaStats.blockAllocations << " blocks over " << arenaStats.threadArenas << " thread arenas";
+
+	Log(LogLevel::Info) << "GL calls (last frame) : " << glState.FrameStats().issued << " issued, " << glState.FrameStats().skipped << " skipped";
+	Log(LogLevel::Info) << "GL calls (total) : " << glState.TotalStats().issued << " issued, " << glState.TotalStats().skipped << " skipped";
+
+	if (frames > 0)
+	{
+		Log(LogLevel::Info) << "Submit : " << submitSeconds * 1000.0 / frames << " ms CPU, " << (double) drawCalls / frames << " draw calls per frame";
+	}
+
+	const auto& ringStats = uniformRing.Stats();
+	Log(LogLevel::Info) << "Uniform ring : " << ringStats.peakFrameBytes << " bytes peak per frame, " << ringStats.stalls << " stalls over " << ringStats.frames << " frames";
+
+	if (chunkStreamer)
+	{
+		const auto streaming = chunkStreamer->Stats();
+		Log(LogLevel::Info) << "Chunk streaming : " << streaming.HitRate() * 100.0 << " % cache hits over " << streaming.requests << " requests, "
+			<< streaming.bytesRead / (1024.0 * 1024.0) << " MB read at " << streaming.ReadMBps() << " MB/s (" << streaming.StreamMBps() << " MB/s average), "
+			<< streaming.uploads << " uploads, " << streaming.cpuEvictions << " CPU and " << streaming.gpuEvictions << " GPU evictions";
+	}
+
+	Log(LogLevel::Info) << "Asset memory :";
+	for (const auto& line : MemoryTracker::Instance().Report())
+		Log(LogLevel::Info) << "  " << line;
+
+	Log(LogLevel::Info) << "GPU frame : " << gpuProfiler.LastFrameMs() << " ms (last resolved), " << gpuProfiler.DroppedFrames() << " frames not ready";
+	const auto traceWritten = Profiler::Instance().ExportChromeTrace("trace.json");
+	const auto profileStats = Profiler::Instance().Stats();
+	Log(traceWritten ? LogLevel::Info : LogLevel::Warning) << "Profiler : " << profileStats.recorded << " events, " << profileStats.dropped << " dropped, "
+		<< profileStats.overwritten << " overwritten"
+		<< (traceWritten ? ", trace written to trace.json" : ", trace.json not written");
+
+	const auto logStats = Logger::Instance().Stats();
+	Log(LogLevel::Info) << "Log : " << logStats.written << " written, " << logStats.dropped << " dropped";
+	Logger::Instance().Shutdown();
+
 	glfwDestroyWindow(window);
 	glfwTerminate();
 	exit(EXIT_SUCCESS);
@@ -0,0 +1,25 @@
+#include <cstdlib>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkSupport.h"
+
+// Benchmarks CPU du cœur, sans fenêtre ni GPU. Les options de Google Benchmark s'appliquent, par exemple
+//   si_benchmarks --benchmark_out=results.json --benchmark_out_format=json
+// pour un résultat lisible par machine. Les modèles livrés sont lus dans SI_MODELS_DIR (resources/models par défaut).
+int main(int argc, char** argv)
+{
+	const auto models = std::getenv("SI_MODELS_DIR");
+	RegisterBundledMeshBenchmarks(models ? models : "resources/models");
+
+	benchmark::AddCustomContext("peak_rss_MB_at_start", std::to_string(PeakRssMb()));
+
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv))
+		return EXIT_FAILURE;
+
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,303 @@
+#include "BenchmarkSupport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <random>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <malloc.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+	std::atomic<uint64_t> allocationCount{ 0 };
+	std::atomic<uint64_t> allocatedBytes{ 0 };
+
+	void* CountedAllocation(size_t size)
+	{
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+		allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+		if (const auto p = std::malloc(size ? size : 1))
+			return p;
+		throw std::bad_alloc();
+	}
+
+	void* CountedAlignedAllocation(size_t size, std::align_val_t alignment)
+	{
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+		allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+		const auto align = std::max((size_t) alignment, sizeof(void*));
+#if defined(_WIN32)
+		if (const auto p = _aligned_malloc(size ? size : 1, align))
+			return p;
+#else
+		// aligned_alloc veut une taille multiple de l'alignement
+		if (const auto p = std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align))
+			return p;
+#endif
+		throw std::bad_alloc();
+	}
+
+	void AlignedFree(void* p)
+	{
+#if defined(_WIN32)
+		_aligned_free(p);
+#else
+		std::free(p);
+#endif
+	}
+}
+
+// Remplacement global : toutes les allocations du binaire de benchmark passent par le compteur,
+// versions alignées (C++17) comprises
+void* operator new(size_t size)
+{
+	return CountedAllocation(size);
+}
+
+void* operator new[](size_t size)
+{
+	return CountedAllocation(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return CountedAllocation(size);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	std::free(p);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	return CountedAlignedAllocation(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return CountedAlignedAllocation(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return CountedAlignedAllocation(size, alignment);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, alignment, tag);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+	AlignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+	AlignedFree(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+	AlignedFree(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept
+{
+	AlignedFree(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	AlignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	AlignedFree(p);
+}
+
+uint64_t AllocationCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocatedBytes()
+{
+	return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+double PeakRssMb()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+	return 0.0;
+#else
+	rusage usage{};
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0.0;
+#if defined(__APPLE__)
+	return usage.ru_maxrss / (1024.0 * 1024.0); // octets
+#else
+	return usage.ru_maxrss / 1024.0; // Ko
+#endif
+#endif
+}
+
+MemoryCounters::MemoryCounters()
+	: allocations(AllocationCount()), bytes(AllocatedBytes())
+{
+}
+
+void MemoryCounters::Report(benchmark::State& state) const
+{
+	state.counters["allocs"] = benchmark::Counter((double) (AllocationCount() - allocations), benchmark::Counter::kAvgIterations);
+	state.counters["alloc_bytes"] = benchmark::Counter((double) (AllocatedBytes() - bytes), benchmark::Counter::kAvgIterations, benchmark::Counter::kIs1024);
+	state.counters["peak_rss_MB"] = PeakRssMb();
+}
+
+TriangleList MakeSyntheticMesh(size_t triangleCount, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+	std::uniform_real_distribution<float> height(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> offset(-0.01f, 0.01f);
+
+	const auto onSphere = [&]()
+	{
+		const auto z = height(rng);
+		const auto a = angle(rng);
+		const auto r = std::sqrt(1.0f - z * z);
+		return glm::vec3(r * std::cos(a), r * std::sin(a), z) * 50.0f;
+	};
+
+	// Petits triangles posés sur la sphère, comme les facettes d'un scan
+	TriangleList triangles(triangleCount);
+	for (auto& t : triangles)
+	{
+		t.p0 = onSphere();
+		t.p1 = t.p0 + glm::vec3(offset(rng), offset(rng), offset(rng)) * 50.0f;
+		t.p2 = t.p0 + glm::vec3(offset(rng), offset(rng), offset(rng)) * 50.0f;
+	}
+	return triangles;
+}
+
+void WriteStl(const std::string& path, const TriangleList& triangles)
+{
+	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Cannot write file: " + path);
+	}
+
+	const char header[80] = {};
+	file.write(header, sizeof(header));
+	const auto count = (uint32_t) triangles.size();
+	file.write((const char*) &count, sizeof(count));
+
+	const float normal[3] = {};
+	const uint16_t attribute = 0;
+	for (const auto& t : triangles)
+	{
+		file.write((const char*) normal, sizeof(normal));
+		file.write((const char*) &t.p0, sizeof(glm::vec3));
+		file.write((const char*) &t.p1, sizeof(glm::vec3));
+		file.write((const char*) &t.p2, sizeof(glm::vec3));
+		file.write((const char*) &attribute, sizeof(attribute));
+	}
+}
+
+TemporaryFile::TemporaryFile(const std::string& name)
+	: path((std::filesystem::temp_directory_path() / name).string())
+{
+}
+
+TemporaryFile::~TemporaryFile()
+{
+	std::error_code error;
+	std::filesystem::remove(path, error);
+}
+
+TextureImage MakeSyntheticImage(int width, int height, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> noise(-12, 12);
+
+	TextureImage image;
+	image.width = width;
+	image.height = height;
+	image.channels = 3;
+	image.pixels.resize((size_t) width * height * 3);
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			const auto p = &image.pixels[((size_t) y * width + x) * 3];
+			const auto checker = ((x / 32) ^ (y / 32)) & 1;
+			const int base[3] = { x * 255 / width, y * 255 / height, checker ? 200 : 60 };
+			for (int c = 0; c < 3; c++)
+				p[c] = (uint8_t) std::min(255, std::max(0, base[c] + noise(rng)));
+		}
+	}
+	return image;
+}
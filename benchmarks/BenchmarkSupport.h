@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../source/MipChain.h"
+#include "../source/Triangle.h"
+
+// Allocations faites par operator new depuis le lancement, comptées par BenchmarkSupport.cpp
+uint64_t AllocationCount();
+uint64_t AllocatedBytes();
+
+// Pic de mémoire résidente du processus, en Mo (0 si la plateforme ne le donne pas)
+double PeakRssMb();
+
+// Relevé des allocations pris avant la boucle de mesure ; Report ajoute les compteurs par itération et le pic RSS
+class MemoryCounters
+{
+public:
+	MemoryCounters();
+	void Report(benchmark::State& state) const;
+
+private:
+	uint64_t allocations;
+	uint64_t bytes;
+};
+
+// Maillage de triangles générés sur une sphère bruitée, déterministe pour une graine donnée
+TriangleList MakeSyntheticMesh(size_t triangleCount, uint32_t seed = 1);
+
+// Écrit un STL binaire (en-tête de 80 octets, normales nulles) lisible par ReadStl
+void WriteStl(const std::string& path, const TriangleList& triangles);
+
+// Fichier temporaire supprimé à la destruction
+class TemporaryFile
+{
+public:
+	explicit TemporaryFile(const std::string& name);
+	~TemporaryFile();
+
+	TemporaryFile(const TemporaryFile&) = delete;
+	TemporaryFile& operator=(const TemporaryFile&) = delete;
+
+	const std::string& Path() const { return path; }
+
+private:
+	std::string path;
+};
+
+// Image RGB procédurale : dégradés, motifs et bruit, pour mesurer les mips et BC1 sans décodeur d'image
+TextureImage MakeSyntheticImage(int width, int height, uint32_t seed = 1);
+
+// Enregistre un BM_ReadStl par fichier .stl du dossier (modèles livrés avec le dépôt)
+void RegisterBundledMeshBenchmarks(const std::string& directory);
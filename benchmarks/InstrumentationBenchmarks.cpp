@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "../source/Log.h"
+#include "../source/Profiler.h"
+
+#include "BenchmarkSupport.h"
+
+namespace
+{
+	// Le journal écrit dans un fichier temporaire pendant la mesure, pour ne pas mêler ses lignes à la sortie du benchmark
+	std::FILE* logFile = nullptr;
+	std::FILE* previousOutput = nullptr;
+
+	void StartLogToFile(const benchmark::State&)
+	{
+		static const TemporaryFile file("si_benchmark_log.txt");
+		logFile = std::fopen(file.Path().c_str(), "wb");
+		previousOutput = Logger::Instance().Output();
+		if (logFile)
+			Logger::Instance().SetOutput(logFile);
+	}
+
+	void StopLogToFile(const benchmark::State&)
+	{
+		Logger::Instance().Flush();
+		Logger::Instance().SetOutput(previousOutput);
+		if (logFile)
+			std::fclose(logFile);
+		logFile = nullptr;
+	}
+
+	// Taille du logo livré, pour une ligne semblable à celles de SI_OpenGl.cpp
+	const int TriangleCount = 26625;
+
+	// Lignes écrites par lots d'au plus la moitié de l'anneau, tous threads confondus, avec un Flush entre deux lots :
+	// l'anneau ne se remplit jamais et aucune ligne n'est perdue, les mesures portent sur des lignes réellement écrites
+	void LogInBatches(benchmark::State& state, bool timeFlush)
+	{
+		const auto before = Logger::Instance().Stats();
+		const auto batch = std::max<size_t>(1, Logger::Instance().Capacity() / (2 * (size_t) state.threads()));
+		size_t n = 0;
+		for (auto _ : state)
+		{
+			Log(LogLevel::Info) << "Yoda Size : " << TriangleCount << " triangles, " << 12.5 << " ms";
+			if (++n % batch == 0)
+			{
+				if (!timeFlush)
+					state.PauseTiming();
+				Logger::Instance().Flush();
+				if (!timeFlush)
+					state.ResumeTiming();
+			}
+		}
+
+		if (state.thread_index() == 0)
+			state.counters["dropped"] = (double) (Logger::Instance().Stats().dropped - before.dropped);
+		state.SetItemsProcessed(state.iterations());
+	}
+}
+
+// Coût pour l'appelant d'une ligne du journal asynchrone : les Flush entre les lots ne sont pas chronométrés.
+// "dropped" doit rester à 0 ; sinon la mesure compterait des lignes perdues au lieu d'écrites.
+static void BM_LogAsync(benchmark::State& state)
+{
+	LogInBatches(state, false);
+}
+BENCHMARK(BM_LogAsync)->Setup(StartLogToFile)->Teardown(StopLogToFile)->Threads(1)->Threads(4)->UseRealTime();
+
+// Débit soutenu, écriture dans le fichier comprise : à comparer à BM_OstreamEndl
+static void BM_LogAsyncSustained(benchmark::State& state)
+{
+	LogInBatches(state, true);
+}
+BENCHMARK(BM_LogAsyncSustained)->Setup(StartLogToFile)->Teardown(StopLogToFile)->Threads(1)->Threads(4)->UseRealTime();
+
+// Ligne sous le niveau courant : aucun formatage
+static void BM_LogFiltered(benchmark::State& state)
+{
+	for (auto _ : state)
+		Log(LogLevel::Debug) << "Yoda Size : " << TriangleCount << " triangles, " << 12.5 << " ms";
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_LogFiltered);
+
+// Référence : ce que coûtaient les std::cout << ... << std::endl remplacés par le journal (flush à chaque ligne)
+static void BM_OstreamEndl(benchmark::State& state)
+{
+	const TemporaryFile file("si_benchmark_ostream.txt");
+	std::ofstream stream(file.Path());
+	for (auto _ : state)
+		stream << "Yoda Size : " << TriangleCount << " triangles, " << 12.5 << " ms" << std::endl;
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OstreamEndl);
+
+static void BM_ProfileScope(benchmark::State& state)
+{
+	Profiler::SetEnabled(state.range(0) != 0);
+	size_t n = 0;
+	for (auto _ : state)
+	{
+		const ProfileScope scope("Scope");
+		// Les anneaux sont vidés comme le fait la boucle de rendu, sans garder l'historique
+		if (++n % 8192 == 0)
+			Profiler::Instance().Clear();
+	}
+	Profiler::Instance().Clear();
+	Profiler::SetEnabled(true);
+	state.SetLabel(state.range(0) ? "enabled" : "disabled");
+	state.counters["dropped"] = (double) Profiler::Instance().Stats().dropped;
+}
+BENCHMARK(BM_ProfileScope)->Arg(1)->Arg(0);
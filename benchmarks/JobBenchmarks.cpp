@@ -0,0 +1,93 @@
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../source/JobSystem.h"
+
+namespace
+{
+	// Travail de calcul pur, sans accès mémoire partagé : seul l'ordonnancement limite le passage à l'échelle
+	float Kernel(size_t begin, size_t end)
+	{
+		float sum = 0.0f;
+		for (auto i = begin; i < end; i++)
+			sum += std::sqrt((float) i) * std::sin((float) i);
+		return sum;
+	}
+
+	const size_t KernelCount = 1 << 20;
+}
+
+// Coût d'une tâche isolée : Submit, exécution par un autre thread (ou par Wait) et réveil de l'appelant
+static void BM_JobSubmitWait(benchmark::State& state)
+{
+	JobSystem pool((size_t) state.range(0));
+	for (auto _ : state)
+		pool.Wait(pool.Submit([]() {}));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_JobSubmitWait)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+// Coût par tâche (inverse de items_per_second) d'un lot de tâches vides rejointes par une tâche qui dépend de toutes
+static void BM_JobFanIn(benchmark::State& state)
+{
+	JobSystem pool((size_t) state.range(0));
+	const auto taskCount = (size_t) state.range(1);
+
+	std::vector<JobSystem::Handle> tasks(taskCount);
+	for (auto _ : state)
+	{
+		for (auto& task : tasks)
+			task = pool.Submit([]() {});
+		pool.Wait(pool.Submit([]() {}, tasks));
+	}
+	state.counters["stolen"] = (double) pool.Stats().stolen;
+	state.SetItemsProcessed(state.iterations() * (int64_t) (taskCount + 1));
+}
+BENCHMARK(BM_JobFanIn)->ArgsProduct({ { 1, 2, 4 }, { 1024 } })->UseRealTime();
+
+// Chaîne de tâches dépendant chacune de la précédente : latence de la libération des continuations
+static void BM_JobChain(benchmark::State& state)
+{
+	JobSystem pool((size_t) state.range(0));
+	const auto length = (size_t) state.range(1);
+
+	for (auto _ : state)
+	{
+		JobSystem::Handle previous;
+		for (size_t i = 0; i < length; i++)
+			previous = pool.Submit([]() {}, { previous });
+		pool.Wait(previous);
+	}
+	state.SetItemsProcessed(state.iterations() * (int64_t) length);
+}
+BENCHMARK(BM_JobChain)->ArgsProduct({ { 1, 2, 4 }, { 256 } })->UseRealTime();
+
+// Passage à l'échelle de ParallelFor : efficacité = temps séquentiel / (temps parallèle * threads).
+// Au-delà du nombre de cœurs de la machine (hardware_threads), l'efficacité baisse forcément.
+static void BM_ParallelForScaling(benchmark::State& state)
+{
+	const auto threads = (size_t) state.range(0);
+	JobSystem pool(threads);
+
+	const auto serialStart = std::chrono::steady_clock::now();
+	for (int i = 0; i < 4; i++)
+		benchmark::DoNotOptimize(Kernel(0, KernelCount));
+	const std::chrono::duration<double> serial = (std::chrono::steady_clock::now() - serialStart) / 4;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (auto _ : state)
+	{
+		pool.ParallelFor(KernelCount, [](size_t begin, size_t end) { benchmark::DoNotOptimize(Kernel(begin, end)); }, 1024);
+	}
+	const std::chrono::duration<double> parallel = (std::chrono::steady_clock::now() - start) / (double) state.iterations();
+
+	state.counters["efficiency"] = serial.count() / (parallel.count() * (double) threads);
+	state.counters["speedup"] = serial.count() / parallel.count();
+	state.counters["hardware_threads"] = (double) std::thread::hardware_concurrency();
+	state.SetItemsProcessed(state.iterations() * (int64_t) KernelCount);
+}
+BENCHMARK(BM_ParallelForScaling)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
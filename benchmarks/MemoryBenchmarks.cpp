@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../source/AssetMemory.h"
+#include "../source/FrameArena.h"
+#include "../source/IndirectDraws.h"
+#include "../source/InstanceBuffer.h"
+#include "../source/RenderQueue.h"
+#include "../source/RingAllocator.h"
+#include "../source/UniformBlocks.h"
+
+#include "BenchmarkSupport.h"
+
+namespace
+{
+	// Entités réparties sur trois maillages et deux matériaux, une sur cinq hors du volume de clip
+	Scene MakeScene(size_t count)
+	{
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> position(-1.2f, 1.2f);
+
+		Scene scene;
+		scene.AddMaterial({ glm::vec3(1.0f) });
+		scene.AddMaterial({ glm::vec3(0.5f) });
+		scene.Reserve(count);
+		for (size_t i = 0; i < count; i++)
+			scene.AddEntity((uint32_t) (i % 3), (uint32_t) (i % 2), glm::mat4(1.0f), 0.05f, glm::vec2(position(rng), position(rng)));
+		return scene;
+	}
+}
+
+// Travail de frame de la boucle de rendu (instances, commandes indirectes, tri des draws), avec les tableaux
+// intermédiaires sur le tas (arena = 0) ou dans la mémoire de frame (arena = 1) : voir allocs par itération
+static void BM_FrameBuild(benchmark::State& state)
+{
+	const auto scene = MakeScene((size_t) state.range(0));
+	const auto useArena = state.range(1) != 0;
+	const std::vector<DrawRange> meshRanges = { { 0, 3 }, { 3, 3 }, { 6, 3 } };
+
+	FrameArena frameArena;
+	std::vector<InstanceData> instances;
+	std::vector<InstanceBatch> batches;
+	std::vector<DrawArraysIndirectCommand> commands;
+	std::vector<DrawUniforms> draws;
+	RenderQueue renderQueue;
+	renderQueue.Reserve(scene.Size());
+
+	const auto frame = [&]()
+	{
+		frameArena.BeginFrame();
+		const auto arena = useArena ? &frameArena.ThreadArena() : nullptr;
+
+		BuildInstances(scene, instances, batches, arena);
+		BuildIndirectDraws(scene, meshRanges, commands, draws, arena);
+
+		renderQueue.Clear();
+		for (size_t i = 0; i < scene.Size(); i++)
+			renderQueue.Push(MakeSortKey(0, scene.materialIndices[i], scene.meshes[i], 0.5f + 0.25f * scene.translateY[i]), (uint32_t) i);
+		renderQueue.Sort(arena);
+	};
+
+	// Une frame de chauffe par section de l'arène : tailles des buffers de sortie et des blocs atteintes
+	for (size_t i = 0; i < frameArena.FrameCount(); i++)
+		frame();
+
+	const MemoryCounters memory;
+	for (auto _ : state)
+	{
+		frame();
+		benchmark::DoNotOptimize(renderQueue.Commands().data());
+	}
+	state.SetLabel(useArena ? "arena" : "heap");
+	state.SetItemsProcessed(state.iterations() * (int64_t) scene.Size());
+	memory.Report(state);
+}
+BENCHMARK(BM_FrameBuild)->ArgsProduct({ { 1000, 100000 }, { 0, 1 } })->UseRealTime();
+
+// Renouvellement de tampons de maillage de même taille (morceaux streamés) : un vector neuf à chaque fois
+// (pool = 0) ou un bloc recyclé d'un AssetPool (pool = 1). 64 tampons vivants, le plus ancien est rendu.
+static void BM_AssetChurn(benchmark::State& state)
+{
+	const auto triangleCount = (size_t) state.range(0);
+	const auto usePool = state.range(1) != 0;
+	const auto bytes = triangleCount * sizeof(TriangleWithNormal);
+	const size_t live = 64;
+
+	AssetPool pool(MemoryCategory::CpuMesh, bytes, live);
+	std::vector<PoolHandle> handles(live);
+	std::vector<TriangleWithNormalList> lists(live);
+
+	size_t next = 0;
+	const auto churn = [&]()
+	{
+		const auto slot = next++ % live;
+		if (usePool)
+		{
+			pool.Free(handles[slot]);
+			handles[slot] = pool.Allocate();
+			const auto data = static_cast<TriangleWithNormal*>(pool.Data(handles[slot]));
+			std::fill(data, data + triangleCount, TriangleWithNormal{});
+			benchmark::DoNotOptimize(data);
+		}
+		else
+		{
+			lists[slot] = TriangleWithNormalList(triangleCount);
+			benchmark::DoNotOptimize(lists[slot].data());
+		}
+	};
+
+	for (size_t i = 0; i < live; i++)
+		churn();
+
+	const MemoryCounters memory;
+	for (auto _ : state)
+		churn();
+	state.SetLabel(usePool ? "pool" : "heap");
+	state.SetBytesProcessed(state.iterations() * (int64_t) bytes);
+	memory.Report(state);
+}
+BENCHMARK(BM_AssetChurn)->ArgsProduct({ { 256, 8192 }, { 0, 1 } })->UseRealTime();
+
+// Frame de l'anneau d'uniforms : BeginFrame, range(0) blocs DrawUniforms alignés comme les UBO (256 octets), EndFrame.
+// Les barrières sont factices et toujours franchies : seul le coût CPU de l'allocateur est mesuré.
+static void BM_RingAllocator(benchmark::State& state)
+{
+	const auto allocations = (size_t) state.range(0);
+	static int token;
+	FenceCallbacks fences;
+	fences.insert = []() { return (void*) &token; };
+	fences.wait = [](void*) { return false; };
+	fences.release = [](void*) {};
+	RingAllocator ring(allocations * 256, 3, 256, fences);
+
+	for (auto _ : state)
+	{
+		ring.BeginFrame();
+		for (size_t i = 0; i < allocations; i++)
+			benchmark::DoNotOptimize(ring.Allocate(sizeof(DrawUniforms)));
+		ring.EndFrame();
+	}
+	state.SetItemsProcessed(state.iterations() * (int64_t) allocations);
+	state.counters["overflows"] = (double) ring.Stats().overflows;
+}
+BENCHMARK(BM_RingAllocator)->Arg(1000)->Arg(100000)->UseRealTime();
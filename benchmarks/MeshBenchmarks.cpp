@@ -0,0 +1,245 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../source/MeshCleanup.h"
+#include "../source/MeshModifier.h"
+#include "../source/MeshTransform.h"
+#include "../source/stl.h"
+
+#include "BenchmarkSupport.h"
+
+namespace
+{
+	// Tailles des maillages synthétiques, de 1K à 50M triangles. 50M demande environ 6 Go (triangles et normales) :
+	// SI_BENCHMARK_MAX_TRIANGLES abaisse la borne sur une petite machine.
+	size_t MaxTriangles()
+	{
+		const auto value = std::getenv("SI_BENCHMARK_MAX_TRIANGLES");
+		return value ? (size_t) std::strtoull(value, nullptr, 10) : 50000000;
+	}
+
+	void SyntheticSizes(benchmark::internal::Benchmark* b, size_t limit)
+	{
+		for (const size_t n : { 1000, 10000, 100000, 1000000, 10000000, 50000000 })
+		{
+			if (n <= std::min(limit, MaxTriangles()))
+				b->Arg((int64_t) n);
+		}
+		b->Unit(benchmark::kMillisecond);
+	}
+
+	// Un STL de 50M triangles pèse 2,5 Go : la lecture s'arrête à 10M
+	void ReadSizes(benchmark::internal::Benchmark* b)
+	{
+		SyntheticSizes(b, 10000000);
+	}
+
+	// Cuisson des transformations : de 1K à 10M triangles
+	void BakeSizes(benchmark::internal::Benchmark* b)
+	{
+		SyntheticSizes(b, 10000000);
+	}
+
+	void KernelSizes(benchmark::internal::Benchmark* b)
+	{
+		SyntheticSizes(b, 50000000);
+	}
+
+	void SetTriangleCounters(benchmark::State& state, size_t triangles, size_t bytesPerIteration)
+	{
+		state.counters["triangles"] = (double) triangles;
+		state.counters["triangles/s"] = benchmark::Counter((double) triangles, benchmark::Counter::kIsIterationInvariantRate);
+		state.SetBytesProcessed((int64_t) (state.iterations() * bytesPerIteration));
+	}
+}
+
+static void BM_ReadStl(benchmark::State& state, const std::string& path)
+{
+	const auto expected = ReadStl(path.c_str()).size();
+	const MemoryCounters memory;
+	for (auto _ : state)
+	{
+		auto triangles = ReadStl(path.c_str());
+		benchmark::DoNotOptimize(triangles.data());
+	}
+	SetTriangleCounters(state, expected, 84 + expected * 50);
+	memory.Report(state);
+}
+
+static void BM_ReadStlSynthetic(benchmark::State& state)
+{
+	const auto n = (size_t) state.range(0);
+	const TemporaryFile file("si_benchmark_" + std::to_string(n) + ".stl");
+	WriteStl(file.Path(), MakeSyntheticMesh(n));
+
+	const MemoryCounters memory;
+	for (auto _ : state)
+	{
+		auto triangles = ReadStl(file.Path().c_str());
+		benchmark::DoNotOptimize(triangles.data());
+	}
+	SetTriangleCounters(state, n, 84 + n * 50);
+	memory.Report(state);
+}
+BENCHMARK(BM_ReadStlSynthetic)->Apply(ReadSizes);
+
+static void BM_CenterAllVertex(benchmark::State& state)
+{
+	const auto n = (size_t) state.range(0);
+	auto triangles = MakeSyntheticMesh(n);
+
+	// Recentrer un maillage déjà centré refait exactement le même travail : pas de copie entre les itérations
+	const MemoryCounters memory;
+	for (auto _ : state)
+	{
+		CenterAllVertex(triangles);
+		benchmark::ClobberMemory();
+	}
+	SetTriangleCounters(state, n, n * sizeof(Triangle) * 2);
+	memory.Report(state);
+}
+BENCHMARK(BM_CenterAllVertex)->Apply(KernelSizes);
+
+static void BM_CreateTriangleWithNormals(benchmark::State& state)
+{
+	const auto n = (size_t) state.range(0);
+	const auto triangles = MakeSyntheticMesh(n);
+
+	// Même usage que SI_OpenGl.cpp : réserve puis remplissage
+	const MemoryCounters memory;
+	for (auto _ : state)
+	{
+		TriangleWithNormalList withNormals;
+		withNormals.reserve(n);
+		CreateTriangleWithNormals(triangles, withNormals);
+		benchmark::DoNotOptimize(withNormals.data());
+	}
+	SetTriangleCounters(state, n, n * (sizeof(Triangle) + sizeof(TriangleWithNormal)));
+	memory.Report(state);
+}
+BENCHMARK(BM_CreateTriangleWithNormals)->Apply(KernelSizes);
+
+// Nettoyage d'un maillage dont un triangle sur huit est recopié avec ses sommets permutés et un sur seize aplati.
+// La copie du maillage d'entrée est hors mesure ; bytesProcessed compte la lecture des triangles et l'écriture de ceux gardés.
+static void BM_RemoveDegenerateTriangles(benchmark::State& state)
+{
+	const auto n = (size_t) state.range(0);
+	auto source = MakeSyntheticMesh(n);
+	for (size_t i = 0; i + 8 < n; i += 8)
+		source[i + 8] = { source[i].p1, source[i].p2, source[i].p0 };
+	for (size_t i = 3; i < n; i += 16)
+		source[i].p2 = source[i].p0;
+
+	TriangleList triangles;
+	size_t kept = 0;
+	const MemoryCounters memory;
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		triangles = source;
+		state.ResumeTiming();
+
+		kept = RemoveDegenerateTriangles(triangles).kept;
+		benchmark::DoNotOptimize(triangles.data());
+	}
+	SetTriangleCounters(state, n, (n + kept) * sizeof(Triangle));
+	state.counters["kept"] = (double) kept;
+	memory.Report(state);
+}
+BENCHMARK(BM_RemoveDegenerateTriangles)->Apply(ReadSizes);
+
+namespace
+{
+	// Échelle non uniforme, rotation et translation, avec la convention de shader.vert
+	glm::mat4 MakeBakeTransform()
+	{
+		glm::mat4 transform(1.0f);
+		transform[0] = glm::vec4(1.5f, -0.4f, 0.0f, 3.0f);
+		transform[1] = glm::vec4(0.4f, 0.9f, 0.0f, -2.0f);
+		transform[2] = glm::vec4(0.0f, 0.0f, 0.5f, 1.0f);
+		return transform;
+	}
+}
+
+// Coût unique au chargement : transformation des sommets et des normales sur place, en parallèle.
+// Les itérations alternent la matrice et son inverse pour garder des coordonnées bornées sans recopier le maillage.
+static void BM_BakeTransform(benchmark::State& state)
+{
+	const auto n = (size_t) state.range(0);
+	TriangleWithNormalList triangles;
+	triangles.reserve(n);
+	CreateTriangleWithNormals(MakeSyntheticMesh(n), triangles);
+
+	const auto transform = MakeBakeTransform();
+	const auto inverse = glm::inverse(transform);
+	bool forward = true;
+
+	const MemoryCounters memory;
+	for (auto _ : state)
+	{
+		BakeTransform(triangles, forward ? transform : inverse);
+		forward = !forward;
+		benchmark::ClobberMemory();
+	}
+	SetTriangleCounters(state, n, n * sizeof(TriangleWithNormal) * 2);
+	memory.Report(state);
+}
+BENCHMARK(BM_BakeTransform)->Apply(BakeSizes);
+
+// Référence de ce que la cuisson évite à chaque frame : le travail par sommet de shader.vert (position et normale
+// transformées, sans renormalisation) en glm scalaire vers un tampon de sortie. Le point d'équilibre est
+// BM_BakeTransform / BM_TransformPerFrame frames pour un même nombre de triangles.
+static void BM_TransformPerFrame(benchmark::State& state)
+{
+	const auto n = (size_t) state.range(0);
+	TriangleWithNormalList triangles;
+	triangles.reserve(n);
+	CreateTriangleWithNormals(MakeSyntheticMesh(n), triangles);
+	TriangleWithNormalList transformed(n);
+
+	const auto transform = MakeBakeTransform();
+	const auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+
+	const MemoryCounters memory;
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			const auto& t = triangles[i];
+			auto& out = transformed[i];
+			out.p0 = glm::vec3(glm::vec4(t.p0, 1.0f) * transform);
+			out.p1 = glm::vec3(glm::vec4(t.p1, 1.0f) * transform);
+			out.p2 = glm::vec3(glm::vec4(t.p2, 1.0f) * transform);
+			out.n0 = t.n0 * normalMatrix;
+			out.n1 = t.n1 * normalMatrix;
+			out.n2 = t.n2 * normalMatrix;
+		}
+		benchmark::DoNotOptimize(transformed.data());
+		benchmark::ClobberMemory();
+	}
+	SetTriangleCounters(state, n, n * sizeof(TriangleWithNormal) * 2);
+	memory.Report(state);
+}
+BENCHMARK(BM_TransformPerFrame)->Apply(BakeSizes);
+
+void RegisterBundledMeshBenchmarks(const std::string& directory)
+{
+	std::error_code error;
+	std::vector<std::filesystem::path> paths;
+	for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+	{
+		if (entry.is_regular_file() && entry.path().extension() == ".stl")
+			paths.push_back(entry.path());
+	}
+	std::sort(paths.begin(), paths.end());
+
+	for (const auto& path : paths)
+	{
+		benchmark::RegisterBenchmark(("BM_ReadStl/" + path.filename().string()).c_str(), BM_ReadStl, path.string())->Unit(benchmark::kMillisecond);
+	}
+}
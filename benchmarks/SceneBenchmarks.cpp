@@ -0,0 +1,108 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../source/RenderQueue.h"
+#include "../source/Scene.h"
+
+namespace
+{
+	// Entités mobiles réparties dans l'écran, vitesses aléatoires : une partie rebondit à chaque pas
+	Scene MakeMovingScene(size_t count)
+	{
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> position(-1.7f, 1.7f);
+		std::uniform_real_distribution<float> velocity(-3.0f, 3.0f);
+
+		Scene scene;
+		scene.AddMaterial({ glm::vec3(1.0f) });
+		scene.Reserve(count);
+		for (size_t i = 0; i < count; i++)
+			scene.AddEntity(0, 0, glm::mat4(1.0f), 0.05f, glm::vec2(position(rng), position(rng)), glm::vec2(velocity(rng), velocity(rng)));
+		return scene;
+	}
+
+	// Draws synthétiques : 4 programmes, 256 matériaux, 64 maillages et une profondeur aléatoires
+	struct SyntheticDraws
+	{
+		std::vector<DrawState> states;
+		std::vector<uint64_t> keys;
+	};
+
+	SyntheticDraws MakeSyntheticDraws(size_t count)
+	{
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+
+		SyntheticDraws draws;
+		draws.states.reserve(count);
+		draws.keys.reserve(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			const DrawState state{ (uint32_t) (rng() % 4), (uint32_t) (rng() % 256), (uint32_t) (rng() % 64) };
+			draws.states.push_back(state);
+			draws.keys.push_back(MakeSortKey(state.program, state.material, state.mesh, depth(rng)));
+		}
+		return draws;
+	}
+}
+
+// Un pas de simulation de 60 Hz de toute la scène (déplacement et rebond sur les deux axes), sans GPU
+static void BM_SceneUpdate(benchmark::State& state)
+{
+	auto scene = MakeMovingScene((size_t) state.range(0));
+	for (auto _ : state)
+	{
+		scene.Update(1.0f / 60.0f);
+		benchmark::DoNotOptimize(scene.translateX.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * (int64_t) scene.Size());
+	state.SetBytesProcessed(state.iterations() * (int64_t) scene.Size() * 6 * (int64_t) sizeof(float));
+}
+BENCHMARK(BM_SceneUpdate)->Arg(100000)->Arg(1000000)->UseRealTime();
+
+// Enregistrement et tri de la file de rendu seuls, sans construction d'instances ni de commandes indirectes
+static void BM_RenderQueueSort(benchmark::State& state)
+{
+	const auto draws = MakeSyntheticDraws((size_t) state.range(0));
+	RenderQueue queue;
+	queue.Reserve(draws.keys.size());
+
+	for (auto _ : state)
+	{
+		queue.Clear();
+		for (size_t i = 0; i < draws.keys.size(); i++)
+			queue.Push(draws.keys[i], (uint32_t) i);
+		queue.Sort();
+		benchmark::DoNotOptimize(queue.Commands().data());
+	}
+	state.SetItemsProcessed(state.iterations() * (int64_t) draws.keys.size());
+}
+BENCHMARK(BM_RenderQueueSort)->Arg(100000)->UseRealTime();
+
+// Parcours de la file triée : relecture de l'état de chaque draw et filtrage des changements d'état
+static void BM_RenderQueueSubmit(benchmark::State& state)
+{
+	const auto draws = MakeSyntheticDraws((size_t) state.range(0));
+	RenderQueue queue;
+	for (size_t i = 0; i < draws.keys.size(); i++)
+		queue.Push(draws.keys[i], (uint32_t) i);
+	queue.Sort();
+
+	uint32_t bound = 0;
+	SubmitStats stats;
+	for (auto _ : state)
+	{
+		stats = queue.Submit([&](uint32_t entity) { return draws.states[entity]; },
+			[&](uint32_t program) { bound += program; },
+			[&](uint32_t material) { bound += material; },
+			[&](uint32_t mesh) { bound += mesh; },
+			[&](const RenderCommand& command) { benchmark::DoNotOptimize(command.entity); });
+		benchmark::DoNotOptimize(bound);
+	}
+	state.SetItemsProcessed(state.iterations() * (int64_t) draws.keys.size());
+	state.counters["stateChanges"] = (double) (stats.programChanges + stats.materialChanges + stats.meshChanges);
+}
+BENCHMARK(BM_RenderQueueSubmit)->Arg(100000)->UseRealTime();
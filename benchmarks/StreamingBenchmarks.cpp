@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <cmath>
+
+#include <benchmark/benchmark.h>
+
+#include "../source/ChunkStreamer.h"
+#include "../source/ChunkedMesh.h"
+
+#include "BenchmarkSupport.h"
+
+namespace
+{
+	ChunkBuildOptions StreamingOptions()
+	{
+		ChunkBuildOptions options;
+		options.maxChunkTriangles = 2048;
+		return options;
+	}
+}
+
+// Découpage d'un STL en morceaux sur disque (trois lectures par lots), pour un maillage de range(0) triangles
+static void BM_BuildChunkFile(benchmark::State& state)
+{
+	const auto triangleCount = (size_t) state.range(0);
+	const TemporaryFile stl("bm_chunks.stl");
+	const TemporaryFile chunks("bm_chunks.chk");
+	WriteStl(stl.Path(), MakeSyntheticMesh(triangleCount));
+	const auto options = StreamingOptions();
+	const auto key = MakeChunkFileKey(stl.Path(), options);
+
+	ChunkBuildReport report;
+	for (auto _ : state)
+		report = BuildChunkFile(stl.Path(), chunks.Path(), key, options);
+	state.counters["chunks"] = report.chunks;
+	state.SetItemsProcessed(state.iterations() * (int64_t) triangleCount);
+}
+BENCHMARK(BM_BuildChunkFile)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Une frame de streaming par itération, la vue tournant autour du maillage : cache CPU de range(0) morceaux
+// pour un maillage qui en compte davantage. Taux de succès du cache et débits en compteurs.
+static void BM_ChunkStreaming(benchmark::State& state)
+{
+	const TemporaryFile stl("bm_streaming.stl");
+	const TemporaryFile chunks("bm_streaming.chk");
+	WriteStl(stl.Path(), MakeSyntheticMesh(500000));
+	const auto options = StreamingOptions();
+	const auto key = MakeChunkFileKey(stl.Path(), options);
+	BuildChunkFile(stl.Path(), chunks.Path(), key, options);
+
+	const ChunkFile file(chunks.Path(), key);
+	ChunkStreamerOptions streamerOptions;
+	streamerOptions.cpuBudgetBytes = (size_t) state.range(0) * file.MaxChunkTriangles() * sizeof(TriangleWithNormal);
+	streamerOptions.gpuSlots = 16;
+	streamerOptions.prefetchChunks = 8;
+	ChunkStreamingStats stats;
+	{
+		ChunkStreamer streamer(file, streamerOptions);
+
+		float angle = 0.0f;
+		for (auto _ : state)
+		{
+			angle += 0.01f;
+			streamer.Update(glm::vec3(2.0f * std::cos(angle), 0.0f, 2.0f * std::sin(angle)));
+			benchmark::DoNotOptimize(streamer.Draws().data());
+		}
+		stats = streamer.Stats();
+	}
+
+	state.counters["hit_rate"] = stats.HitRate();
+	state.counters["read_MBps"] = stats.ReadMBps();
+	state.counters["stream_MBps"] = stats.StreamMBps();
+	state.counters["drawn"] = (double) stats.drawn / (double) std::max<size_t>(stats.wanted, 1);
+	state.counters["chunks"] = (double) file.Chunks().size();
+}
+BENCHMARK(BM_ChunkStreaming)->Arg(32)->Arg(128)->UseRealTime();
@@ -0,0 +1,72 @@
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "../source/AtlasPacker.h"
+#include "../source/BlockCompression.h"
+#include "../source/MipChain.h"
+
+#include "BenchmarkSupport.h"
+
+static void BM_BuildMipChain(benchmark::State& state)
+{
+	const auto filter = (MipFilter) state.range(1);
+	const auto base = MakeSyntheticImage((int) state.range(0), (int) state.range(0));
+
+	const MemoryCounters memory;
+	for (auto _ : state)
+	{
+		auto levels = BuildMipChain(base, filter);
+		benchmark::DoNotOptimize(levels.data());
+	}
+	state.SetLabel(filter == MipFilter::Box ? "box" : "kaiser");
+	state.counters["pixels/s"] = benchmark::Counter((double) base.width * base.height, benchmark::Counter::kIsIterationInvariantRate);
+	memory.Report(state);
+}
+BENCHMARK(BM_BuildMipChain)->ArgsProduct({ { 512, 2048 }, { (int64_t) MipFilter::Box, (int64_t) MipFilter::Kaiser } })->Unit(benchmark::kMillisecond);
+
+// Débit et qualité de l'encodeur BC1, sans GPU : le PSNR est mesuré en décodant les blocs produits
+static void BM_EncodeBc1(benchmark::State& state)
+{
+	const auto quality = (Bc1Quality) state.range(1);
+	const auto image = MakeSyntheticImage((int) state.range(0), (int) state.range(0));
+
+	TextureBytes blocks;
+	for (auto _ : state)
+	{
+		blocks = EncodeBc1(image, quality);
+		benchmark::DoNotOptimize(blocks.data());
+	}
+	const char* names[] = { "fast", "normal", "high" };
+	state.SetLabel(names[(int) quality]);
+	state.counters["pixels/s"] = benchmark::Counter((double) image.width * image.height, benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["psnr_dB"] = Psnr(image, DecodeBc1(blocks.data(), image.width, image.height));
+}
+BENCHMARK(BM_EncodeBc1)->ArgsProduct({ { 1024 }, { (int64_t) Bc1Quality::Fast, (int64_t) Bc1Quality::Normal, (int64_t) Bc1Quality::High } })->Unit(benchmark::kMillisecond);
+
+// Temps d'empaquetage et occupation de l'atlas pour des images de tailles variées (8 à 128 texels de côté)
+static void BM_BuildAtlas(benchmark::State& state)
+{
+	std::mt19937 rng(1);
+	std::vector<TextureImage> images((size_t) state.range(0));
+	for (auto& image : images)
+	{
+		image.width = 8 + (int) (rng() % 121);
+		image.height = 8 + (int) (rng() % 121);
+		image.channels = 3;
+		image.pixels.assign((size_t) image.width * image.height * 3, 128);
+	}
+
+	TextureAtlas atlas;
+	for (auto _ : state)
+	{
+		atlas = BuildAtlas(images);
+		benchmark::DoNotOptimize(atlas.image.pixels.data());
+	}
+	state.counters["images/s"] = benchmark::Counter((double) images.size(), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["occupancy"] = atlas.occupancy;
+	state.counters["atlas_width"] = atlas.image.width;
+	state.counters["atlas_height"] = atlas.image.height;
+}
+BENCHMARK(BM_BuildAtlas)->Arg(16)->Arg(128)->Arg(1024)->Unit(benchmark::kMillisecond);
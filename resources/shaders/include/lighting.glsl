@@ -0,0 +1,11 @@
+#pragma once
+
+// Radiance d'une source ponctuelle, calculée dans l'espace du modèle
+vec3 PointLightRadiance(vec3 lightPosition, vec3 lightEmitted, vec3 position, vec3 normal)
+{
+    vec3 directionToLight = lightPosition - position;
+    float distance = dot(directionToLight, directionToLight);
+    vec3 omegaI = normalize(directionToLight);
+
+    return lightEmitted / distance * dot(normal, omegaI);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// Sorties communes des vertex shaders, lues par shader.frag
+out vec3 originalPosition;
+out vec3 originalNormal;
+out vec3 vertexAlbedo;
+flat out vec4 vertexUvRect;
+
+// Convention du projet : vecteur ligne multiplié par la matrice, puis translation
+vec4 ToClip(vec3 position, mat4 transform, vec3 translate)
+{
+    return vec4(position, 1.0) * transform + vec4(translate, 1.0);
+}
@@ -0,0 +1,21 @@
+#version 450
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+
+// Attributs par instance (glVertexAttribDivisor = 1), voir InstanceData
+layout(location = 2) in mat4 instanceTransform;
+layout(location = 6) in vec4 instanceTranslate;
+layout(location = 7) in vec4 instanceAlbedo;
+layout(location = 8) in vec4 instanceUvRect;
+
+#include "include/transform.glsl"
+
+void main()
+{
+    originalPosition = position;
+    originalNormal = normal;
+    vertexAlbedo = instanceAlbedo.rgb;
+    vertexUvRect = instanceUvRect;
+    gl_Position = ToClip(position, instanceTransform, instanceTranslate.xyz);
+}
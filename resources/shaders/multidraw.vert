@@ -0,0 +1,32 @@
+#version 450
+#extension GL_ARB_shader_draw_parameters : require
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 normal;
+
+#include "include/transform.glsl"
+
+// Données de chaque draw de glMultiDrawArraysIndirect, voir DrawUniforms
+struct DrawData
+{
+    mat4 transform;
+    vec4 translate;
+    vec4 albedo;
+    vec4 uvRect;
+};
+
+layout(std430, binding = 2) readonly buffer DrawBuffer
+{
+    DrawData draws[];
+};
+
+void main()
+{
+    DrawData draw = draws[gl_DrawIDARB];
+
+    originalPosition = position;
+    originalNormal = normal;
+    vertexAlbedo = draw.albedo.rgb;
+    vertexUvRect = draw.uvRect;
+    gl_Position = ToClip(position, draw.transform, draw.translate.xyz);
+}
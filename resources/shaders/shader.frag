@@ -1,26 +1,45 @@
 #version 450
 
+// Permutation injectée par ShaderPreprocessor ; 0 retire l'échantillonnage de la texture
+#ifndef TEXTURED
+#define TEXTURED 1
+#endif
+
+#include "include/lighting.glsl"
+
 in vec3 originalPosition;
 in vec3 originalNormal;
+in vec3 vertexAlbedo;
+flat in vec4 vertexUvRect;
 
 out vec4 color;
 
-uniform vec3 lightPosition;
-uniform vec3 lightEmitted;
-uniform vec3 albedo;
+// Données communes à la frame, voir FrameUniforms
+layout(std140, binding = 0) uniform FrameData
+{
+    vec3 lightPosition;
+    vec3 lightEmitted;
+};
+
+#if TEXTURED
 uniform sampler2D tex;
+#endif
 
 void main()
 {
     // Apply lightning
-    vec3 directionToLight = lightPosition - originalPosition;
-    float distance = dot(directionToLight, directionToLight);
-    vec3 omegaI = normalize(directionToLight);
-
-    vec4 radiance = vec4(lightEmitted / distance * dot(originalNormal, omegaI) * albedo, 1.0);   
-    vec4 texture = texture(tex, fract(gl_FragCoord.xy / vec2(500, 500)));
+    vec4 radiance = vec4(PointLightRadiance(lightPosition, lightEmitted, originalPosition, originalNormal) * vertexAlbedo, 1.0);
 
+#if TEXTURED
+    // Répétition de l'image du matériau dans sa zone de l'atlas. Les dérivées viennent des coordonnées avant fract :
+    // sans cela le saut de fract ferait choisir le plus petit mip, et donc les voisines, sur la couture.
+    vec2 tiled = gl_FragCoord.xy / vec2(500, 500);
+    vec2 uv = vertexUvRect.xy + fract(tiled) * vertexUvRect.zw;
+    vec4 texture = textureGrad(tex, uv, dFdx(tiled) * vertexUvRect.zw, dFdy(tiled) * vertexUvRect.zw);
     color = texture * radiance;
+#else
+    color = radiance;
+#endif
 
     //// Display pixel normal
     //color = vec4(abs(originalNormal), 1.0);
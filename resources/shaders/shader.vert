@@ -3,15 +3,22 @@
 in vec3 position;
 in vec3 normal;
 
-out vec3 originalPosition;
-out vec3 originalNormal;
+#include "include/transform.glsl"
 
-uniform vec3 translate;
-uniform mat4 transform;
+// Données du draw call, voir DrawUniforms
+layout(std140, binding = 1) uniform DrawData
+{
+    mat4 transform;
+    vec3 translate;
+    vec3 albedo;
+    vec4 uvRect;
+};
 
 void main()
 {
     originalPosition = position;
     originalNormal = normal;
-    gl_Position = vec4(position, 1.0) * transform + vec4(translate, 1.0);
+    vertexAlbedo = albedo;
+    vertexUvRect = uvRect;
+    gl_Position = ToClip(position, transform, translate);
 }
@@ -0,0 +1,177 @@
+#include "AllocationCounter.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+#ifndef NDEBUG
+
+namespace
+{
+	thread_local uint64_t threadAllocations = 0;
+
+	void* CountedAllocation(size_t size)
+	{
+		threadAllocations++;
+		if (const auto p = std::malloc(size ? size : 1))
+			return p;
+		throw std::bad_alloc();
+	}
+
+	void* CountedAlignedAllocation(size_t size, std::align_val_t alignment)
+	{
+		threadAllocations++;
+		const auto align = std::max((size_t) alignment, sizeof(void*));
+#if defined(_WIN32)
+		if (const auto p = _aligned_malloc(size ? size : 1, align))
+			return p;
+#else
+		// aligned_alloc veut une taille multiple de l'alignement
+		if (const auto p = std::aligned_alloc(align, (std::max<size_t>(size, 1) + align - 1) / align * align))
+			return p;
+#endif
+		throw std::bad_alloc();
+	}
+
+	void AlignedFree(void* p)
+	{
+#if defined(_WIN32)
+		_aligned_free(p);
+#else
+		std::free(p);
+#endif
+	}
+}
+
+// Remplacement global pour le viewer en debug, versions alignées (C++17) comprises : les assets passent par elles
+void* operator new(size_t size)
+{
+	return CountedAllocation(size);
+}
+
+void* operator new[](size_t size)
+{
+	return CountedAllocation(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return CountedAllocation(size);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, tag);
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	std::free(p);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	return CountedAlignedAllocation(size, alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	return CountedAlignedAllocation(size, alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return CountedAlignedAllocation(size, alignment);
+	}
+	catch (const std::bad_alloc&)
+	{
+		return nullptr;
+	}
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t& tag) noexcept
+{
+	return operator new(size, alignment, tag);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept
+{
+	AlignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept
+{
+	AlignedFree(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept
+{
+	AlignedFree(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept
+{
+	AlignedFree(p);
+}
+
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	AlignedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	AlignedFree(p);
+}
+
+uint64_t ThreadHeapAllocations()
+{
+	return threadAllocations;
+}
+
+#else
+
+uint64_t ThreadHeapAllocations()
+{
+	return 0;
+}
+
+#endif
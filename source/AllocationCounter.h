@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdint>
+
+// Nombre d'appels à operator new faits par le thread courant depuis son démarrage. Le compteur n'existe que dans
+// le viewer compilé sans NDEBUG, qui remplace operator new (AllocationCounter.cpp) ; sinon la fonction renvoie 0.
+// Sert à vérifier par assert qu'une boucle n'alloue plus sur le tas une fois en régime établi.
+uint64_t ThreadHeapAllocations();
@@ -0,0 +1,283 @@
+#include "AssetMemory.h"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+	std::string Megabytes(size_t bytes)
+	{
+		std::ostringstream text;
+		text.setf(std::ios::fixed);
+		text.precision(2);
+		text << (double) bytes / (1024.0 * 1024.0) << " MB";
+		return text.str();
+	}
+
+	size_t RoundUp(size_t value, size_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	bool IsPowerOfTwo(size_t value)
+	{
+		return value != 0 && (value & (value - 1)) == 0;
+	}
+}
+
+const char* ToString(MemoryCategory category)
+{
+	switch (category)
+	{
+	case MemoryCategory::CpuMesh: return "CPU mesh";
+	case MemoryCategory::CpuTexture: return "CPU texture";
+	case MemoryCategory::GpuBuffer: return "GPU buffer";
+	case MemoryCategory::GpuTexture: return "GPU texture";
+	default: return "unknown";
+	}
+}
+
+MemoryTracker& MemoryTracker::Instance()
+{
+	static MemoryTracker tracker;
+	return tracker;
+}
+
+void MemoryTracker::Add(MemoryCategory category, size_t bytes)
+{
+	auto& c = counters[(size_t) category];
+	c.allocations.fetch_add(1, std::memory_order_relaxed);
+	const auto current = c.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+	auto peak = c.peak.load(std::memory_order_relaxed);
+	while (current > peak && !c.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+	{
+	}
+}
+
+void MemoryTracker::Remove(MemoryCategory category, size_t bytes)
+{
+	auto& c = counters[(size_t) category];
+	c.frees.fetch_add(1, std::memory_order_relaxed);
+	c.current.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+MemoryUsage MemoryTracker::Usage(MemoryCategory category) const
+{
+	const auto& c = counters[(size_t) category];
+	MemoryUsage usage;
+	usage.current = c.current.load(std::memory_order_relaxed);
+	usage.peak = c.peak.load(std::memory_order_relaxed);
+	usage.allocations = c.allocations.load(std::memory_order_relaxed);
+	usage.frees = c.frees.load(std::memory_order_relaxed);
+	return usage;
+}
+
+std::vector<std::string> MemoryTracker::Report() const
+{
+	std::vector<std::string> lines;
+	size_t current = 0, peak = 0;
+	for (size_t i = 0; i < (size_t) MemoryCategory::Count; i++)
+	{
+		const auto category = (MemoryCategory) i;
+		const auto usage = Usage(category);
+		current += usage.current;
+		peak += usage.peak;
+
+		std::ostringstream line;
+		line << ToString(category) << " : " << Megabytes(usage.current) << " current, " << Megabytes(usage.peak) << " peak, "
+			<< usage.allocations << " allocations, " << usage.frees << " frees";
+		lines.push_back(line.str());
+	}
+
+	// Somme des pics de chaque catégorie : borne haute, les pics ne sont pas forcément simultanés
+	lines.push_back("Total : " + Megabytes(current) + " current, " + Megabytes(peak) + " sum of peaks");
+	return lines;
+}
+
+TrackedBytes::TrackedBytes(MemoryCategory category, size_t bytes)
+	: category(category), bytes(0)
+{
+	Set(bytes);
+}
+
+TrackedBytes::~TrackedBytes()
+{
+	Set(0);
+}
+
+TrackedBytes::TrackedBytes(TrackedBytes&& other) noexcept
+	: category(other.category), bytes(other.bytes)
+{
+	other.bytes = 0;
+}
+
+TrackedBytes& TrackedBytes::operator=(TrackedBytes&& other) noexcept
+{
+	if (this != &other)
+	{
+		Set(0);
+		category = other.category;
+		bytes = other.bytes;
+		other.bytes = 0;
+	}
+	return *this;
+}
+
+void TrackedBytes::Set(size_t newBytes)
+{
+	if (newBytes == bytes)
+		return;
+
+	auto& tracker = MemoryTracker::Instance();
+	if (bytes > 0)
+		tracker.Remove(category, bytes);
+	if (newBytes > 0)
+		tracker.Add(category, newBytes);
+	bytes = newBytes;
+}
+
+AssetArena::AssetArena(MemoryCategory category, size_t blockSize, size_t alignment)
+	: category(category), blockSize(blockSize), alignment(alignment)
+{
+	if (!IsPowerOfTwo(alignment))
+		throw std::invalid_argument("AssetArena: alignment must be a power of two");
+}
+
+AssetArena::~AssetArena()
+{
+	Release();
+}
+
+void* AssetArena::Allocate(size_t size, size_t align)
+{
+	align = std::max(align, alignment);
+	if (!IsPowerOfTwo(align))
+		throw std::invalid_argument("AssetArena: alignment must be a power of two");
+
+	if (!blocks.empty())
+	{
+		const auto base = reinterpret_cast<uintptr_t>(blocks.back().memory);
+		const auto start = RoundUp(base + offset, align) - base;
+		if (start + size <= blocks.back().size)
+		{
+			offset = start + size;
+			used += size;
+			return reinterpret_cast<void*>(base + start);
+		}
+	}
+
+	// Le reste du bloc courant est abandonné jusqu'à Release. Le nouveau est assez grand pour la demande et son alignement.
+	const auto newSize = std::max(blockSize, RoundUp(size + (align - alignment), alignment));
+	blocks.push_back({ ::operator new(newSize, std::align_val_t(alignment)), newSize });
+	MemoryTracker::Instance().Add(category, newSize);
+	capacity += newSize;
+	offset = 0;
+	return Allocate(size, align);
+}
+
+void AssetArena::Release()
+{
+	for (const auto& block : blocks)
+	{
+		MemoryTracker::Instance().Remove(category, block.size);
+		::operator delete(block.memory, std::align_val_t(alignment));
+	}
+	blocks.clear();
+	offset = 0;
+	used = 0;
+	capacity = 0;
+}
+
+AssetPool::AssetPool(MemoryCategory category, size_t blockSize, size_t blocksPerSlab, size_t alignment)
+	: category(category), blockSize(RoundUp(std::max<size_t>(1, blockSize), alignment)), blocksPerSlab(std::max<size_t>(1, blocksPerSlab)), alignment(alignment)
+{
+	if (!IsPowerOfTwo(alignment))
+		throw std::invalid_argument("AssetPool: alignment must be a power of two");
+}
+
+AssetPool::~AssetPool()
+{
+	for (const auto slab : slabs)
+	{
+		MemoryTracker::Instance().Remove(category, blockSize * blocksPerSlab);
+		::operator delete(slab, std::align_val_t(alignment));
+	}
+}
+
+void AssetPool::AddSlab()
+{
+	// Ses blocs sont rendus dans l'ordre, le premier servi est celui d'indice le plus bas
+	slabs.push_back(::operator new(blockSize * blocksPerSlab, std::align_val_t(alignment)));
+	MemoryTracker::Instance().Add(category, blockSize * blocksPerSlab);
+
+	const auto first = slots.size();
+	slots.resize(first + blocksPerSlab);
+	freeSlots.reserve(slots.size());
+	for (size_t i = blocksPerSlab; i-- > 0;)
+		freeSlots.push_back((uint32_t) (first + i));
+}
+
+void AssetPool::Reserve(size_t blocks)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	while (slots.size() < blocks)
+		AddSlab();
+}
+
+PoolHandle AssetPool::Allocate()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (freeSlots.empty())
+		AddSlab();
+
+	const auto index = freeSlots.back();
+	freeSlots.pop_back();
+	auto& slot = slots[index];
+	slot.used = true;
+	inUse++;
+	return { index, slot.generation };
+}
+
+void AssetPool::Free(PoolHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!handle.Valid() || handle.index >= slots.size())
+		return;
+
+	auto& slot = slots[handle.index];
+	if (!slot.used || slot.generation != handle.generation)
+		return;
+
+	slot.used = false;
+	slot.generation++;
+	freeSlots.push_back(handle.index);
+	inUse--;
+}
+
+void* AssetPool::Data(PoolHandle handle) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (!handle.Valid() || handle.index >= slots.size())
+		return nullptr;
+
+	const auto& slot = slots[handle.index];
+	if (!slot.used || slot.generation != handle.generation)
+		return nullptr;
+
+	return static_cast<std::byte*>(slabs[handle.index / blocksPerSlab]) + (handle.index % blocksPerSlab) * blockSize;
+}
+
+size_t AssetPool::BlocksInUse() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return inUse;
+}
+
+size_t AssetPool::Capacity() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return slots.size();
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+// Catégories du relevé mémoire des assets. Côté GPU ce sont les tailles demandées au driver.
+enum class MemoryCategory
+{
+	CpuMesh,
+	CpuTexture,
+	GpuBuffer,
+	GpuTexture,
+	Count
+};
+
+const char* ToString(MemoryCategory category);
+
+struct MemoryUsage
+{
+	size_t current = 0;
+	size_t peak = 0;
+	uint64_t allocations = 0;
+	uint64_t frees = 0;
+};
+
+// Compteurs par catégorie, sans verrou : interrogeables à tout moment depuis n'importe quel thread
+class MemoryTracker
+{
+public:
+	static MemoryTracker& Instance();
+
+	void Add(MemoryCategory category, size_t bytes);
+	void Remove(MemoryCategory category, size_t bytes);
+
+	MemoryUsage Usage(MemoryCategory category) const;
+	// Une ligne par catégorie, puis le total
+	std::vector<std::string> Report() const;
+
+private:
+	struct Counters
+	{
+		std::atomic<size_t> current{ 0 };
+		std::atomic<size_t> peak{ 0 };
+		std::atomic<uint64_t> allocations{ 0 };
+		std::atomic<uint64_t> frees{ 0 };
+	};
+
+	std::array<Counters, (size_t) MemoryCategory::Count> counters;
+};
+
+// Octets comptés dans une catégorie pendant la vie de l'objet, pour la mémoire qu'on ne possède pas soi-même
+// (buffers et textures GL). Set remplace la taille comptée, par exemple après un glNamedBufferData.
+class TrackedBytes
+{
+public:
+	explicit TrackedBytes(MemoryCategory category, size_t bytes = 0);
+	~TrackedBytes();
+
+	TrackedBytes(TrackedBytes&& other) noexcept;
+	TrackedBytes& operator=(TrackedBytes&& other) noexcept;
+	TrackedBytes(const TrackedBytes&) = delete;
+	TrackedBytes& operator=(const TrackedBytes&) = delete;
+
+	void Set(size_t newBytes);
+	size_t Bytes() const { return bytes; }
+
+private:
+	MemoryCategory category;
+	size_t bytes;
+};
+
+// Allocateur STL aligné (une ligne de cache par défaut, assez pour des chargements SSE/AVX alignés)
+// qui compte ses octets dans Category
+template <typename T, MemoryCategory Category, size_t Alignment = 64>
+class TrackedAllocator
+{
+public:
+	using value_type = T;
+
+	template <typename U>
+	struct rebind
+	{
+		using other = TrackedAllocator<U, Category, Alignment>;
+	};
+
+	TrackedAllocator() noexcept = default;
+	template <typename U>
+	TrackedAllocator(const TrackedAllocator<U, Category, Alignment>&) noexcept {}
+
+	T* allocate(size_t n)
+	{
+		if (n > (size_t) -1 / sizeof(T))
+			throw std::bad_array_new_length();
+		const auto p = ::operator new(n * sizeof(T), std::align_val_t(std::max(Alignment, alignof(T))));
+		MemoryTracker::Instance().Add(Category, n * sizeof(T));
+		return static_cast<T*>(p);
+	}
+
+	void deallocate(T* p, size_t n) noexcept
+	{
+		MemoryTracker::Instance().Remove(Category, n * sizeof(T));
+		::operator delete(p, std::align_val_t(std::max(Alignment, alignof(T))));
+	}
+
+	template <typename U>
+	bool operator==(const TrackedAllocator<U, Category, Alignment>&) const { return true; }
+	template <typename U>
+	bool operator!=(const TrackedAllocator<U, Category, Alignment>&) const { return false; }
+};
+
+// Allocateur linéaire aligné et compté : les données d'un même chargement, libérées ensemble par Release
+class AssetArena
+{
+public:
+	explicit AssetArena(MemoryCategory category, size_t blockSize = 1 << 20, size_t alignment = 64);
+	~AssetArena();
+
+	AssetArena(const AssetArena&) = delete;
+	AssetArena& operator=(const AssetArena&) = delete;
+
+	// alignment : puissance de deux, 0 pour celui de l'arène
+	void* Allocate(size_t size, size_t alignment = 0);
+
+	template <typename T>
+	T* AllocateArray(size_t count) { return static_cast<T*>(Allocate(count * sizeof(T), std::max(alignof(T), alignment))); }
+
+	// Rend tous les blocs
+	void Release();
+
+	size_t Used() const { return used; }
+	size_t Capacity() const { return capacity; }
+
+private:
+	struct Block
+	{
+		void* memory;
+		size_t size;
+	};
+
+	const MemoryCategory category;
+	const size_t blockSize;
+	const size_t alignment;
+	std::vector<Block> blocks;
+	size_t offset = 0; // dans le dernier bloc
+	size_t used = 0;
+	size_t capacity = 0;
+};
+
+// Désigne un bloc d'un AssetPool. La génération rend le handle invalide une fois le bloc rendu,
+// même si sa place a été réattribuée.
+struct PoolHandle
+{
+	uint32_t index = UINT32_MAX;
+	uint32_t generation = 0;
+
+	bool Valid() const { return index != UINT32_MAX; }
+};
+
+// Blocs de taille fixe, alignés et comptés, alloués par lames de blocksPerSlab et recyclés :
+// tampons de même taille qui vont et viennent (morceaux de maillage streamés...). Thread-safe.
+class AssetPool
+{
+public:
+	AssetPool(MemoryCategory category, size_t blockSize, size_t blocksPerSlab = 64, size_t alignment = 64);
+	~AssetPool();
+
+	AssetPool(const AssetPool&) = delete;
+	AssetPool& operator=(const AssetPool&) = delete;
+
+	// Alloue d'avance les lames pour blocks blocs : plus d'allocation tant qu'on n'en demande pas davantage
+	void Reserve(size_t blocks);
+
+	PoolHandle Allocate();
+	// Sans effet sur un handle déjà rendu
+	void Free(PoolHandle handle);
+
+	// nullptr si le handle a été rendu
+	void* Data(PoolHandle handle) const;
+
+	size_t BlockSize() const { return blockSize; }
+	size_t BlocksInUse() const;
+	size_t Capacity() const; // en blocs
+
+private:
+	struct Slot
+	{
+		uint32_t generation = 0;
+		bool used = false;
+	};
+
+	const MemoryCategory category;
+	const size_t blockSize; // arrondi à l'alignement
+	const size_t blocksPerSlab;
+	const size_t alignment;
+
+	void AddSlab();
+
+	mutable std::mutex mutex;
+	std::vector<void*> slabs;
+	std::vector<Slot> slots;
+	std::vector<uint32_t> freeSlots;
+	size_t inUse = 0;
+};
@@ -0,0 +1,231 @@
+#include "AtlasPacker.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#include "Parallel.h"
+
+namespace
+{
+	int AlignUp(int value, int alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+SkylinePacker::SkylinePacker(int width, int height)
+	: width(width), height(height)
+{
+	skyline.push_back({ 0, 0, width });
+}
+
+int SkylinePacker::Fit(size_t index, int rectWidth, int rectHeight) const
+{
+	const auto x = skyline[index].x;
+	if (x + rectWidth > width)
+		return -1;
+
+	// Le rectangle repose sur le plus haut des segments qu'il recouvre
+	auto y = skyline[index].y;
+	for (auto remaining = rectWidth; remaining > 0; remaining -= skyline[index++].width)
+	{
+		y = std::max(y, skyline[index].y);
+		if (y + rectHeight > height)
+			return -1;
+	}
+	return y;
+}
+
+bool SkylinePacker::Insert(int rectWidth, int rectHeight, AtlasRect& outRect)
+{
+	if (rectWidth <= 0 || rectHeight <= 0)
+		return false;
+
+	size_t best = skyline.size();
+	int bestY = 0, bestBottom = INT_MAX, bestWidth = INT_MAX;
+	for (size_t i = 0; i < skyline.size(); i++)
+	{
+		const auto y = Fit(i, rectWidth, rectHeight);
+		if (y < 0)
+			continue;
+
+		const auto bottom = y + rectHeight;
+		if (bottom < bestBottom || (bottom == bestBottom && skyline[i].width < bestWidth))
+		{
+			best = i;
+			bestY = y;
+			bestBottom = bottom;
+			bestWidth = skyline[i].width;
+		}
+	}
+	if (best == skyline.size())
+		return false;
+
+	outRect = { skyline[best].x, bestY, rectWidth, rectHeight };
+	usedArea += (size_t) rectWidth * rectHeight;
+
+	// Nouveau segment au-dessus du rectangle, les segments qu'il recouvre sont raccourcis ou retirés
+	skyline.insert(skyline.begin() + best, { outRect.x, bestBottom, rectWidth });
+	const auto right = outRect.x + rectWidth;
+	for (auto i = best + 1; i < skyline.size() && skyline[i].x < right;)
+	{
+		const auto overlap = right - skyline[i].x;
+		if (overlap >= skyline[i].width)
+		{
+			skyline.erase(skyline.begin() + i);
+			continue;
+		}
+		skyline[i].x += overlap;
+		skyline[i].width -= overlap;
+		break;
+	}
+
+	// Fusion des voisins de même hauteur
+	for (size_t i = 0; i + 1 < skyline.size();)
+	{
+		if (skyline[i].y == skyline[i + 1].y)
+		{
+			skyline[i].width += skyline[i + 1].width;
+			skyline.erase(skyline.begin() + i + 1);
+		}
+		else
+		{
+			i++;
+		}
+	}
+	return true;
+}
+
+int SkylinePacker::UsedHeight() const
+{
+	int used = 0;
+	for (const auto& segment : skyline)
+		used = std::max(used, segment.y);
+	return used;
+}
+
+double SkylinePacker::Occupancy() const
+{
+	const auto used = UsedHeight();
+	return used == 0 ? 0.0 : (double) usedArea / ((double) width * used);
+}
+
+TextureAtlas BuildAtlas(const std::vector<TextureImage>& images, const AtlasOptions& options)
+{
+	TextureAtlas atlas;
+	if (images.empty())
+		return atlas;
+
+	const auto padding = std::max(0, options.padding);
+	const auto alignment = std::max(1, options.alignment);
+	const auto channels = images[0].channels;
+
+	// Emplacement de chaque image : l'image, son remplissage des deux côtés, arrondis à l'alignement
+	std::vector<AtlasRect> slots(images.size());
+	double area = 0.0;
+	int widest = 0, tallest = 0;
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		const auto& image = images[i];
+		if (image.channels != channels || image.width <= 0 || image.height <= 0)
+		{
+			throw std::runtime_error("Atlas: image " + std::to_string(i) + " is empty or has a different channel count");
+		}
+
+		slots[i].width = AlignUp(image.width + 2 * padding, alignment);
+		slots[i].height = AlignUp(image.height + 2 * padding, alignment);
+		area += (double) slots[i].width * slots[i].height;
+		widest = std::max(widest, slots[i].width);
+		tallest = std::max(tallest, slots[i].height);
+	}
+	if (widest > options.maxSize || tallest > options.maxSize)
+	{
+		throw std::runtime_error("Atlas: image larger than " + std::to_string(options.maxSize) + " texels");
+	}
+
+	// Les plus hautes d'abord : la ligne d'horizon reste plate plus longtemps
+	std::vector<size_t> order(images.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+	{
+		return slots[a].height != slots[b].height ? slots[a].height > slots[b].height : slots[a].width > slots[b].width;
+	});
+
+	// Départ sur un carré de l'aire totale, puis la plus petite dimension grandit d'un huitième à chaque échec
+	const auto side = AlignUp((int) std::ceil(std::sqrt(area)), alignment);
+	auto width = std::min(options.maxSize, std::max(side, widest));
+	auto height = std::min(options.maxSize, std::max(side, tallest));
+	for (;;)
+	{
+		SkylinePacker packer(width, height);
+		auto packed = true;
+		for (const auto i : order)
+		{
+			if (!packer.Insert(slots[i].width, slots[i].height, slots[i]))
+			{
+				packed = false;
+				break;
+			}
+		}
+
+		if (packed)
+		{
+			height = AlignUp(packer.UsedHeight(), alignment);
+			break;
+		}
+
+		if (width >= options.maxSize && height >= options.maxSize)
+		{
+			throw std::runtime_error("Atlas: images do not fit in " + std::to_string(options.maxSize) + " texels");
+		}
+
+		auto& grown = (width <= height && width < options.maxSize) || height >= options.maxSize ? width : height;
+		grown = std::min(options.maxSize, AlignUp(grown + std::max(alignment, grown / 8), alignment));
+	}
+
+	atlas.image.width = width;
+	atlas.image.height = height;
+	atlas.image.channels = channels;
+	atlas.image.pixels.assign((size_t) width * height * channels, 0);
+	atlas.rects.resize(images.size());
+	atlas.uvRects.resize(images.size());
+
+	double imageArea = 0.0;
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		const auto& image = images[i];
+		const auto& slot = slots[i];
+
+		// Tout l'emplacement est rempli en répétant le texel de bord le plus proche : le remplissage d'alignement
+		// compris, un bloc BC1 ou un texel de mip à cheval sur le bord ne voit que l'image
+		ParallelFor(slot.height, [&](size_t begin, size_t end)
+		{
+			for (auto y = (int) begin; y < (int) end; y++)
+			{
+				const auto sourceY = std::clamp(y - padding, 0, image.height - 1);
+				const auto source = image.pixels.data() + (size_t) sourceY * image.width * channels;
+				auto destination = atlas.image.pixels.data() + ((size_t) (slot.y + y) * width + slot.x) * channels;
+
+				for (auto x = 0; x < padding; x++, destination += channels)
+					std::memcpy(destination, source, channels);
+				std::memcpy(destination, source, (size_t) image.width * channels);
+				destination += (size_t) image.width * channels;
+				for (auto x = padding + image.width; x < slot.width; x++, destination += channels)
+					std::memcpy(destination, source + (size_t) (image.width - 1) * channels, channels);
+			}
+		}, 64);
+
+		auto& rect = atlas.rects[i];
+		rect = { slot.x + padding, slot.y + padding, image.width, image.height };
+		atlas.uvRects[i] = glm::vec4((float) rect.x / width, (float) rect.y / height, (float) rect.width / width, (float) rect.height / height);
+		imageArea += (double) image.width * image.height;
+	}
+	atlas.occupancy = imageArea / ((double) width * height);
+
+	return atlas;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+#include "MipChain.h"
+
+// Rectangle en texels dans l'atlas, origine en haut à gauche comme les lignes de TextureImage
+struct AtlasRect
+{
+	int x = 0;
+	int y = 0;
+	int width = 0;
+	int height = 0;
+};
+
+// Empaquetage "skyline bottom-left" : la ligne d'horizon des rectangles déjà placés est gardée comme une suite
+// de segments, chaque rectangle se pose là où son bord bas serait le plus haut, à égalité sur le segment le plus étroit.
+class SkylinePacker
+{
+public:
+	SkylinePacker(int width, int height);
+
+	// Place un rectangle width x height ; faux s'il ne tient plus, le packer reste alors inchangé
+	bool Insert(int width, int height, AtlasRect& outRect);
+
+	// Hauteur réellement utilisée, sommet de la ligne d'horizon
+	int UsedHeight() const;
+
+	// Aire des rectangles placés sur l'aire de width x UsedHeight
+	double Occupancy() const;
+
+	int Width() const { return width; }
+	int Height() const { return height; }
+
+private:
+	struct Segment
+	{
+		int x, y, width;
+	};
+
+	// Ordonnée où poser un rectangle de largeur width à partir du segment index, -1 s'il déborde
+	int Fit(size_t index, int width, int height) const;
+
+	int width, height;
+	size_t usedArea = 0;
+	std::vector<Segment> skyline;
+};
+
+struct AtlasOptions
+{
+	// Texels répétés autour de chaque image : le filtrage et les mips ne mélangent pas les voisines.
+	// Il en faut 2^n pour que le niveau n reste propre.
+	int padding = 4;
+	// Les emplacements commencent et mesurent un multiple de alignment texels ; 4 garde les images sur les blocs BC1
+	int alignment = 4;
+	int maxSize = 8192;
+};
+
+// Atlas construit par BuildAtlas, dans l'ordre des images d'entrée
+struct TextureAtlas
+{
+	TextureImage image;
+	std::vector<AtlasRect> rects; // zone de chaque image, bordures exclues
+	std::vector<glm::vec4> uvRects; // table de correspondance : uv atlas = xy + uv image * zw
+	double occupancy = 0.0; // aire des images, bordures exclues, sur l'aire de l'atlas
+};
+
+// Table d'une image occupant tout l'atlas, pour les matériaux sans texture propre
+inline glm::vec4 FullUvRect()
+{
+	return glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+}
+
+// Empaquette les images (même nombre de canaux) par hauteurs décroissantes, en agrandissant l'atlas tant qu'elles
+// ne tiennent pas, puis les copie avec leurs bords étendus dans le remplissage.
+// Lance std::runtime_error si les images dépassent maxSize ou n'ont pas le même nombre de canaux.
+TextureAtlas BuildAtlas(const std::vector<TextureImage>& images, const AtlasOptions& options = {});
@@ -0,0 +1,370 @@
+#include "BlockCompression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define BLOCK_COMPRESSION_SSE 1
+#endif
+
+#include "Parallel.h"
+
+namespace
+{
+	// Bloc de 4x4 pixels en composantes séparées, pour traiter 4 pixels à la fois
+	struct Block
+	{
+		alignas(16) float r[16];
+		alignas(16) float g[16];
+		alignas(16) float b[16];
+	};
+
+	struct Color
+	{
+		float r, g, b;
+	};
+
+	Block ReadBlock(const TextureImage& image, int bx, int by)
+	{
+		Block block;
+		for (int y = 0; y < 4; y++)
+		{
+			const auto sy = std::min(by * 4 + y, image.height - 1);
+			for (int x = 0; x < 4; x++)
+			{
+				const auto sx = std::min(bx * 4 + x, image.width - 1);
+				const auto p = image.pixels.data() + ((size_t) sy * image.width + sx) * image.channels;
+				const auto i = y * 4 + x;
+				block.r[i] = p[0];
+				block.g[i] = image.channels >= 3 ? p[1] : p[0];
+				block.b[i] = image.channels >= 3 ? p[2] : p[0];
+			}
+		}
+		return block;
+	}
+
+	uint16_t Pack565(const Color& c)
+	{
+		const auto r = (int) std::lround(std::min(255.0f, std::max(0.0f, c.r)) * 31.0f / 255.0f);
+		const auto g = (int) std::lround(std::min(255.0f, std::max(0.0f, c.g)) * 63.0f / 255.0f);
+		const auto b = (int) std::lround(std::min(255.0f, std::max(0.0f, c.b)) * 31.0f / 255.0f);
+		return (uint16_t) ((r << 11) | (g << 5) | b);
+	}
+
+	Color Unpack565(uint16_t c)
+	{
+		const auto r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+		return { (float) ((r << 3) | (r >> 2)), (float) ((g << 2) | (g >> 4)), (float) ((b << 3) | (b >> 2)) };
+	}
+
+	// Palette du mode 4 couleurs : c0, c1, 2/3 c0 + 1/3 c1, 1/3 c0 + 2/3 c1
+	void MakePalette(uint16_t c0, uint16_t c1, Color palette[4])
+	{
+		palette[0] = Unpack565(c0);
+		palette[1] = Unpack565(c1);
+		palette[2] = { (2 * palette[0].r + palette[1].r) / 3, (2 * palette[0].g + palette[1].g) / 3, (2 * palette[0].b + palette[1].b) / 3 };
+		palette[3] = { (palette[0].r + 2 * palette[1].r) / 3, (palette[0].g + 2 * palette[1].g) / 3, (palette[0].b + 2 * palette[1].b) / 3 };
+	}
+
+	// Indice de la couleur la plus proche pour chaque pixel ; renvoie l'erreur quadratique totale
+	float ChooseIndices(const Block& block, const Color palette[4], uint8_t indices[16])
+	{
+#ifdef BLOCK_COMPRESSION_SSE
+		auto total = _mm_setzero_ps();
+		for (int i = 0; i < 16; i += 4)
+		{
+			const auto r = _mm_load_ps(block.r + i), g = _mm_load_ps(block.g + i), b = _mm_load_ps(block.b + i);
+			auto best = _mm_set1_ps(std::numeric_limits<float>::max());
+			auto bestIndex = _mm_setzero_ps();
+			for (int p = 0; p < 4; p++)
+			{
+				const auto dr = _mm_sub_ps(r, _mm_set1_ps(palette[p].r));
+				const auto dg = _mm_sub_ps(g, _mm_set1_ps(palette[p].g));
+				const auto db = _mm_sub_ps(b, _mm_set1_ps(palette[p].b));
+				const auto d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(dg, dg)), _mm_mul_ps(db, db));
+				const auto closer = _mm_cmplt_ps(d, best);
+				best = _mm_min_ps(d, best);
+				bestIndex = _mm_or_ps(_mm_and_ps(closer, _mm_set1_ps((float) p)), _mm_andnot_ps(closer, bestIndex));
+			}
+			total = _mm_add_ps(total, best);
+
+			alignas(16) float index[4];
+			_mm_store_ps(index, bestIndex);
+			for (int k = 0; k < 4; k++)
+				indices[i + k] = (uint8_t) index[k];
+		}
+		alignas(16) float sum[4];
+		_mm_store_ps(sum, total);
+		return sum[0] + sum[1] + sum[2] + sum[3];
+#else
+		auto total = 0.0f;
+		for (int i = 0; i < 16; i++)
+		{
+			auto best = std::numeric_limits<float>::max();
+			for (int p = 0; p < 4; p++)
+			{
+				const auto dr = block.r[i] - palette[p].r, dg = block.g[i] - palette[p].g, db = block.b[i] - palette[p].b;
+				const auto d = dr * dr + dg * dg + db * db;
+				if (d < best)
+				{
+					best = d;
+					indices[i] = (uint8_t) p;
+				}
+			}
+			total += best;
+		}
+		return total;
+#endif
+	}
+
+	// Extrémités sur la diagonale de la boîte englobante, rentrées de 1/16 pour limiter l'erreur aux bords
+	void BoundingBoxEndpoints(const Block& block, Color& c0, Color& c1)
+	{
+		Color lo{ 255, 255, 255 }, hi{ 0, 0, 0 };
+		for (int i = 0; i < 16; i++)
+		{
+			lo = { std::min(lo.r, block.r[i]), std::min(lo.g, block.g[i]), std::min(lo.b, block.b[i]) };
+			hi = { std::max(hi.r, block.r[i]), std::max(hi.g, block.g[i]), std::max(hi.b, block.b[i]) };
+		}
+		const Color inset{ (hi.r - lo.r) / 16, (hi.g - lo.g) / 16, (hi.b - lo.b) / 16 };
+		c0 = { hi.r - inset.r, hi.g - inset.g, hi.b - inset.b };
+		c1 = { lo.r + inset.r, lo.g + inset.g, lo.b + inset.b };
+	}
+
+	// Extrémités aux projections extrêmes sur l'axe principal (itération de la puissance sur la covariance)
+	void PrincipalAxisEndpoints(const Block& block, Color& c0, Color& c1)
+	{
+		Color mean{ 0, 0, 0 };
+		for (int i = 0; i < 16; i++)
+			mean = { mean.r + block.r[i] / 16, mean.g + block.g[i] / 16, mean.b + block.b[i] / 16 };
+
+		float cov[6] = {};
+		for (int i = 0; i < 16; i++)
+		{
+			const auto r = block.r[i] - mean.r, g = block.g[i] - mean.g, b = block.b[i] - mean.b;
+			cov[0] += r * r; cov[1] += r * g; cov[2] += r * b;
+			cov[3] += g * g; cov[4] += g * b; cov[5] += b * b;
+		}
+
+		Color axis{ 1, 1, 1 };
+		for (int k = 0; k < 8; k++)
+		{
+			const Color next{
+				cov[0] * axis.r + cov[1] * axis.g + cov[2] * axis.b,
+				cov[1] * axis.r + cov[3] * axis.g + cov[4] * axis.b,
+				cov[2] * axis.r + cov[4] * axis.g + cov[5] * axis.b };
+			const auto length = std::max({ std::fabs(next.r), std::fabs(next.g), std::fabs(next.b) });
+			if (length < 1e-6f)
+				break;
+			axis = { next.r / length, next.g / length, next.b / length };
+		}
+
+		const auto norm = axis.r * axis.r + axis.g * axis.g + axis.b * axis.b;
+		auto lo = std::numeric_limits<float>::max(), hi = -lo;
+		for (int i = 0; i < 16; i++)
+		{
+			const auto t = (block.r[i] - mean.r) * axis.r + (block.g[i] - mean.g) * axis.g + (block.b[i] - mean.b) * axis.b;
+			lo = std::min(lo, t);
+			hi = std::max(hi, t);
+		}
+		lo /= norm;
+		hi /= norm;
+		c0 = { mean.r + axis.r * hi, mean.g + axis.g * hi, mean.b + axis.b * hi };
+		c1 = { mean.r + axis.r * lo, mean.g + axis.g * lo, mean.b + axis.b * lo };
+	}
+
+	// Extrémités qui minimisent l'erreur pour des indices fixés. Faux si le système est dégénéré.
+	bool RefineEndpoints(const Block& block, const uint8_t indices[16], Color& c0, Color& c1)
+	{
+		static const float weight0[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+		float aa = 0, ab = 0, bb = 0;
+		Color ax{ 0, 0, 0 }, bx{ 0, 0, 0 };
+		for (int i = 0; i < 16; i++)
+		{
+			const auto a = weight0[indices[i]], b = 1.0f - a;
+			aa += a * a; ab += a * b; bb += b * b;
+			ax = { ax.r + a * block.r[i], ax.g + a * block.g[i], ax.b + a * block.b[i] };
+			bx = { bx.r + b * block.r[i], bx.g + b * block.g[i], bx.b + b * block.b[i] };
+		}
+
+		const auto det = aa * bb - ab * ab;
+		if (std::fabs(det) < 1e-6f)
+			return false;
+
+		const auto inv = 1.0f / det;
+		c0 = { (bb * ax.r - ab * bx.r) * inv, (bb * ax.g - ab * bx.g) * inv, (bb * ax.b - ab * bx.b) * inv };
+		c1 = { (aa * bx.r - ab * ax.r) * inv, (aa * bx.g - ab * ax.g) * inv, (aa * bx.b - ab * ax.b) * inv };
+		return true;
+	}
+
+	void ProjectIndices(const Block& block, const Color palette[4], uint8_t indices[16])
+	{
+		// t = 1 sur c0, 0 sur c1 ; arrondi au tiers le plus proche
+		static const uint8_t byThird[4] = { 1, 3, 2, 0 };
+		const Color dir{ palette[0].r - palette[1].r, palette[0].g - palette[1].g, palette[0].b - palette[1].b };
+		const auto norm = dir.r * dir.r + dir.g * dir.g + dir.b * dir.b;
+		for (int i = 0; i < 16; i++)
+		{
+			const auto t = norm > 0 ? ((block.r[i] - palette[1].r) * dir.r + (block.g[i] - palette[1].g) * dir.g + (block.b[i] - palette[1].b) * dir.b) / norm : 0.0f;
+			indices[i] = byThird[(int) (std::min(1.0f, std::max(0.0f, t)) * 3.0f + 0.5f)];
+		}
+	}
+
+	void WriteBlock(uint16_t c0, uint16_t c1, const uint8_t indices[16], uint8_t* out)
+	{
+		uint32_t bits = 0;
+		if (c0 == c1)
+		{
+			// Couleur unique : tous les indices à 0
+		}
+		else
+		{
+			// Le mode 4 couleurs exige c0 > c1 : l'échange inverse aussi 0/1 et 2/3
+			const auto swap = c0 < c1;
+			if (swap)
+				std::swap(c0, c1);
+			for (int i = 0; i < 16; i++)
+				bits |= (uint32_t) (swap ? indices[i] ^ 1 : indices[i]) << (2 * i);
+		}
+
+		out[0] = (uint8_t) c0; out[1] = (uint8_t) (c0 >> 8);
+		out[2] = (uint8_t) c1; out[3] = (uint8_t) (c1 >> 8);
+		std::memcpy(out + 4, &bits, 4);
+	}
+
+	void EncodeBlock(const Block& block, Bc1Quality quality, uint8_t* out)
+	{
+		Color e0, e1;
+		if (quality == Bc1Quality::Fast)
+			BoundingBoxEndpoints(block, e0, e1);
+		else
+			PrincipalAxisEndpoints(block, e0, e1);
+
+		auto c0 = Pack565(e0), c1 = Pack565(e1);
+		Color palette[4];
+		MakePalette(c0, c1, palette);
+
+		uint8_t indices[16];
+		if (quality == Bc1Quality::Fast)
+		{
+			ProjectIndices(block, palette, indices);
+			WriteBlock(c0, c1, indices, out);
+			return;
+		}
+
+		auto error = ChooseIndices(block, palette, indices);
+		if (quality == Bc1Quality::High)
+		{
+			for (int iteration = 0; iteration < 2 && error > 0; iteration++)
+			{
+				if (!RefineEndpoints(block, indices, e0, e1))
+					break;
+
+				const auto r0 = Pack565(e0), r1 = Pack565(e1);
+				Color refined[4];
+				MakePalette(r0, r1, refined);
+
+				uint8_t refinedIndices[16];
+				const auto refinedError = ChooseIndices(block, refined, refinedIndices);
+				if (refinedError >= error)
+					break;
+
+				error = refinedError;
+				c0 = r0;
+				c1 = r1;
+				std::memcpy(indices, refinedIndices, 16);
+			}
+		}
+
+		WriteBlock(c0, c1, indices, out);
+	}
+}
+
+TextureBytes EncodeBc1(const TextureImage& image, Bc1Quality quality)
+{
+	const auto blocksX = (image.width + 3) / 4, blocksY = (image.height + 3) / 4;
+	TextureBytes out(Bc1Size(image.width, image.height));
+
+	ParallelFor(blocksY, [&](size_t begin, size_t end)
+	{
+		for (auto by = begin; by < end; by++)
+		{
+			for (int bx = 0; bx < blocksX; bx++)
+				EncodeBlock(ReadBlock(image, bx, (int) by), quality, out.data() + (by * blocksX + bx) * 8);
+		}
+	}, 8);
+	return out;
+}
+
+TextureImage DecodeBc1(const uint8_t* blocks, int width, int height)
+{
+	TextureImage image;
+	image.width = width;
+	image.height = height;
+	image.channels = 3;
+	image.pixels.resize((size_t) width * height * 3);
+
+	const auto blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+	for (int by = 0; by < blocksY; by++)
+	{
+		for (int bx = 0; bx < blocksX; bx++)
+		{
+			const auto block = blocks + ((size_t) by * blocksX + bx) * 8;
+			const auto c0 = (uint16_t) (block[0] | (block[1] << 8)), c1 = (uint16_t) (block[2] | (block[3] << 8));
+			uint32_t bits;
+			std::memcpy(&bits, block + 4, 4);
+
+			Color palette[4];
+			MakePalette(c0, c1, palette);
+			if (c0 <= c1)
+			{
+				// Mode 3 couleurs (jamais produit par EncodeBc1) : moyenne puis noir
+				palette[2] = { (palette[0].r + palette[1].r) / 2, (palette[0].g + palette[1].g) / 2, (palette[0].b + palette[1].b) / 2 };
+				palette[3] = { 0, 0, 0 };
+			}
+
+			for (int i = 0; i < 16; i++)
+			{
+				const auto x = bx * 4 + i % 4, y = by * 4 + i / 4;
+				if (x >= width || y >= height)
+					continue;
+
+				const auto& c = palette[(bits >> (2 * i)) & 3];
+				auto p = image.pixels.data() + ((size_t) y * width + x) * 3;
+				p[0] = (uint8_t) c.r;
+				p[1] = (uint8_t) c.g;
+				p[2] = (uint8_t) c.b;
+			}
+		}
+	}
+	return image;
+}
+
+double Psnr(const TextureImage& reference, const TextureImage& image)
+{
+	double sum = 0.0;
+	size_t count = 0;
+	const auto width = std::min(reference.width, image.width), height = std::min(reference.height, image.height);
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			const auto a = reference.pixels.data() + ((size_t) y * reference.width + x) * reference.channels;
+			const auto b = image.pixels.data() + ((size_t) y * image.width + x) * image.channels;
+			for (int c = 0; c < 3; c++)
+			{
+				const double d = (double) a[std::min(c, reference.channels - 1)] - b[std::min(c, image.channels - 1)];
+				sum += d * d;
+				count++;
+			}
+		}
+	}
+
+	if (count == 0 || sum == 0.0)
+		return std::numeric_limits<double>::infinity();
+	return 10.0 * std::log10(255.0 * 255.0 / (sum / count));
+}
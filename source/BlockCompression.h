@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "MipChain.h"
+
+enum class Bc1Quality
+{
+	Fast,   // extrémités sur la diagonale de la boîte englobante, indices par projection
+	Normal, // axe principal (ACP) et indices au plus proche de la palette
+	High    // Normal puis affinage des extrémités aux moindres carrés
+};
+
+// Taille en octets d'une image BC1 : 8 octets par bloc de 4x4, blocs partiels compris
+inline size_t Bc1Size(int width, int height)
+{
+	return (size_t) ((width + 3) / 4) * ((height + 3) / 4) * 8;
+}
+
+// Compresse les 3 premiers canaux en BC1 (mode 4 couleurs, sans alpha). Les blocs du bord répètent les derniers
+// pixels. Les lignes de blocs sont réparties sur les threads, les distances à la palette sont calculées en SSE.
+TextureBytes EncodeBc1(const TextureImage& image, Bc1Quality quality = Bc1Quality::Normal);
+
+// Décompresse en RGB 8 bits, pour mesurer la qualité de l'encodeur
+TextureImage DecodeBc1(const uint8_t* blocks, int width, int height);
+
+// Rapport signal/bruit de crête sur les 3 premiers canaux, en dB (infini si les images sont identiques)
+double Psnr(const TextureImage& reference, const TextureImage& image);
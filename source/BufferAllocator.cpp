@@ -0,0 +1,156 @@
+#include "BufferAllocator.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	size_t AlignUp(size_t offset, size_t alignment)
+	{
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+}
+
+BufferAllocator::BufferAllocator(size_t capacity)
+	: capacity(capacity)
+{
+	if (capacity > 0)
+		freeBlocks[0] = capacity;
+}
+
+size_t BufferAllocator::Allocate(size_t size, size_t alignment)
+{
+	if (size == 0 || alignment == 0)
+		throw std::invalid_argument("BufferAllocator: size and alignment must be non zero");
+
+	// Best fit : plus petit bloc libre pouvant contenir la taille demandée une fois aligné
+	auto best = freeBlocks.end();
+	for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it)
+	{
+		const auto padding = AlignUp(it->first, alignment) - it->first;
+		if (it->second >= size + padding && (best == freeBlocks.end() || it->second < best->second))
+			best = it;
+	}
+
+	if (best == freeBlocks.end())
+	{
+		failedAllocations++;
+		return InvalidOffset;
+	}
+
+	const auto blockOffset = best->first;
+	const auto blockSize = best->second;
+	const auto offset = AlignUp(blockOffset, alignment);
+	freeBlocks.erase(best);
+
+	// Le rembourrage d'alignement et le reste du bloc restent libres
+	if (offset > blockOffset)
+		freeBlocks[blockOffset] = offset - blockOffset;
+	if (blockOffset + blockSize > offset + size)
+		freeBlocks[offset + size] = blockOffset + blockSize - (offset + size);
+
+	allocations[offset] = { size, alignment };
+	used += size;
+	totalAllocations++;
+	return offset;
+}
+
+void BufferAllocator::Free(size_t offset)
+{
+	const auto it = allocations.find(offset);
+	if (it == allocations.end())
+		throw std::invalid_argument("BufferAllocator: no allocation at offset " + std::to_string(offset));
+
+	const auto size = it->second.size;
+	allocations.erase(it);
+	used -= size;
+	totalFrees++;
+
+	InsertFree(offset, size);
+}
+
+void BufferAllocator::InsertFree(size_t offset, size_t size)
+{
+	auto next = freeBlocks.lower_bound(offset);
+
+	// Fusion avec le bloc libre suivant
+	if (next != freeBlocks.end() && offset + size == next->first)
+	{
+		size += next->second;
+		next = freeBlocks.erase(next);
+	}
+
+	// Fusion avec le bloc libre précédent
+	if (next != freeBlocks.begin())
+	{
+		auto previous = std::prev(next);
+		if (previous->first + previous->second == offset)
+		{
+			previous->second += size;
+			return;
+		}
+	}
+
+	freeBlocks[offset] = size;
+}
+
+std::vector<BufferMove> BufferAllocator::Defragment()
+{
+	std::vector<BufferMove> moves;
+	std::map<size_t, Allocation> packed;
+
+	// Les blocs ne font que reculer : appliquer les copies dans l'ordre ne lit jamais une zone déjà écrasée
+	size_t cursor = 0;
+	for (auto&& [offset, allocation] : allocations)
+	{
+		const auto target = AlignUp(cursor, allocation.alignment);
+		if (target != offset)
+			moves.push_back({ offset, target, allocation.size });
+
+		packed[target] = allocation;
+		cursor = target + allocation.size;
+	}
+
+	allocations.swap(packed);
+	freeBlocks.clear();
+
+	// Reconstruit la liste libre : trous d'alignement entre blocs et fin du buffer
+	size_t previousEnd = 0;
+	for (auto&& [offset, allocation] : allocations)
+	{
+		if (offset > previousEnd)
+			freeBlocks[previousEnd] = offset - previousEnd;
+		previousEnd = offset + allocation.size;
+	}
+	if (capacity > previousEnd)
+		freeBlocks[previousEnd] = capacity - previousEnd;
+
+	return moves;
+}
+
+size_t BufferAllocator::SizeOf(size_t offset) const
+{
+	const auto it = allocations.find(offset);
+	return it == allocations.end() ? 0 : it->second.size;
+}
+
+BufferAllocatorStats BufferAllocator::Stats() const
+{
+	BufferAllocatorStats stats;
+	stats.capacity = capacity;
+	stats.used = used;
+	stats.allocationCount = allocations.size();
+	stats.freeBlockCount = freeBlocks.size();
+	stats.totalAllocations = totalAllocations;
+	stats.totalFrees = totalFrees;
+	stats.failedAllocations = failedAllocations;
+
+	for (auto&& block : freeBlocks)
+	{
+		stats.free += block.second;
+		stats.largestFreeBlock = std::max(stats.largestFreeBlock, block.second);
+	}
+
+	return stats;
+}
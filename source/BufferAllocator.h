@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <vector>
+
+// Déplacement d'un bloc lors d'une défragmentation, à reproduire sur le buffer GPU
+struct BufferMove
+{
+	size_t from, to, size;
+};
+
+struct BufferAllocatorStats
+{
+	size_t capacity = 0;
+	size_t used = 0;
+	size_t free = 0;
+	size_t largestFreeBlock = 0;
+	size_t freeBlockCount = 0;
+	size_t allocationCount = 0;
+	size_t totalAllocations = 0;
+	size_t totalFrees = 0;
+	size_t failedAllocations = 0;
+
+	// 0 : tout l'espace libre est contigu, proche de 1 : l'espace libre est éparpillé
+	float Fragmentation() const { return free == 0 ? 0.0f : 1.0f - (float) largestFreeBlock / (float) free; }
+};
+
+// Sous-allocateur d'offsets dans un grand buffer de taille fixe, indépendant d'OpenGL.
+// Les blocs libres sont triés par offset pour fusionner les voisins à la libération ;
+// l'allocation choisit le plus petit bloc libre suffisant (best fit).
+class BufferAllocator
+{
+public:
+	static constexpr size_t InvalidOffset = (size_t) -1;
+
+	explicit BufferAllocator(size_t capacity);
+
+	// Renvoie un offset multiple de alignment (quelconque, pas forcément une puissance de 2), ou InvalidOffset
+	size_t Allocate(size_t size, size_t alignment = 1);
+	void Free(size_t offset);
+
+	// Tasse les blocs alloués au début du buffer, dans l'ordre des offsets, en respectant leur alignement.
+	// Les déplacements sont renvoyés dans l'ordre où ils ont été appliqués ; les offsets changent.
+	std::vector<BufferMove> Defragment();
+
+	size_t SizeOf(size_t offset) const;
+	size_t Capacity() const { return capacity; }
+	BufferAllocatorStats Stats() const;
+
+private:
+	struct Allocation
+	{
+		size_t size, alignment;
+	};
+
+	void InsertFree(size_t offset, size_t size);
+
+	size_t capacity;
+	std::map<size_t, size_t> freeBlocks;      // offset -> taille
+	std::map<size_t, Allocation> allocations; // offset -> bloc alloué
+	size_t used = 0;
+	size_t totalAllocations = 0;
+	size_t totalFrees = 0;
+	size_t failedAllocations = 0;
+};
@@ -0,0 +1,24 @@
+#include "ChunkBufferPool.h"
+
+#include <stdexcept>
+
+ChunkBufferPool::ChunkBufferPool(size_t slotCount, size_t slotTriangles)
+	: slotCount(slotCount), slotTriangles(slotTriangles), gpuBytes(MemoryCategory::GpuBuffer, slotCount * slotTriangles * sizeof(TriangleWithNormal))
+{
+	glCreateBuffers(1, &vbo);
+	glNamedBufferStorage(vbo, gpuBytes.Bytes(), nullptr, GL_DYNAMIC_STORAGE_BIT);
+}
+
+ChunkBufferPool::~ChunkBufferPool()
+{
+	glDeleteBuffers(1, &vbo);
+}
+
+void ChunkBufferPool::Upload(uint32_t slot, const TriangleWithNormal* triangles, size_t triangleCount)
+{
+	if (slot >= slotCount || triangleCount > slotTriangles)
+		throw std::runtime_error("ChunkBufferPool: chunk does not fit its slot");
+
+	const auto slotBytes = slotTriangles * sizeof(TriangleWithNormal);
+	glNamedBufferSubData(vbo, slot * slotBytes, triangleCount * sizeof(TriangleWithNormal), triangles);
+}
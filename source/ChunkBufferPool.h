@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+
+#include "AssetMemory.h"
+#include "Triangle.h"
+
+// VBO de taille fixe découpé en emplacements égaux, un morceau de maillage streamé par emplacement.
+// Alloué une fois : envoyer un morceau ne fait qu'un glNamedBufferSubData, sans réallocation côté driver.
+class ChunkBufferPool
+{
+public:
+	ChunkBufferPool(size_t slotCount, size_t slotTriangles);
+	~ChunkBufferPool();
+
+	ChunkBufferPool(const ChunkBufferPool&) = delete;
+	ChunkBufferPool& operator=(const ChunkBufferPool&) = delete;
+
+	// triangleCount <= SlotTriangles()
+	void Upload(uint32_t slot, const TriangleWithNormal* triangles, size_t triangleCount);
+
+	// Premier sommet de l'emplacement, pour glDrawArrays / glMultiDrawArrays
+	GLint First(uint32_t slot) const { return (GLint) (slot * slotTriangles * 3); }
+
+	GLuint Buffer() const { return vbo; }
+	size_t SlotCount() const { return slotCount; }
+	size_t SlotTriangles() const { return slotTriangles; }
+
+private:
+	GLuint vbo;
+	const size_t slotCount;
+	const size_t slotTriangles;
+	TrackedBytes gpuBytes;
+};
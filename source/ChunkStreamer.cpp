@@ -0,0 +1,289 @@
+#include "ChunkStreamer.h"
+
+#include <algorithm>
+
+namespace
+{
+	size_t ChunkBytes(const ChunkFile& file)
+	{
+		return (size_t) file.MaxChunkTriangles() * sizeof(TriangleWithNormal);
+	}
+}
+
+ChunkStreamer::ChunkStreamer(const ChunkFile& file, const ChunkStreamerOptions& options, JobSystem& jobs)
+	: file(file), options(options), jobs(jobs),
+	cpuCapacity(std::max<size_t>(1, options.cpuBudgetBytes / ChunkBytes(file))),
+	cache(MemoryCategory::CpuMesh, ChunkBytes(file), cpuCapacity),
+	entries(file.Chunks().size()), slotChunks(std::max<size_t>(1, options.gpuSlots), None),
+	created(std::chrono::steady_clock::now())
+{
+	// Tout ce qui sert pendant les frames est alloué ici, cache compris
+	cache.Reserve(cpuCapacity);
+	spheres.reserve(entries.size());
+	for (const auto& chunk : file.Chunks())
+		spheres.emplace_back(chunk.Center(), chunk.Radius());
+	order.reserve(entries.size());
+	uploads.reserve(options.maxUploadsPerFrame);
+	draws.reserve(slotChunks.size());
+	completed.reserve(entries.size());
+	drained.reserve(entries.size());
+}
+
+ChunkStreamer::~ChunkStreamer()
+{
+	for (auto& entry : entries)
+	{
+		if (!entry.job)
+			continue;
+		try
+		{
+			jobs.Wait(entry.job);
+		}
+		catch (...)
+		{
+		}
+	}
+}
+
+void ChunkStreamer::Update(const glm::vec3& viewPosition)
+{
+	frame++;
+
+	// Sans thread de travail, les lectures ne progressent que si l'appelant attend : elles se font ici
+	if (jobs.ThreadCount() == 1 && loadsInFlight > 0)
+	{
+		for (const auto& entry : entries)
+			if (entry.loading)
+				jobs.Wait(entry.job);
+	}
+
+	// Lectures terminées : les blocs entrent dans le LRU
+	std::exception_ptr failed;
+	{
+		std::lock_guard<std::mutex> lock(completedMutex);
+		std::swap(failed, error);
+		drained.swap(completed);
+	}
+	if (failed)
+		std::rethrow_exception(failed);
+
+	for (const auto chunk : drained)
+	{
+		auto& entry = entries[chunk];
+		entry.loading = false;
+		entry.loaded = true;
+		entry.job.reset();
+		loadsInFlight--;
+		LruPushFront(chunk);
+	}
+	drained.clear();
+
+	// Priorité : distance de la vue à la sphère englobante, seuls les plus proches sont triés
+	order.clear();
+	for (uint32_t i = 0; i < spheres.size(); i++)
+	{
+		const auto distance = std::max(0.0f, glm::length(glm::vec3(spheres[i]) - viewPosition) - spheres[i].w);
+		if (distance <= options.maxViewDistance)
+			order.emplace_back(distance, i);
+	}
+	const auto wanted = std::min(slotChunks.size(), order.size());
+	const auto considered = std::min(order.size(), wanted + options.prefetchChunks);
+	std::partial_sort(order.begin(), order.begin() + considered, order.end());
+
+	// Du plus loin au plus proche : le plus proche finit en tête du LRU
+	for (size_t r = considered; r-- > 0;)
+	{
+		const auto chunk = order[r].second;
+		auto& entry = entries[chunk];
+		if (r < wanted)
+			entry.lastWanted = frame;
+		// Sa copie en mémoire sert encore tant qu'il n'est pas sur le GPU
+		if (entry.gpuSlot == None)
+			entry.pinned = frame;
+		if (entry.loaded)
+		{
+			LruRemove(chunk);
+			LruPushFront(chunk);
+		}
+	}
+
+	uploads.clear();
+	draws.clear();
+	for (size_t r = 0; r < wanted; r++)
+	{
+		const auto chunk = order[r].second;
+		auto& entry = entries[chunk];
+		const auto triangleCount = file.Chunks()[chunk].triangleCount;
+
+		if (entry.gpuSlot == None)
+		{
+			if (!entry.requested)
+			{
+				entry.requested = true;
+				counters.requests++;
+				if (entry.loaded)
+					counters.hits++;
+				else
+					counters.misses++;
+			}
+
+			if (!entry.loaded)
+			{
+				if (!entry.loading)
+					RequestLoad(chunk);
+			}
+			else if (uploads.size() < options.maxUploadsPerFrame)
+			{
+				const auto slot = AcquireSlot();
+				if (slot != None)
+				{
+					slotChunks[slot] = chunk;
+					entry.gpuSlot = slot;
+					entry.requested = false;
+					uploads.push_back({ chunk, slot, static_cast<const TriangleWithNormal*>(cache.Data(entry.cpu)), triangleCount });
+					counters.uploads++;
+					counters.uploadBytes += triangleCount * sizeof(TriangleWithNormal);
+				}
+			}
+		}
+
+		if (entry.gpuSlot != None)
+			draws.push_back({ entry.gpuSlot, triangleCount });
+	}
+
+	// Lecture anticipée des suivants, sans reprendre les blocs des morceaux voulus
+	for (size_t r = wanted; r < considered; r++)
+	{
+		const auto chunk = order[r].second;
+		const auto& entry = entries[chunk];
+		if (entry.gpuSlot == None && !entry.loaded && !entry.loading)
+			RequestLoad(chunk);
+	}
+
+	counters.wanted = wanted;
+	counters.drawn = draws.size();
+}
+
+bool ChunkStreamer::RequestLoad(uint32_t chunk)
+{
+	if (loadsInFlight >= options.maxLoadsInFlight)
+		return false;
+
+	if (cpuUsed == cpuCapacity)
+	{
+		// Le moins récemment voulu dont la copie ne sert plus ; les morceaux touchés cette frame sont en tête
+		auto victim = lruTail;
+		while (victim != None && entries[victim].pinned == frame)
+			victim = entries[victim].lruPrev;
+		if (victim == None)
+			return false;
+
+		auto& evicted = entries[victim];
+		LruRemove(victim);
+		cache.Free(evicted.cpu);
+		evicted.cpu = {};
+		evicted.loaded = false;
+		evicted.requested = false;
+		cpuUsed--;
+		counters.cpuEvictions++;
+	}
+
+	auto& entry = entries[chunk];
+	entry.cpu = cache.Allocate();
+	entry.loading = true;
+	cpuUsed++;
+	loadsInFlight++;
+	entry.job = jobs.Submit([this, chunk]() { Load(chunk); });
+	return true;
+}
+
+void ChunkStreamer::Load(uint32_t chunk)
+{
+	const auto start = std::chrono::steady_clock::now();
+	try
+	{
+		file.Read(chunk, static_cast<TriangleWithNormal*>(cache.Data(entries[chunk].cpu)));
+		bytesRead.fetch_add(file.Chunks()[chunk].triangleCount * sizeof(TriangleWithNormal), std::memory_order_relaxed);
+	}
+	catch (...)
+	{
+		std::lock_guard<std::mutex> lock(completedMutex);
+		if (!error)
+			error = std::current_exception();
+	}
+	readNanoseconds.fetch_add((uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(), std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> lock(completedMutex);
+	completed.push_back(chunk);
+}
+
+uint32_t ChunkStreamer::AcquireSlot()
+{
+	// Un emplacement libre, sinon celui du morceau voulu le moins récemment (pas cette frame)
+	uint32_t oldestSlot = None;
+	uint64_t oldest = UINT64_MAX;
+	for (uint32_t slot = 0; slot < slotChunks.size(); slot++)
+	{
+		const auto chunk = slotChunks[slot];
+		if (chunk == None)
+			return slot;
+
+		const auto lastWanted = entries[chunk].lastWanted;
+		if (lastWanted != frame && lastWanted < oldest)
+		{
+			oldest = lastWanted;
+			oldestSlot = slot;
+		}
+	}
+
+	if (oldestSlot != None)
+	{
+		entries[slotChunks[oldestSlot]].gpuSlot = None;
+		slotChunks[oldestSlot] = None;
+		counters.gpuEvictions++;
+	}
+	return oldestSlot;
+}
+
+void ChunkStreamer::LruRemove(uint32_t chunk)
+{
+	auto& entry = entries[chunk];
+	if (entry.lruPrev != None)
+		entries[entry.lruPrev].lruNext = entry.lruNext;
+	else if (lruHead == chunk)
+		lruHead = entry.lruNext;
+	else
+		return; // pas dans la liste
+
+	if (entry.lruNext != None)
+		entries[entry.lruNext].lruPrev = entry.lruPrev;
+	else
+		lruTail = entry.lruPrev;
+
+	entry.lruPrev = entry.lruNext = None;
+}
+
+void ChunkStreamer::LruPushFront(uint32_t chunk)
+{
+	auto& entry = entries[chunk];
+	entry.lruPrev = None;
+	entry.lruNext = lruHead;
+	if (lruHead != None)
+		entries[lruHead].lruPrev = chunk;
+	lruHead = chunk;
+	if (lruTail == None)
+		lruTail = chunk;
+}
+
+ChunkStreamingStats ChunkStreamer::Stats() const
+{
+	auto stats = counters;
+	stats.bytesRead = bytesRead.load(std::memory_order_relaxed);
+	stats.readSeconds = (double) readNanoseconds.load(std::memory_order_relaxed) * 1e-9;
+	stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - created).count();
+	stats.cpuResident = cpuUsed;
+	stats.cpuCapacity = cpuCapacity;
+	stats.gpuResident = (size_t) std::count_if(slotChunks.begin(), slotChunks.end(), [](uint32_t chunk) { return chunk != None; });
+	stats.loadsInFlight = loadsInFlight;
+	return stats;
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "AssetMemory.h"
+#include "ChunkedMesh.h"
+#include "JobSystem.h"
+
+struct ChunkStreamerOptions
+{
+	size_t cpuBudgetBytes = 64 * 1024 * 1024; // cache des morceaux lus, arrondi à un nombre entier de morceaux
+	size_t gpuSlots = 64;                     // morceaux dessinables à la fois
+	size_t prefetchChunks = 16;               // morceaux suivants par priorité lus à l'avance dans le cache
+	size_t maxLoadsInFlight = 4;
+	size_t maxUploadsPerFrame = 4;            // étale les envois sur plusieurs frames
+	float maxViewDistance = std::numeric_limits<float>::infinity();
+};
+
+// Envoi à faire dans l'emplacement slot du buffer GPU
+struct ChunkUpload
+{
+	uint32_t chunk;
+	uint32_t slot;
+	const TriangleWithNormal* triangles; // valide jusqu'au prochain Update
+	uint32_t triangleCount;
+};
+
+// Morceau présent sur le GPU à dessiner
+struct ChunkDraw
+{
+	uint32_t slot;
+	uint32_t triangleCount;
+};
+
+struct ChunkStreamingStats
+{
+	uint64_t requests = 0;     // morceaux demandés au cache pour un envoi, comptés une fois jusqu'à l'envoi
+	uint64_t hits = 0;         // déjà en mémoire
+	uint64_t misses = 0;       // lus sur disque
+	uint64_t bytesRead = 0;
+	double readSeconds = 0.0;  // temps passé à lire, tous threads confondus
+	double seconds = 0.0;      // depuis la création
+	uint64_t uploads = 0;
+	uint64_t uploadBytes = 0;
+	uint64_t cpuEvictions = 0;
+	uint64_t gpuEvictions = 0;
+	size_t cpuResident = 0;
+	size_t cpuCapacity = 0;    // en morceaux
+	size_t gpuResident = 0;
+	size_t loadsInFlight = 0;
+	size_t wanted = 0;         // morceaux voulus sur le GPU à la dernière frame
+	size_t drawn = 0;          // dont déjà présents
+
+	double HitRate() const { return requests > 0 ? (double) hits / (double) requests : 0.0; }
+	// Débit des lectures elles-mêmes, et débit moyen du streaming sur toute la durée
+	double ReadMBps() const { return readSeconds > 0.0 ? (double) bytesRead / (1024.0 * 1024.0) / readSeconds : 0.0; }
+	double StreamMBps() const { return seconds > 0.0 ? (double) bytesRead / (1024.0 * 1024.0) / seconds : 0.0; }
+};
+
+// Rend un maillage plus grand que la mémoire à partir d'un ChunkFile. À chaque frame, les morceaux sont classés
+// par distance à la vue ; les gpuSlots plus proches sont voulus sur le GPU, les suivants lus à l'avance.
+// Les lectures se font dans le pool de tâches vers un cache LRU de taille fixe (AssetPool) ; le buffer GPU est
+// découpé en emplacements d'un morceau, repris au morceau voulu le moins récemment.
+// Le streamer ne fait pas d'appel GL : Uploads et Draws disent quoi envoyer et quoi dessiner.
+// Avec un pool sans thread de travail, Update fait lui-même les lectures demandées à la frame précédente.
+// Passé les premières frames, Update n'alloue plus rien.
+class ChunkStreamer
+{
+public:
+	ChunkStreamer(const ChunkFile& file, const ChunkStreamerOptions& options = {}, JobSystem& jobs = JobSystem::Instance());
+	// Attend les lectures en cours
+	~ChunkStreamer();
+
+	ChunkStreamer(const ChunkStreamer&) = delete;
+	ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+	// Depuis le thread principal, une fois par frame ; viewPosition dans l'espace du maillage.
+	// Relance l'exception d'une lecture qui a échoué.
+	void Update(const glm::vec3& viewPosition);
+
+	// À envoyer avant de dessiner
+	const std::vector<ChunkUpload>& Uploads() const { return uploads; }
+	// Du plus proche au plus loin, envois de la frame compris
+	const std::vector<ChunkDraw>& Draws() const { return draws; }
+
+	size_t GpuSlots() const { return slotChunks.size(); }
+	size_t SlotTriangles() const { return file.MaxChunkTriangles(); }
+
+	ChunkStreamingStats Stats() const;
+
+private:
+	static constexpr uint32_t None = UINT32_MAX;
+
+	struct Entry
+	{
+		PoolHandle cpu;             // bloc du cache, réservé dès la demande de lecture
+		uint32_t gpuSlot = None;
+		uint32_t lruPrev = None, lruNext = None;
+		uint64_t lastWanted = 0;    // frame où le morceau était voulu sur le GPU
+		uint64_t pinned = 0;        // frame où son bloc ne peut pas être repris
+		bool loading = false;
+		bool loaded = false;
+		bool requested = false;     // demande comptée, pas encore envoyée
+		JobSystem::Handle job;
+	};
+
+	bool RequestLoad(uint32_t chunk);
+	void Load(uint32_t chunk);
+	uint32_t AcquireSlot();
+
+	void LruRemove(uint32_t chunk);
+	void LruPushFront(uint32_t chunk);
+
+	const ChunkFile& file;
+	const ChunkStreamerOptions options;
+	JobSystem& jobs;
+
+	const size_t cpuCapacity; // en morceaux
+	AssetPool cache;
+	size_t cpuUsed = 0;
+	uint32_t lruHead = None, lruTail = None;
+
+	std::vector<Entry> entries;
+	std::vector<glm::vec4> spheres;                // centre et rayon de chaque morceau
+	std::vector<std::pair<float, uint32_t>> order; // priorité (distance), morceau
+	std::vector<uint32_t> slotChunks;              // morceau de chaque emplacement GPU
+	std::vector<ChunkUpload> uploads;
+	std::vector<ChunkDraw> draws;
+	uint64_t frame = 0;
+	size_t loadsInFlight = 0;
+
+	std::mutex completedMutex; // completed, error
+	std::vector<uint32_t> completed;
+	std::vector<uint32_t> drained;
+	std::exception_ptr error;
+
+	std::atomic<uint64_t> bytesRead{ 0 };
+	std::atomic<uint64_t> readNanoseconds{ 0 };
+	ChunkStreamingStats counters;
+	const std::chrono::steady_clock::time_point created;
+};
@@ -0,0 +1,393 @@
+#include "ChunkedMesh.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <fstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "Hash.h"
+
+namespace
+{
+	// En-tête des fichiers de morceaux, suivi de chunkCount ChunkInfo puis des triangles de chaque morceau
+	struct FileHeader
+	{
+		char magic[4];
+		uint32_t formatVersion;
+		uint64_t key;
+		uint32_t chunkCount;
+		uint32_t maxChunkTriangles;
+		uint64_t triangleCount;
+	};
+
+	const char Magic[4] = { 'S', 'I', 'C', 'K' };
+	const uint32_t FormatVersion = 1;
+
+	// Facette d'un STL binaire : normale, trois sommets et attribut sur 2 octets
+	const size_t StlRecordSize = 50;
+	const size_t StlBatchTriangles = 64 * 1024;
+
+	uint64_t DataSize(uint64_t triangleCount)
+	{
+		return triangleCount * sizeof(TriangleWithNormal);
+	}
+
+	// Parcourt le STL par lots et appelle func(triangle, cross) pour chaque facette d'aire non nulle.
+	// Renvoie le nombre de facettes écartées.
+	template <typename F>
+	uint64_t ForEachStlTriangle(const std::string& path, F&& func)
+	{
+		std::ifstream file(path, std::ios::in | std::ios::binary);
+		if (!file.is_open())
+			throw std::runtime_error("Cannot open file: " + path);
+
+		// skip header
+		file.seekg(80);
+		uint32_t count = 0;
+		file.read((char*) &count, 4);
+		if (!file)
+			throw std::runtime_error("Truncated STL file: " + path);
+
+		std::vector<char> batch(StlBatchTriangles * StlRecordSize);
+		uint64_t degenerate = 0;
+		for (uint64_t done = 0; done < count;)
+		{
+			const auto n = (size_t) std::min<uint64_t>(StlBatchTriangles, count - done);
+			file.read(batch.data(), n * StlRecordSize);
+			if (!file)
+				throw std::runtime_error("Truncated STL file: " + path);
+
+			for (size_t i = 0; i < n; i++)
+			{
+				// skip normal
+				Triangle t;
+				std::memcpy(&t, batch.data() + i * StlRecordSize + 3 * 4, sizeof(Triangle));
+
+				// Même normale que CreateTriangleWithNormals : NaN pour une aire nulle
+				const auto cross = glm::cross(t.p0 - t.p1, t.p0 - t.p2);
+				const auto area2 = glm::dot(cross, cross);
+				if (!(area2 > 0.0f) || !std::isfinite(area2))
+				{
+					degenerate++;
+					continue;
+				}
+				func(t, cross);
+			}
+			done += n;
+		}
+		return degenerate;
+	}
+
+	// Grille régulière de cellules cubiques sur la boîte englobante
+	struct Grid
+	{
+		glm::vec3 origin;
+		float cellSize;
+		uint32_t dims[3];
+
+		uint32_t CellCount() const { return dims[0] * dims[1] * dims[2]; }
+
+		uint32_t CellOf(const Triangle& t) const
+		{
+			const auto center = (t.p0 + t.p1 + t.p2) / 3.0f;
+			uint32_t cell[3];
+			for (int a = 0; a < 3; a++)
+			{
+				const auto i = std::floor((center[a] - origin[a]) / cellSize);
+				cell[a] = (uint32_t) std::clamp(i, 0.0f, (float) (dims[a] - 1));
+			}
+			return (cell[2] * dims[1] + cell[1]) * dims[0] + cell[0];
+		}
+	};
+
+	void Translate(Triangle& t, const glm::vec3& offset)
+	{
+		t.p0 -= offset;
+		t.p1 -= offset;
+		t.p2 -= offset;
+	}
+
+	bool ReadHeader(std::ifstream& file, FileHeader& header, uint64_t key)
+	{
+		file.read((char*) &header, sizeof(header));
+		return file && std::memcmp(header.magic, Magic, sizeof(Magic)) == 0 && header.formatVersion == FormatVersion && header.key == key;
+	}
+}
+
+uint64_t MakeChunkFileKey(const std::string& stlPath, const ChunkBuildOptions& options)
+{
+	std::error_code error;
+	const uint64_t size = std::filesystem::file_size(stlPath, error);
+	const int64_t time = std::filesystem::last_write_time(stlPath, error).time_since_epoch().count();
+
+	auto h = Fnv1a(FnvOffset, &FormatVersion, sizeof(FormatVersion));
+	h = Fnv1a(h, stlPath.data(), stlPath.size());
+	h = Fnv1a(h, &size, sizeof(size));
+	h = Fnv1a(h, &time, sizeof(time));
+	h = Fnv1a(h, &options.gridResolution, sizeof(options.gridResolution));
+	h = Fnv1a(h, &options.maxChunkTriangles, sizeof(options.maxChunkTriangles));
+	h = Fnv1a(h, &options.center, sizeof(options.center));
+	return h;
+}
+
+std::string ChunkFilePath(const std::string& directory, uint64_t key)
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.chk", (unsigned long long) key);
+	return (std::filesystem::path(directory) / name).string();
+}
+
+ChunkBuildReport BuildChunkFile(const std::string& stlPath, const std::string& chunkPath, uint64_t key, const ChunkBuildOptions& options)
+{
+	const auto start = std::chrono::steady_clock::now();
+	ChunkBuildReport report;
+
+	// 1. Boîte englobante et centre de gravité des sommets
+	double sum[3] = { 0.0, 0.0, 0.0 };
+	glm::vec3 boundsMin(std::numeric_limits<float>::max()), boundsMax(-std::numeric_limits<float>::max());
+	report.degenerate = ForEachStlTriangle(stlPath, [&](const Triangle& t, const glm::vec3&)
+	{
+		for (const auto& p : { t.p0, t.p1, t.p2 })
+		{
+			for (int a = 0; a < 3; a++)
+				sum[a] += p[a];
+			boundsMin = glm::min(boundsMin, p);
+			boundsMax = glm::max(boundsMax, p);
+		}
+		report.triangles++;
+	});
+	if (report.triangles == 0)
+		throw std::runtime_error("No triangle to chunk in " + stlPath);
+
+	const auto vertexCount = 3.0 * (double) report.triangles;
+	const auto offset = options.center ? glm::vec3((float) (sum[0] / vertexCount), (float) (sum[1] / vertexCount), (float) (sum[2] / vertexCount)) : glm::vec3(0.0f);
+	boundsMin -= offset;
+	boundsMax -= offset;
+
+	Grid grid;
+	const auto extent = boundsMax - boundsMin;
+	const auto resolution = std::max<uint32_t>(1, options.gridResolution);
+	grid.origin = boundsMin;
+	grid.cellSize = std::max(std::max(extent.x, extent.y), extent.z) / (float) resolution;
+	if (!(grid.cellSize > 0.0f))
+		grid.cellSize = 1.0f;
+	for (int a = 0; a < 3; a++)
+		grid.dims[a] = std::clamp((uint32_t) std::ceil(extent[a] / grid.cellSize), 1u, resolution);
+
+	// 2. Triangles par cellule, puis place de chaque cellule dans le fichier et découpage en morceaux
+	std::vector<uint64_t> cellCounts(grid.CellCount(), 0);
+	ForEachStlTriangle(stlPath, [&](Triangle t, const glm::vec3&)
+	{
+		Translate(t, offset);
+		cellCounts[grid.CellOf(t)]++;
+	});
+
+	const auto maxChunkTriangles = std::max<uint32_t>(1, options.maxChunkTriangles);
+	std::vector<ChunkInfo> chunks;
+	std::vector<uint64_t> cellStarts(grid.CellCount(), 0);
+	std::vector<uint32_t> cellChunks(grid.CellCount(), 0);
+	uint64_t first = 0;
+	for (uint32_t cell = 0; cell < grid.CellCount(); cell++)
+	{
+		const auto count = cellCounts[cell];
+		if (count == 0)
+			continue;
+
+		report.cells++;
+		cellStarts[cell] = first;
+		cellChunks[cell] = (uint32_t) chunks.size();
+		for (uint64_t piece = 0; piece < count; piece += maxChunkTriangles)
+		{
+			ChunkInfo chunk;
+			chunk.boundsMin = glm::vec3(std::numeric_limits<float>::max());
+			chunk.boundsMax = glm::vec3(-std::numeric_limits<float>::max());
+			chunk.firstTriangle = first + piece;
+			chunk.triangleCount = (uint32_t) std::min<uint64_t>(maxChunkTriangles, count - piece);
+			chunks.push_back(chunk);
+		}
+		first += count;
+	}
+
+	// 3. Écriture de chaque triangle à sa place, par paquets d'une même cellule
+	std::error_code error;
+	std::filesystem::create_directories(std::filesystem::path(chunkPath).parent_path(), error);
+
+	const auto temporary = chunkPath + ".tmp";
+	const auto dataOffset = sizeof(FileHeader) + chunks.size() * sizeof(ChunkInfo);
+	{
+		std::ofstream create(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!create.is_open())
+			throw std::runtime_error("Cannot create chunk file: " + temporary);
+	}
+	std::filesystem::resize_file(temporary, dataOffset + DataSize(report.triangles));
+
+	{
+		std::fstream file(temporary, std::ios::in | std::ios::out | std::ios::binary);
+		if (!file.is_open())
+			throw std::runtime_error("Cannot open chunk file: " + temporary);
+
+		std::vector<uint64_t> cellFills(grid.CellCount(), 0);
+		std::vector<uint64_t> cellWritten(grid.CellCount(), 0);
+		std::vector<TriangleWithNormalList> cellBuffers(grid.CellCount());
+		const auto bufferTriangles = std::max<uint32_t>(1, options.cellBufferTriangles);
+
+		const auto flush = [&](uint32_t cell)
+		{
+			auto& buffer = cellBuffers[cell];
+			file.seekp((std::streamoff) (dataOffset + DataSize(cellStarts[cell] + cellWritten[cell])));
+			file.write((const char*) buffer.data(), (std::streamsize) DataSize(buffer.size()));
+			cellWritten[cell] += buffer.size();
+			buffer.clear();
+		};
+
+		ForEachStlTriangle(stlPath, [&](Triangle t, const glm::vec3& cross)
+		{
+			Translate(t, offset);
+			const auto cell = grid.CellOf(t);
+			auto& chunk = chunks[cellChunks[cell] + cellFills[cell]++ / maxChunkTriangles];
+			for (const auto& p : { t.p0, t.p1, t.p2 })
+			{
+				chunk.boundsMin = glm::min(chunk.boundsMin, p);
+				chunk.boundsMax = glm::max(chunk.boundsMax, p);
+			}
+
+			auto& buffer = cellBuffers[cell];
+			if (buffer.capacity() == 0)
+				buffer.reserve(bufferTriangles);
+			const auto n = glm::normalize(cross);
+			buffer.push_back({ t.p0, n, t.p1, n, t.p2, n });
+			if (buffer.size() == bufferTriangles)
+				flush(cell);
+		});
+
+		for (uint32_t cell = 0; cell < grid.CellCount(); cell++)
+		{
+			if (!cellBuffers[cell].empty())
+				flush(cell);
+		}
+
+		FileHeader header;
+		std::memcpy(header.magic, Magic, sizeof(Magic));
+		header.formatVersion = FormatVersion;
+		header.key = key;
+		header.chunkCount = (uint32_t) chunks.size();
+		header.maxChunkTriangles = maxChunkTriangles;
+		header.triangleCount = report.triangles;
+
+		file.seekp(0);
+		file.write((const char*) &header, sizeof(header));
+		file.write((const char*) chunks.data(), (std::streamsize) (chunks.size() * sizeof(ChunkInfo)));
+		if (!file)
+			throw std::runtime_error("Cannot write chunk file: " + temporary);
+	}
+
+	// Renommage à la fin : un lecteur ne voit jamais de fichier à moitié écrit
+	std::filesystem::rename(temporary, chunkPath, error);
+	if (error)
+		throw std::runtime_error("Cannot write chunk file: " + chunkPath);
+
+	report.chunks = (uint32_t) chunks.size();
+	report.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return report;
+}
+
+ChunkFile::ChunkFile(const std::string& path, uint64_t key)
+{
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		throw std::runtime_error("Cannot open chunk file: " + path);
+
+	FileHeader header;
+	if (!ReadHeader(file, header, key))
+		throw std::runtime_error("Invalid chunk file: " + path);
+
+	chunks.resize(header.chunkCount);
+	file.read((char*) chunks.data(), (std::streamsize) (chunks.size() * sizeof(ChunkInfo)));
+	if (!file)
+		throw std::runtime_error("Truncated chunk file: " + path);
+
+	maxChunkTriangles = header.maxChunkTriangles;
+	triangleCount = header.triangleCount;
+	dataOffset = sizeof(FileHeader) + chunks.size() * sizeof(ChunkInfo);
+
+	std::error_code error;
+	if (std::filesystem::file_size(path, error) != dataOffset + DataSize(triangleCount))
+		throw std::runtime_error("Truncated chunk file: " + path);
+
+	// Les triangles sont lus par un second descripteur, en lecture positionnelle
+#if defined(_WIN32)
+	const auto h = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (h == INVALID_HANDLE_VALUE)
+		throw std::runtime_error("Cannot open chunk file: " + path);
+	handle = (intptr_t) h;
+#else
+	handle = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+	if (handle < 0)
+		throw std::runtime_error("Cannot open chunk file: " + path);
+#endif
+}
+
+ChunkFile::~ChunkFile()
+{
+#if defined(_WIN32)
+	CloseHandle((HANDLE) handle);
+#else
+	::close((int) handle);
+#endif
+}
+
+bool ChunkFile::Matches(const std::string& path, uint64_t key)
+{
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	FileHeader header;
+	if (!file.is_open() || !ReadHeader(file, header, key))
+		return false;
+
+	std::error_code error;
+	return std::filesystem::file_size(path, error) == sizeof(FileHeader) + header.chunkCount * sizeof(ChunkInfo) + DataSize(header.triangleCount);
+}
+
+void ChunkFile::Read(uint32_t chunk, TriangleWithNormal* out) const
+{
+	const auto& info = chunks.at(chunk);
+	auto offset = dataOffset + DataSize(info.firstTriangle);
+	auto remaining = DataSize(info.triangleCount);
+	auto bytes = (char*) out;
+
+	// Une lecture peut rendre moins que demandé : on boucle jusqu'au bout du morceau
+	while (remaining > 0)
+	{
+#if defined(_WIN32)
+		OVERLAPPED position = {};
+		position.Offset = (DWORD) offset;
+		position.OffsetHigh = (DWORD) (offset >> 32);
+		DWORD read = 0;
+		const auto request = (DWORD) std::min<uint64_t>(remaining, 1u << 30);
+		if (!ReadFile((HANDLE) handle, bytes, request, &read, &position) || read == 0)
+			throw std::runtime_error("Cannot read chunk " + std::to_string(chunk));
+#else
+		const auto read = ::pread((int) handle, bytes, (size_t) remaining, (off_t) offset);
+		if (read < 0 && errno == EINTR)
+			continue;
+		if (read <= 0)
+			throw std::runtime_error("Cannot read chunk " + std::to_string(chunk));
+#endif
+		offset += (uint64_t) read;
+		remaining -= (uint64_t) read;
+		bytes += read;
+	}
+}
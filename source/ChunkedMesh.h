@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Triangle.h"
+
+// Morceau d'un maillage découpé : triangles contigus dans le fichier, boîte englobante de leurs sommets
+struct ChunkInfo
+{
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+	uint64_t firstTriangle;
+	uint32_t triangleCount;
+
+	glm::vec3 Center() const { return 0.5f * (boundsMin + boundsMax); }
+	float Radius() const { return 0.5f * glm::length(boundsMax - boundsMin); }
+};
+
+struct ChunkBuildOptions
+{
+	uint32_t gridResolution = 8;          // cellules sur le plus grand axe de la boîte englobante
+	uint32_t maxChunkTriangles = 8192;    // une cellule plus grosse est coupée en plusieurs morceaux
+	uint32_t cellBufferTriangles = 256;   // triangles gardés par cellule avant écriture
+	bool center = true;                   // recentre sur le centre de gravité, comme CenterAllVertex
+};
+
+struct ChunkBuildReport
+{
+	uint64_t triangles = 0;
+	uint64_t degenerate = 0; // aire nulle : écartés, leur normale serait NaN
+	uint32_t cells = 0;      // cellules non vides
+	uint32_t chunks = 0;
+	double ms = 0.0;
+};
+
+// Clé du fichier de morceaux d'un STL : chemin, taille, date de modification et options du découpage
+uint64_t MakeChunkFileKey(const std::string& stlPath, const ChunkBuildOptions& options);
+std::string ChunkFilePath(const std::string& directory, uint64_t key);
+
+// Découpe un STL binaire en morceaux sur disque sans le charger en entier : trois lectures par lots (boîte
+// englobante, comptage par cellule d'une grille régulière, écriture de chaque triangle à sa place) et une mémoire
+// bornée par la grille et les tampons des cellules. Les triangles sont rangés par centre dans leur cellule et
+// écrits avec leur normale, prêts à être envoyés tels quels. Écrit dans un fichier temporaire puis renommé.
+ChunkBuildReport BuildChunkFile(const std::string& stlPath, const std::string& chunkPath, uint64_t key, const ChunkBuildOptions& options = {});
+
+// Fichier de morceaux ouvert en lecture : la table est en mémoire, les triangles restent sur disque
+class ChunkFile
+{
+public:
+	// Lève std::runtime_error si le fichier manque, est tronqué ou ne correspond pas à key
+	ChunkFile(const std::string& path, uint64_t key);
+	~ChunkFile();
+
+	ChunkFile(const ChunkFile&) = delete;
+	ChunkFile& operator=(const ChunkFile&) = delete;
+
+	// Vrai si le fichier existe et a été construit pour key
+	static bool Matches(const std::string& path, uint64_t key);
+
+	const std::vector<ChunkInfo>& Chunks() const { return chunks; }
+	uint32_t MaxChunkTriangles() const { return maxChunkTriangles; }
+	uint64_t TriangleCount() const { return triangleCount; }
+
+	// Lit les triangles du morceau dans out (au moins triangleCount places). Thread-safe et sans verrou : lecture
+	// positionnelle (pread, ReadFile avec offset) qui ne partage pas de position de fichier, plusieurs lectures
+	// peuvent être en cours à la fois.
+	void Read(uint32_t chunk, TriangleWithNormal* out) const;
+
+private:
+	std::vector<ChunkInfo> chunks;
+	uint32_t maxChunkTriangles = 0;
+	uint64_t triangleCount = 0;
+	uint64_t dataOffset = 0;
+
+	intptr_t handle = -1; // descripteur POSIX ou HANDLE Windows
+};
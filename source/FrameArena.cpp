@@ -0,0 +1,127 @@
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+	std::atomic<uint64_t> nextArenaId{ 1 };
+
+	// Dernière sous-arène servie à ce thread : évite le verrou après le premier appel de la frame
+	struct ThreadArenaCache
+	{
+		uint64_t arena = 0;
+		uint64_t frame = 0;
+		LinearArena* local = nullptr;
+	};
+
+	thread_local ThreadArenaCache threadCache;
+}
+
+LinearArena::LinearArena(size_t blockSize)
+	: blockSize(std::max<size_t>(blockSize, 64))
+{
+}
+
+void* LinearArena::Allocate(size_t size, size_t alignment)
+{
+	if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+		throw std::invalid_argument("LinearArena: alignment must be a power of two");
+
+	for (; current < blocks.size(); current++, offset = 0)
+	{
+		auto& block = blocks[current];
+		const auto base = reinterpret_cast<uintptr_t>(block.memory.get());
+		const auto aligned = (base + offset + alignment - 1) & ~(uintptr_t) (alignment - 1);
+		const auto end = aligned - base + size;
+		if (end <= block.size)
+		{
+			used += end - offset;
+			offset = end;
+			return reinterpret_cast<void*>(aligned);
+		}
+	}
+
+	// Aucun bloc restant ne convient : un nouveau, assez grand pour la demande et son alignement
+	const auto newSize = std::max(blockSize, size + alignment);
+	blocks.push_back({ std::make_unique<std::byte[]>(newSize), newSize });
+	capacity += newSize;
+	current = blocks.size() - 1;
+	offset = 0;
+	return Allocate(size, alignment);
+}
+
+void LinearArena::Reset()
+{
+	current = 0;
+	offset = 0;
+	used = 0;
+}
+
+FrameArena::FrameArena(size_t blockSize, size_t frameCount)
+	: id(nextArenaId++), blockSize(blockSize), sections(std::max<size_t>(1, frameCount))
+{
+}
+
+size_t FrameArena::SectionBytes(const Section& section) const
+{
+	size_t bytes = 0;
+	for (const auto& arena : section.arenas)
+		bytes += arena.second->Used();
+	return bytes;
+}
+
+void FrameArena::BeginFrame()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	const auto previous = frame.load(std::memory_order_relaxed);
+	lastFrameBytes = SectionBytes(sections[previous % sections.size()]);
+	peakFrameBytes = std::max(peakFrameBytes, lastFrameBytes);
+
+	// Les caches des threads pointent sur l'ancienne frame : ils repasseront par le verrou
+	const auto next = previous + 1;
+	for (auto& arena : sections[next % sections.size()].arenas)
+		arena.second->Reset();
+	frame.store(next, std::memory_order_release);
+}
+
+LinearArena& FrameArena::ThreadArena()
+{
+	const auto current = frame.load(std::memory_order_acquire);
+	if (threadCache.arena == id && threadCache.frame == current)
+		return *threadCache.local;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	auto& arenas = sections[current % sections.size()].arenas;
+	const auto thread = std::this_thread::get_id();
+	auto found = std::find_if(arenas.begin(), arenas.end(), [&](const auto& arena) { return arena.first == thread; });
+	if (found == arenas.end())
+	{
+		arenas.emplace_back(thread, std::make_unique<LinearArena>(blockSize));
+		found = arenas.end() - 1;
+	}
+
+	threadCache = { id, current, found->second.get() };
+	return *found->second;
+}
+
+FrameArenaStats FrameArena::Stats() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	FrameArenaStats stats;
+	stats.frames = frame.load(std::memory_order_relaxed);
+	stats.frameBytes = lastFrameBytes;
+	stats.peakFrameBytes = peakFrameBytes;
+	for (const auto& section : sections)
+	{
+		for (const auto& arena : section.arenas)
+		{
+			stats.capacity += arena.second->Capacity();
+			stats.blockAllocations += arena.second->BlockAllocations();
+			stats.threadArenas++;
+		}
+	}
+	return stats;
+}
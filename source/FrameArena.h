@@ -0,0 +1,135 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Allocateur linéaire : chaque allocation avance un curseur, rien n'est libéré avant Reset. La mémoire vient de blocs
+// gardés d'un Reset à l'autre : une fois atteinte la taille de travail, plus aucune allocation sur le tas.
+// Un seul thread à la fois.
+class LinearArena
+{
+public:
+	explicit LinearArena(size_t blockSize = 64 * 1024);
+
+	LinearArena(const LinearArena&) = delete;
+	LinearArena& operator=(const LinearArena&) = delete;
+
+	// alignment : puissance de deux
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+	void Reset();
+
+	size_t Used() const { return used; }
+	size_t Capacity() const { return capacity; }
+	size_t BlockAllocations() const { return blocks.size(); }
+
+private:
+	struct Block
+	{
+		std::unique_ptr<std::byte[]> memory;
+		size_t size;
+	};
+
+	std::vector<Block> blocks;
+	size_t blockSize;
+	size_t current = 0; // bloc en cours de remplissage
+	size_t offset = 0;  // dans ce bloc
+	size_t used = 0;    // octets demandés depuis Reset, alignement compris
+	size_t capacity = 0;
+};
+
+struct FrameArenaStats
+{
+	uint64_t frames = 0;
+	size_t frameBytes = 0;     // utilisés par la dernière frame terminée, tous threads confondus
+	size_t peakFrameBytes = 0;
+	size_t capacity = 0;       // toutes sections et tous threads
+	size_t blockAllocations = 0;
+	size_t threadArenas = 0;
+};
+
+// Mémoire temporaire de la frame : une section par frame en vol, et dans chaque section une sous-arène par thread,
+// sans verrou à l'allocation. BeginFrame recycle la plus ancienne section : ce qui a été alloué pendant une frame
+// reste valide pendant les frameCount - 1 frames suivantes (données lues par un autre thread ou par le GPU).
+class FrameArena
+{
+public:
+	explicit FrameArena(size_t blockSize = 256 * 1024, size_t frameCount = 2);
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// Aucun thread ne doit allouer dans l'arène pendant l'appel
+	void BeginFrame();
+
+	// Sous-arène du thread appelant dans la section courante, créée à sa première utilisation
+	LinearArena& ThreadArena();
+
+	size_t FrameCount() const { return sections.size(); }
+	// Comme BeginFrame, entre deux frames
+	FrameArenaStats Stats() const;
+
+private:
+	struct Section
+	{
+		std::vector<std::pair<std::thread::id, std::unique_ptr<LinearArena>>> arenas;
+	};
+
+	size_t SectionBytes(const Section& section) const;
+
+	const uint64_t id; // identifie l'arène dans le cache du thread, même si une autre prend son adresse
+	const size_t blockSize;
+	std::vector<Section> sections;
+	std::atomic<uint64_t> frame{ 0 };
+
+	mutable std::mutex mutex; // sections[...].arenas
+	size_t lastFrameBytes = 0;
+	size_t peakFrameBytes = 0;
+};
+
+// Allocateur STL sur une LinearArena : deallocate ne fait rien, la mémoire revient au Reset de l'arène.
+// Sans arène, repli sur operator new / delete.
+template <typename T>
+class ArenaAllocator
+{
+public:
+	using value_type = T;
+
+	ArenaAllocator(LinearArena* arena = nullptr) noexcept : arena(arena) {}
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(other.Arena()) {}
+
+	T* allocate(size_t n)
+	{
+		if (n > (size_t) -1 / sizeof(T))
+			throw std::bad_array_new_length();
+		if (!arena)
+			return static_cast<T*>(::operator new(n * sizeof(T)));
+		return static_cast<T*>(arena->Allocate(n * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* p, size_t) noexcept
+	{
+		if (!arena)
+			::operator delete(p);
+	}
+
+	LinearArena* Arena() const { return arena; }
+
+	template <typename U>
+	bool operator==(const ArenaAllocator<U>& other) const { return arena == other.Arena(); }
+	template <typename U>
+	bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.Arena(); }
+
+private:
+	LinearArena* arena;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
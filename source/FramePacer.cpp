@@ -0,0 +1,212 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+	double ToMs(std::chrono::steady_clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	// Marge de sécurité ajoutée à la durée prévue d'une frame en JustInTime
+	const auto JustInTimeSafety = std::chrono::microseconds(500);
+}
+
+const char* ToString(PresentMode mode)
+{
+	switch (mode)
+	{
+	case PresentMode::Vsync: return "vsync";
+	case PresentMode::Uncapped: return "uncapped";
+	case PresentMode::Limited: return "limited";
+	case PresentMode::JustInTime: return "just-in-time";
+	}
+	return "unknown";
+}
+
+void FrameTimeHistogram::Add(double ms)
+{
+	const auto bin = (size_t) std::max(0.0, ms / BinMs);
+	if (bin < BinCount)
+		bins[bin]++;
+	else
+	{
+		overflowCount++;
+		overflowSumMs += ms;
+	}
+	count++;
+	sumMs += ms;
+	maxMs = std::max(maxMs, ms);
+}
+
+void FrameTimeHistogram::Clear()
+{
+	*this = FrameTimeHistogram();
+}
+
+double FrameTimeHistogram::PercentileMs(double p) const
+{
+	if (count == 0)
+		return 0.0;
+
+	const auto rank = (uint64_t) std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * (double) count);
+	uint64_t seen = 0;
+	for (size_t i = 0; i < BinCount; i++)
+	{
+		seen += bins[i];
+		if (seen >= rank && seen > 0)
+			return (double) (i + 1) * BinMs;
+	}
+	return maxMs;
+}
+
+double FrameTimeHistogram::WorstAverageMs(double fraction) const
+{
+	if (count == 0)
+		return 0.0;
+
+	// Au moins une frame : avec peu de frames, le 0.1 % low est la pire frame
+	const auto wanted = std::max<uint64_t>(1, (uint64_t) std::ceil(fraction * (double) count));
+
+	auto taken = std::min(wanted, overflowCount);
+	auto sum = overflowCount > 0 ? overflowSumMs / (double) overflowCount * (double) taken : 0.0;
+	for (size_t i = BinCount; i-- > 0 && taken < wanted;)
+	{
+		const auto n = std::min<uint64_t>(bins[i], wanted - taken);
+		sum += (double) n * ((double) i + 0.5) * BinMs;
+		taken += n;
+	}
+	return sum / (double) taken;
+}
+
+std::vector<std::string> FrameTimeHistogram::Lines(double bucketMs, int barWidth) const
+{
+	std::vector<std::string> lines;
+	if (count == 0)
+		return lines;
+
+	const auto binsPerBucket = std::max<size_t>(1, (size_t) std::lround(bucketMs / BinMs));
+	const auto bucketCount = (BinCount + binsPerBucket - 1) / binsPerBucket;
+
+	std::vector<uint64_t> buckets(bucketCount + 1, 0);
+	for (size_t i = 0; i < BinCount; i++)
+		buckets[i / binsPerBucket] += bins[i];
+	buckets[bucketCount] = overflowCount;
+
+	const auto largest = *std::max_element(buckets.begin(), buckets.end());
+	for (size_t b = 0; b < buckets.size(); b++)
+	{
+		if (buckets[b] == 0)
+			continue;
+
+		std::ostringstream line;
+		if (b < bucketCount)
+			line << (double) (b * binsPerBucket) * BinMs << "-" << (double) ((b + 1) * binsPerBucket) * BinMs << " ms";
+		else
+			line << ">= " << (double) BinCount * BinMs << " ms";
+		line << " : " << buckets[b] << " " << std::string((size_t) std::ceil((double) barWidth * (double) buckets[b] / (double) largest), '#');
+		lines.push_back(line.str());
+	}
+	return lines;
+}
+
+FramePacer::FramePacer(PresentMode mode, double targetFps)
+	: mode(mode), period(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / std::max(1.0, targetFps))))
+{
+}
+
+int FramePacer::SwapInterval() const
+{
+	return mode == PresentMode::Vsync || mode == PresentMode::JustInTime ? 1 : 0;
+}
+
+void FramePacer::BeginFrame()
+{
+	const auto now = Clock::now();
+	if (!started)
+	{
+		nextDeadline = now;
+		lastPresent = now;
+	}
+	else if (mode == PresentMode::Limited)
+	{
+		WaitUntil(nextDeadline);
+	}
+	else if (mode == PresentMode::JustInTime)
+	{
+		// Le swap rend la main au retour vertical suivant : on commence juste assez tôt pour finir avant lui
+		const auto predicted = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(predictedWorkMs));
+		nextDeadline = lastPresent + period - predicted - JustInTimeSafety;
+		WaitUntil(nextDeadline);
+	}
+
+	frameStart = Clock::now();
+	if (started && (mode == PresentMode::Limited || mode == PresentMode::JustInTime) && frameStart - nextDeadline > sleepMargin)
+		missedDeadlines++;
+}
+
+void FramePacer::EndFrame(Clock::time_point submitted, Clock::time_point presented)
+{
+	if (started)
+		histogram.Add(ToMs(presented - lastPresent));
+	started = true;
+	lastPresent = presented;
+
+	// Prévision prudente : monte aussitôt sur une frame plus longue, redescend lentement
+	const auto workMs = ToMs(submitted - frameStart);
+	predictedWorkMs = std::max(workMs, predictedWorkMs * 0.95 + workMs * 0.05);
+
+	if (mode == PresentMode::Limited)
+	{
+		// Après un accroc la cadence repart de maintenant au lieu d'enchaîner les frames en retard
+		nextDeadline += period;
+		if (nextDeadline < presented)
+			nextDeadline = presented;
+	}
+}
+
+void FramePacer::WaitUntil(Clock::time_point deadline)
+{
+	for (;;)
+	{
+		const auto now = Clock::now();
+		const auto remaining = deadline - now;
+		if (remaining <= Clock::duration::zero())
+			return;
+
+		if (remaining > sleepMargin)
+		{
+			// La marge suit le pire retard de réveil observé et diminue doucement quand l'OS redevient précis
+			const auto requested = remaining - sleepMargin;
+			std::this_thread::sleep_for(requested);
+			const auto overslept = Clock::now() - now - requested;
+			sleepMargin = std::clamp<Clock::duration>(std::max<Clock::duration>(overslept + overslept / 4, sleepMargin * 63 / 64),
+				std::chrono::microseconds(100), std::chrono::milliseconds(4));
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+FramePacingStats FramePacer::Stats() const
+{
+	FramePacingStats stats;
+	stats.frames = histogram.Count();
+	stats.meanMs = histogram.MeanMs();
+	stats.p99Ms = histogram.PercentileMs(99.0);
+	stats.maxMs = histogram.MaxMs();
+	const auto low1 = histogram.WorstAverageMs(0.01);
+	const auto low01 = histogram.WorstAverageMs(0.001);
+	stats.low1Fps = low1 > 0.0 ? 1000.0 / low1 : 0.0;
+	stats.low01Fps = low01 > 0.0 ? 1000.0 / low01 : 0.0;
+	stats.missedDeadlines = missedDeadlines;
+	stats.sleepMarginMs = ToMs(sleepMargin);
+	stats.predictedWorkMs = predictedWorkMs;
+	return stats;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum class PresentMode
+{
+	Vsync,     // swap interval 1, rien d'autre
+	Uncapped,  // swap interval 0, aussi vite que possible
+	Limited,   // swap interval 0, cadence fixe : sommeil puis attente active jusqu'à l'échéance
+	JustInTime // swap interval 1, début de frame (entrées, état simulé) retardé au plus tard avant le prochain retour du swap
+};
+
+const char* ToString(PresentMode mode);
+
+// Histogramme des durées de frame par pas de 0.1 ms jusqu'à 250 ms, sans allocation après la construction
+class FrameTimeHistogram
+{
+public:
+	static constexpr double BinMs = 0.1;
+	static constexpr size_t BinCount = 2500;
+
+	void Add(double ms);
+	void Clear();
+
+	uint64_t Count() const { return count; }
+	double MeanMs() const { return count > 0 ? sumMs / (double) count : 0.0; }
+	double MaxMs() const { return maxMs; }
+	// Durée sous laquelle se trouvent p % des frames (p dans [0, 100])
+	double PercentileMs(double p) const;
+	// Durée moyenne des fraction * Count() frames les plus longues : 1 % low = 1000 / WorstAverageMs(0.01)
+	double WorstAverageMs(double fraction) const;
+
+	// Une ligne par tranche de bucketMs non vide : borne, nombre de frames et barre proportionnelle
+	std::vector<std::string> Lines(double bucketMs = 1.0, int barWidth = 40) const;
+
+private:
+	std::array<uint32_t, BinCount> bins{};
+	uint64_t overflowCount = 0;
+	double overflowSumMs = 0.0;
+	uint64_t count = 0;
+	double sumMs = 0.0;
+	double maxMs = 0.0;
+};
+
+struct FramePacingStats
+{
+	uint64_t frames = 0;
+	double meanMs = 0.0;
+	double p99Ms = 0.0;
+	double maxMs = 0.0;
+	double low1Fps = 0.0;  // moyenne des 1 % de frames les plus lentes, en images par seconde
+	double low01Fps = 0.0; // idem pour 0.1 %
+	uint64_t missedDeadlines = 0; // frames commencées après leur échéance (Limited, JustInTime)
+	double sleepMarginMs = 0.0;   // marge d'attente active apprise sur le retard des réveils
+	double predictedWorkMs = 0.0; // durée prévue d'une frame, de BeginFrame au swap (JustInTime)
+};
+
+// Cadence des frames selon le mode de présentation. Sans dépendance à la fenêtre : le swap est passé à Present.
+//   pacer.BeginFrame();            // attente éventuelle, puis lecture des entrées et rendu
+//   ...
+//   pacer.Present([&]() { glfwSwapBuffers(window); });
+class FramePacer
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	// targetFps ne sert qu'en Limited et JustInTime (fréquence de l'écran dans ce dernier cas)
+	FramePacer(PresentMode mode, double targetFps);
+
+	PresentMode Mode() const { return mode; }
+	int SwapInterval() const;
+
+	// Attend le début de la frame : l'échéance de la cadence en Limited, le dernier moment permettant de finir
+	// la frame avant le prochain retour du swap en JustInTime. Ne fait rien dans les autres modes.
+	// En JustInTime le swap passé à Present doit bloquer jusqu'à la présentation (glFinish après le swap) :
+	// sinon l'échéance part trop tôt et la latence ajoutée n'apparaît pas dans missedDeadlines.
+	void BeginFrame();
+
+	template <typename Swap>
+	void Present(Swap&& swap)
+	{
+		const auto submitted = Clock::now();
+		swap();
+		EndFrame(submitted, Clock::now());
+	}
+
+	const FrameTimeHistogram& Histogram() const { return histogram; }
+	FramePacingStats Stats() const;
+
+private:
+	void EndFrame(Clock::time_point submitted, Clock::time_point presented);
+	// Sommeil jusqu'à deadline - sleepMargin puis attente active : le réveil de l'OS arrive souvent en retard
+	void WaitUntil(Clock::time_point deadline);
+
+	const PresentMode mode;
+	const Clock::duration period;
+
+	Clock::time_point frameStart;
+	Clock::time_point nextDeadline;
+	Clock::time_point lastPresent;
+	bool started = false;
+
+	Clock::duration sleepMargin = std::chrono::milliseconds(1);
+	double predictedWorkMs = 0.0;
+	uint64_t missedDeadlines = 0;
+
+	FrameTimeHistogram histogram;
+};
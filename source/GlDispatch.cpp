@@ -0,0 +1,18 @@
+#include <glad/glad.h>
+
+#include "GlStateCache.h"
+
+GlDispatch MakeGlDispatch()
+{
+	// Les pointeurs de glad ont la convention d'appel APIENTRY : on passe par des lambdas sans capture
+	GlDispatch dispatch;
+	dispatch.useProgram = [](uint32_t program) { glUseProgram(program); };
+	dispatch.bindTextureUnit = [](uint32_t unit, uint32_t texture) { glBindTextureUnit(unit, texture); };
+	dispatch.bindVertexArray = [](uint32_t vao) { glBindVertexArray(vao); };
+	dispatch.bindBufferRange = [](uint32_t target, uint32_t index, uint32_t buffer, ptrdiff_t offset, ptrdiff_t size) { glBindBufferRange(target, index, buffer, offset, size); };
+	dispatch.uniform1i = [](int32_t location, int32_t v) { glUniform1i(location, v); };
+	dispatch.uniform3f = [](int32_t location, float x, float y, float z) { glUniform3f(location, x, y, z); };
+	dispatch.uniform3fv = [](int32_t location, int32_t count, const float* v) { glUniform3fv(location, count, v); };
+	dispatch.uniformMatrix4fv = [](int32_t location, int32_t count, uint8_t transpose, const float* v) { glUniformMatrix4fv(location, count, transpose, v); };
+	return dispatch;
+}
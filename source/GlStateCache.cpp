@@ -0,0 +1,137 @@
+#include "GlStateCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+GlStateCache::GlStateCache(const GlDispatch& dispatch)
+	: gl(dispatch)
+{
+	Invalidate();
+}
+
+void GlStateCache::Invalidate()
+{
+	program = Unknown;
+	vao = Unknown;
+	std::fill(std::begin(textures), std::end(textures), Unknown);
+	bufferRanges.clear();
+	uniforms.clear();
+}
+
+void GlStateCache::BeginFrame()
+{
+	frame = {};
+}
+
+void GlStateCache::Count(bool issued)
+{
+	if (issued)
+	{
+		frame.issued++;
+		total.issued++;
+	}
+	else
+	{
+		frame.skipped++;
+		total.skipped++;
+	}
+}
+
+void GlStateCache::UseProgram(uint32_t p)
+{
+	const auto changed = p != program;
+	if (changed)
+	{
+		gl.useProgram(p);
+		program = p;
+	}
+	Count(changed);
+}
+
+void GlStateCache::BindTextureUnit(uint32_t unit, uint32_t texture)
+{
+	// Au-delà des unités suivies, l'appel est toujours transmis
+	const auto changed = unit >= MaxTextureUnits || textures[unit] != texture;
+	if (changed)
+	{
+		gl.bindTextureUnit(unit, texture);
+		if (unit < MaxTextureUnits)
+			textures[unit] = texture;
+	}
+	Count(changed);
+}
+
+void GlStateCache::BindVertexArray(uint32_t v)
+{
+	const auto changed = v != vao;
+	if (changed)
+	{
+		gl.bindVertexArray(v);
+		vao = v;
+	}
+	Count(changed);
+}
+
+void GlStateCache::BindBufferRange(uint32_t target, uint32_t index, uint32_t buffer, ptrdiff_t offset, ptrdiff_t size)
+{
+	const auto key = ((uint64_t) target << 32) | index;
+	const auto it = bufferRanges.find(key);
+	const auto changed = it == bufferRanges.end() || it->second.buffer != buffer || it->second.offset != offset || it->second.size != size;
+	if (changed)
+	{
+		gl.bindBufferRange(target, index, buffer, offset, size);
+		bufferRanges[key] = { buffer, offset, size };
+	}
+	Count(changed);
+}
+
+bool GlStateCache::UpdateUniform(int32_t location, const float* v, uint32_t size)
+{
+	// Location -1 : uniform absent du programme, GL ignore l'appel
+	if (location < 0 || program == Unknown)
+		return location >= 0;
+
+	auto& cached = uniforms[((uint64_t) program << 32) | (uint32_t) location];
+	if (cached.size == size && std::memcmp(cached.data, v, size * sizeof(float)) == 0)
+		return false;
+
+	cached.size = size;
+	std::memcpy(cached.data, v, size * sizeof(float));
+	return true;
+}
+
+void GlStateCache::Uniform1i(int32_t location, int32_t v)
+{
+	float bits;
+	std::memcpy(&bits, &v, sizeof(bits));
+
+	const auto changed = UpdateUniform(location, &bits, 1);
+	if (changed)
+		gl.uniform1i(location, v);
+	Count(changed);
+}
+
+void GlStateCache::Uniform3f(int32_t location, float x, float y, float z)
+{
+	const float v[] = { x, y, z };
+	const auto changed = UpdateUniform(location, v, 3);
+	if (changed)
+		gl.uniform3f(location, x, y, z);
+	Count(changed);
+}
+
+void GlStateCache::Uniform3fv(int32_t location, const float* v)
+{
+	const auto changed = UpdateUniform(location, v, 3);
+	if (changed)
+		gl.uniform3fv(location, 1, v);
+	Count(changed);
+}
+
+void GlStateCache::UniformMatrix4fv(int32_t location, const float* v)
+{
+	const auto changed = UpdateUniform(location, v, 16);
+	if (changed)
+		gl.uniformMatrix4fv(location, 1, 0, v);
+	Count(changed);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+// Fonctions GL filtrées par GlStateCache. Les types sont ceux d'OpenGL sans dépendre de glad,
+// ce qui permet de brancher des fonctions factices et d'utiliser le cache sans contexte GL.
+struct GlDispatch
+{
+	void (*useProgram)(uint32_t program);
+	void (*bindTextureUnit)(uint32_t unit, uint32_t texture);
+	void (*bindVertexArray)(uint32_t vao);
+	void (*bindBufferRange)(uint32_t target, uint32_t index, uint32_t buffer, ptrdiff_t offset, ptrdiff_t size);
+	void (*uniform1i)(int32_t location, int32_t v);
+	void (*uniform3f)(int32_t location, float x, float y, float z);
+	void (*uniform3fv)(int32_t location, int32_t count, const float* v);
+	void (*uniformMatrix4fv)(int32_t location, int32_t count, uint8_t transpose, const float* v);
+};
+
+// Table branchée sur les fonctions chargées par glad (GlDispatch.cpp)
+GlDispatch MakeGlDispatch();
+
+struct GlCallStats
+{
+	size_t issued = 0;
+	size_t skipped = 0;
+};
+
+// Suivi de l'état GL courant : un appel qui ne changerait rien n'est pas transmis au driver.
+// Les uniforms sont mémorisés par programme, comme dans OpenGL. Tout appel GL fait en dehors
+// du cache sur ces états doit être suivi d'un Invalidate().
+class GlStateCache
+{
+public:
+	explicit GlStateCache(const GlDispatch& dispatch);
+
+	void UseProgram(uint32_t program);
+	void BindTextureUnit(uint32_t unit, uint32_t texture);
+	void BindVertexArray(uint32_t vao);
+	void BindBufferRange(uint32_t target, uint32_t index, uint32_t buffer, ptrdiff_t offset, ptrdiff_t size);
+
+	// Les uniforms concernent le programme courant (glUniform*)
+	void Uniform1i(int32_t location, int32_t v);
+	void Uniform3f(int32_t location, float x, float y, float z);
+	void Uniform3fv(int32_t location, const float* v);
+	void UniformMatrix4fv(int32_t location, const float* v);
+
+	void Invalidate();
+
+	// Compteurs remis à zéro à chaque frame ; les totaux couvrent toute l'exécution
+	void BeginFrame();
+	const GlCallStats& FrameStats() const { return frame; }
+	const GlCallStats& TotalStats() const { return total; }
+
+private:
+	static constexpr uint32_t Unknown = 0xFFFFFFFFu;
+	static constexpr size_t MaxTextureUnits = 16;
+
+	struct BufferRange
+	{
+		uint32_t buffer;
+		ptrdiff_t offset, size;
+	};
+
+	struct UniformValue
+	{
+		uint32_t size = 0; // nombre de floats significatifs, 0 si inconnu
+		float data[16];
+	};
+
+	// Renvoie vrai si la valeur diffère de celle déjà envoyée (et la mémorise)
+	bool UpdateUniform(int32_t location, const float* v, uint32_t size);
+	void Count(bool issued);
+
+	GlDispatch gl;
+	uint32_t program = Unknown;
+	uint32_t vao = Unknown;
+	uint32_t textures[MaxTextureUnits];
+	std::unordered_map<uint64_t, BufferRange> bufferRanges; // (cible << 32 | index) -> plage liée
+	std::unordered_map<uint64_t, UniformValue> uniforms;     // (programme << 32 | location) -> valeur
+	GlCallStats frame, total;
+};
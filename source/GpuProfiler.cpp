@@ -0,0 +1,115 @@
+#include "GpuProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+GpuProfiler::GpuProfiler(size_t latency, size_t maxScopesPerFrame)
+	: frames(std::max<size_t>(1, latency) + 1)
+{
+	for (auto& frame : frames)
+	{
+		frame.queries.resize(maxScopesPerFrame * 2);
+		glGenQueries((GLsizei) frame.queries.size(), frame.queries.data());
+		frame.scopes.reserve(maxScopesPerFrame);
+	}
+	Calibrate();
+}
+
+GpuProfiler::~GpuProfiler()
+{
+	for (auto& frame : frames)
+		glDeleteQueries((GLsizei) frame.queries.size(), frame.queries.data());
+}
+
+void GpuProfiler::Calibrate()
+{
+	// Date GPU courante et date Profiler lues ensemble : l'écart sert à placer les mesures GPU sur la trace CPU
+	GLint64 gpuNow = 0;
+	glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+	gpuToProfilerNs = (int64_t) Profiler::Instance().Now() - gpuNow;
+}
+
+void GpuProfiler::BeginFrame()
+{
+	current = (size_t) (frameNumber % frames.size());
+	Resolve(frames[current]);
+
+	// Les horloges dérivent un peu : recalage toutes les quelques secondes
+	if (frameNumber % 600 == 599)
+		Calibrate();
+}
+
+void GpuProfiler::EndFrame()
+{
+	// Un scope resté ouvert est fermé ici pour que la frame reste lisible
+	while (!open.empty())
+		End();
+	frameNumber++;
+}
+
+void GpuProfiler::Begin(const char* name)
+{
+	auto& frame = frames[current];
+	if (frame.used + 2 > frame.queries.size())
+	{
+		open.push_back(std::numeric_limits<size_t>::max());
+		return;
+	}
+
+	const auto begin = frame.queries[frame.used++];
+	const auto end = frame.queries[frame.used++];
+	glQueryCounter(begin, GL_TIMESTAMP);
+	frame.lastIssued = begin;
+
+	open.push_back(frame.scopes.size());
+	frame.scopes.push_back({ name, (uint32_t) (open.size() - 1), begin, end });
+}
+
+void GpuProfiler::End()
+{
+	if (open.empty())
+		return;
+
+	const auto index = open.back();
+	open.pop_back();
+	if (index == std::numeric_limits<size_t>::max())
+		return;
+
+	auto& frame = frames[current];
+	glQueryCounter(frame.scopes[index].end, GL_TIMESTAMP);
+	frame.lastIssued = frame.scopes[index].end;
+}
+
+void GpuProfiler::Resolve(Frame& frame)
+{
+	if (frame.scopes.empty())
+		return;
+
+	// Les requêtes se terminent dans l'ordre d'émission : si la dernière est prête, toutes le sont
+	GLint available = 0;
+	glGetQueryObjectiv(frame.lastIssued, GL_QUERY_RESULT_AVAILABLE, &available);
+	if (available)
+	{
+		auto& profiler = Profiler::Instance();
+		GLuint64 first = std::numeric_limits<GLuint64>::max(), last = 0;
+		for (const auto& scope : frame.scopes)
+		{
+			GLuint64 begin = 0, end = 0;
+			glGetQueryObjectui64v(scope.begin, GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(scope.end, GL_QUERY_RESULT, &end);
+			first = std::min(first, begin);
+			last = std::max(last, end);
+
+			profiler.Push({ scope.name, (uint64_t) ((int64_t) begin + gpuToProfilerNs), (uint64_t) ((int64_t) end + gpuToProfilerNs), Profiler::GpuTrack, scope.depth });
+		}
+		lastFrameMs = last > first ? (last - first) / 1e6 : 0.0;
+	}
+	else
+	{
+		droppedFrames++;
+	}
+
+	frame.scopes.clear();
+	frame.used = 0;
+}
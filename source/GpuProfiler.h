@@ -0,0 +1,84 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Profiler.h"
+
+// Mesures GPU par paires de requêtes GL_TIMESTAMP, relues latency frames plus tard pour ne jamais attendre le GPU.
+// Les horodatages (contrairement à GL_TIME_ELAPSED, une seule requête active à la fois) s'emboîtent : les scopes
+// peuvent être imbriqués. Les intervalles relus sont ramenés sur l'horloge du Profiler et poussés sur Profiler::GpuTrack.
+class GpuProfiler
+{
+public:
+	explicit GpuProfiler(size_t latency = 3, size_t maxScopesPerFrame = 64);
+	~GpuProfiler();
+
+	GpuProfiler(const GpuProfiler&) = delete;
+	GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+	// Relit la frame posée latency frames plus tôt si ses résultats sont prêts, sinon l'abandonne
+	void BeginFrame();
+	void EndFrame();
+
+	// name doit vivre jusqu'à l'export, comme pour ProfileScope
+	void Begin(const char* name);
+	void End();
+
+	// Durée GPU de la dernière frame relue, du premier Begin au dernier End
+	double LastFrameMs() const { return lastFrameMs; }
+	uint64_t DroppedFrames() const { return droppedFrames; }
+
+private:
+	struct Scope
+	{
+		const char* name;
+		uint32_t depth;
+		GLuint begin, end;
+	};
+
+	struct Frame
+	{
+		std::vector<GLuint> queries;
+		std::vector<Scope> scopes;
+		size_t used = 0;
+		GLuint lastIssued = 0; // dernière requête émise, terminée après toutes les autres
+	};
+
+	void Calibrate();
+	void Resolve(Frame& frame);
+
+	std::vector<Frame> frames;
+	size_t current = 0;
+	uint64_t frameNumber = 0;
+	std::vector<size_t> open; // scopes commencés et pas encore terminés, dans la frame courante
+	int64_t gpuToProfilerNs = 0;
+	double lastFrameMs = 0.0;
+	uint64_t droppedFrames = 0;
+};
+
+// Scope GPU pour la durée de vie de l'objet ; sans profiler (nullptr) ou profiler désactivé, ne fait rien
+class GpuScope
+{
+public:
+	GpuScope(GpuProfiler* profiler, const char* name)
+		: profiler(Profiler::Enabled() ? profiler : nullptr)
+	{
+		if (this->profiler)
+			this->profiler->Begin(name);
+	}
+	~GpuScope()
+	{
+		if (profiler)
+			profiler->End();
+	}
+
+	GpuScope(const GpuScope&) = delete;
+	GpuScope& operator=(const GpuScope&) = delete;
+
+private:
+	GpuProfiler* profiler;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// FNV-1a 64 bits : clés des caches disque et sommes de contrôle, pas de résistance aux collisions voulues
+const uint64_t FnvOffset = 14695981039346656037ull;
+const uint64_t FnvPrime = 1099511628211ull;
+
+inline uint64_t Fnv1a(uint64_t h, const void* data, size_t size)
+{
+	const auto bytes = (const uint8_t*) data;
+	for (size_t i = 0; i < size; i++)
+		h = (h ^ bytes[i]) * FnvPrime;
+	return h;
+}
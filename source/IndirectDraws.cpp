@@ -0,0 +1,57 @@
+#include "IndirectDraws.h"
+
+#include "Parallel.h"
+
+static_assert(sizeof(DrawArraysIndirectCommand) == 16, "glMultiDrawArraysIndirect command layout");
+
+void BuildIndirectDraws(const Scene& scene, const std::vector<DrawRange>& meshRanges,
+	std::vector<DrawArraysIndirectCommand>& outCommands, std::vector<DrawUniforms>& outDraws, LinearArena* arena)
+{
+	const auto n = scene.Size();
+	const auto nChunks = ChunkCount(n);
+
+	// Passe 1 : visibilité et nombre de draws par tranche
+	ArenaVector<uint8_t> visible(n, arena);
+	ArenaVector<size_t> offsets(nChunks + 1, 0, arena);
+	ParallelForChunks(n, nChunks, [&](size_t chunk, size_t begin, size_t end)
+	{
+		size_t count = 0;
+		for (size_t i = begin; i < end; i++)
+		{
+			const auto mesh = scene.meshes[i];
+			visible[i] = mesh < meshRanges.size() && meshRanges[mesh].count > 0 && scene.IsVisible(i);
+			count += visible[i];
+		}
+		offsets[chunk + 1] = count;
+	});
+
+	for (size_t chunk = 0; chunk < nChunks; chunk++)
+	{
+		offsets[chunk + 1] += offsets[chunk];
+	}
+
+	// Passe 2 : commandes et données de draw au même indice, qui devient gl_DrawIDARB
+	outCommands.resize(offsets[nChunks]);
+	outDraws.resize(offsets[nChunks]);
+	ParallelForChunks(n, nChunks, [&](size_t chunk, size_t begin, size_t end)
+	{
+		auto drawId = offsets[chunk];
+		for (size_t i = begin; i < end; i++)
+		{
+			if (!visible[i])
+				continue;
+
+			const auto& range = meshRanges[scene.meshes[i]];
+			outCommands[drawId] = { range.count, 1, range.first, 0 };
+
+			auto& draw = outDraws[drawId];
+			draw.transform = scene.transforms[i];
+			draw.translate = glm::vec4(scene.translateX[i], scene.translateY[i], 0.0f, 0.0f);
+			const auto& material = scene.materials[scene.materialIndices[i]];
+			draw.albedo = glm::vec4(material.albedo, 0.0f);
+			draw.uvRect = material.uvRect;
+
+			drawId++;
+		}
+	});
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "FrameArena.h"
+#include "Scene.h"
+#include "UniformBlocks.h"
+
+// Même disposition que la structure attendue par glMultiDrawArraysIndirect
+struct DrawArraysIndirectCommand
+{
+	uint32_t count;
+	uint32_t instanceCount;
+	uint32_t first;
+	uint32_t baseInstance;
+};
+
+// Sommets d'un maillage dans le VBO partagé
+struct DrawRange
+{
+	uint32_t first, count;
+};
+
+// Génère une commande indirecte par entité visible et, au même indice, ses données de draw
+// (lues par multidraw.vert avec gl_DrawIDARB dans un buffer std430 de DrawUniforms).
+// meshRanges est indexé par identifiant de maillage. L'ordre des entités est conservé.
+// Les tableaux intermédiaires viennent de arena s'il est donné (mémoire de frame), sinon du tas.
+void BuildIndirectDraws(const Scene& scene, const std::vector<DrawRange>& meshRanges,
+	std::vector<DrawArraysIndirectCommand>& outCommands, std::vector<DrawUniforms>& outDraws, LinearArena* arena = nullptr);
@@ -0,0 +1,101 @@
+#include "InstanceBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include "Parallel.h"
+
+void BuildInstances(const Scene& scene, std::vector<InstanceData>& outInstances, std::vector<InstanceBatch>& outBatches, LinearArena* arena)
+{
+	const auto n = scene.Size();
+
+	// Un lot par maillage, dans l'ordre de première apparition
+	outBatches.clear();
+	using BatchMap = std::unordered_map<uint32_t, uint32_t, std::hash<uint32_t>, std::equal_to<uint32_t>, ArenaAllocator<std::pair<const uint32_t, uint32_t>>>;
+	BatchMap batchOf(16, std::hash<uint32_t>(), std::equal_to<uint32_t>(), arena);
+	for (auto mesh : scene.meshes)
+	{
+		if (batchOf.try_emplace(mesh, (uint32_t) outBatches.size()).second)
+			outBatches.push_back({ mesh, 0, 0 });
+	}
+
+	const auto nBatches = outBatches.size();
+	const auto nChunks = ChunkCount(n);
+
+	// Passe 1 : visibilité et nombre d'instances visibles par (tranche, lot)
+	ArenaVector<uint32_t> batchIndex(n, arena);
+	ArenaVector<uint32_t> counts(nChunks * nBatches, 0, arena);
+	ParallelForChunks(n, nChunks, [&](size_t chunk, size_t begin, size_t end)
+	{
+		auto chunkCounts = counts.data() + chunk * nBatches;
+		for (size_t i = begin; i < end; i++)
+		{
+			if (scene.IsVisible(i))
+			{
+				batchIndex[i] = batchOf.at(scene.meshes[i]);
+				chunkCounts[batchIndex[i]]++;
+			}
+			else
+			{
+				batchIndex[i] = (uint32_t) -1;
+			}
+		}
+	});
+
+	// Somme préfixe : les instances d'un lot sont contiguës, et chaque tranche écrit à la suite de la précédente
+	uint32_t offset = 0;
+	for (size_t b = 0; b < nBatches; b++)
+	{
+		outBatches[b].firstInstance = offset;
+		for (size_t chunk = 0; chunk < nChunks; chunk++)
+		{
+			const auto count = counts[chunk * nBatches + b];
+			counts[chunk * nBatches + b] = offset;
+			offset += count;
+		}
+		outBatches[b].instanceCount = offset - outBatches[b].firstInstance;
+	}
+
+	// Passe 2 : écriture des instances visibles à leur place
+	outInstances.resize(offset);
+	ParallelForChunks(n, nChunks, [&](size_t chunk, size_t begin, size_t end)
+	{
+		auto cursors = counts.data() + chunk * nBatches;
+		for (size_t i = begin; i < end; i++)
+		{
+			if (batchIndex[i] == (uint32_t) -1)
+				continue;
+
+			auto& instance = outInstances[cursors[batchIndex[i]]++];
+			instance.transform = scene.transforms[i];
+			instance.translate = glm::vec4(scene.translateX[i], scene.translateY[i], 0.0f, 0.0f);
+			const auto& material = scene.materials[scene.materialIndices[i]];
+			instance.albedo = glm::vec4(material.albedo, 1.0f);
+			instance.uvRect = material.uvRect;
+		}
+	});
+
+	// Les maillages sans aucune instance visible ne donnent pas de draw call
+	outBatches.erase(std::remove_if(outBatches.begin(), outBatches.end(), [](const InstanceBatch& b) { return b.instanceCount == 0; }), outBatches.end());
+}
+
+float BoundingRadius(const TriangleWithNormalList& triangles, const glm::mat4& transform)
+{
+	float radius2 = 0.0f;
+	const auto point = [&](const glm::vec3& p)
+	{
+		// Partie linéaire seulement : la translation de transform déplace le centre, pas le rayon
+		const auto v = glm::vec4(p, 0.0f) * transform;
+		radius2 = std::max(radius2, v.x * v.x + v.y * v.y + v.z * v.z);
+	};
+
+	for (auto&& t : triangles)
+	{
+		point(t.p0);
+		point(t.p1);
+		point(t.p2);
+	}
+
+	return std::sqrt(radius2);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "FrameArena.h"
+#include "Scene.h"
+#include "Triangle.h"
+
+// Données d'une instance, lues par instanced.vert comme attributs avec un diviseur de 1
+struct InstanceData
+{
+	glm::mat4 transform;
+	glm::vec4 translate; // xyz, w inutilisé
+	glm::vec4 albedo;    // rgb, a inutilisé
+	glm::vec4 uvRect;    // Material::uvRect
+};
+
+// Instances consécutives d'un même maillage, à dessiner en un seul glDrawArraysInstancedBaseInstance
+struct InstanceBatch
+{
+	uint32_t mesh;
+	uint32_t firstInstance;
+	uint32_t instanceCount;
+};
+
+// Construit le buffer d'instances de la scène en ne gardant que les entités visibles, regroupées par maillage.
+// Une entité est visible si sa sphère englobante (Scene::radii, après transformation) recoupe le volume de clip
+// de shader.vert. L'ordre des entités est conservé à l'intérieur de chaque maillage.
+// Les tableaux intermédiaires viennent de arena s'il est donné (mémoire de frame), sinon du tas.
+void BuildInstances(const Scene& scene, std::vector<InstanceData>& outInstances, std::vector<InstanceBatch>& outBatches, LinearArena* arena = nullptr);
+
+// Rayon de la sphère englobante centrée à l'origine du maillage, une fois transformé comme dans shader.vert
+float BoundingRadius(const TriangleWithNormalList& triangles, const glm::mat4& transform);
@@ -0,0 +1,357 @@
+#include "JobSystem.h"
+
+namespace
+{
+	// Pool et file du thread courant ; les threads extérieurs au pool n'ont pas d'entrée
+	struct ThreadSlot
+	{
+		const JobSystem* pool = nullptr;
+		size_t index = 0;
+	};
+
+	thread_local ThreadSlot currentSlot;
+}
+
+void JobSystem::WorkQueue::PushBack(Handle job)
+{
+	if (size == ring.size())
+	{
+		// Pleine : on double en remettant les tâches dans l'ordre à partir de 0
+		std::vector<Handle> larger(ring.size() * 2);
+		for (size_t i = 0; i < size; i++)
+			larger[i] = std::move(ring[(head + i) % ring.size()]);
+		ring.swap(larger);
+		head = 0;
+	}
+	ring[(head + size) % ring.size()] = std::move(job);
+	size++;
+}
+
+JobSystem::Handle JobSystem::WorkQueue::PopBack()
+{
+	size--;
+	return std::move(ring[(head + size) % ring.size()]);
+}
+
+JobSystem::Handle JobSystem::WorkQueue::PopFront()
+{
+	auto job = std::move(ring[head]);
+	head = (head + 1) % ring.size();
+	size--;
+	return job;
+}
+
+JobSystem::BlockPool::~BlockPool()
+{
+	for (auto block : blocks)
+		::operator delete(block);
+}
+
+void* JobSystem::BlockPool::Allocate(size_t size)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		// Tous les blocs ont la taille de la première demande : celle d'une tâche et de son compteur
+		if (blockSize == 0)
+			blockSize = size;
+		if (size == blockSize && !blocks.empty())
+		{
+			const auto block = blocks.back();
+			blocks.pop_back();
+			return block;
+		}
+	}
+	return ::operator new(size);
+}
+
+void JobSystem::BlockPool::Deallocate(void* block, size_t size)
+{
+	if (size == blockSize)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		blocks.push_back(block);
+		return;
+	}
+	::operator delete(block);
+}
+
+JobSystem::JobSystem(size_t threadCount)
+	: mainThread(std::this_thread::get_id())
+{
+	threadCount = std::max<size_t>(1, threadCount);
+	for (size_t i = 0; i < threadCount; i++)
+		queues.push_back(std::make_unique<WorkQueue>());
+
+	workers.reserve(threadCount - 1);
+	for (size_t i = 1; i < threadCount; i++)
+		workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		running = false;
+	}
+	wake.notify_all();
+
+	for (auto& worker : workers)
+		worker.join();
+}
+
+JobSystem& JobSystem::Instance()
+{
+	static JobSystem pool;
+	return pool;
+}
+
+JobStats JobSystem::Stats() const
+{
+	return { executed.load(std::memory_order_relaxed), stolen.load(std::memory_order_relaxed) };
+}
+
+JobSystem::Handle JobSystem::Create(std::function<void()> function, bool onMainThread)
+{
+	auto job = std::allocate_shared<Job>(PoolAllocator<Job>(blockPool));
+	job->function = std::move(function);
+	job->mainThread = onMainThread;
+	return job;
+}
+
+JobSystem::Handle JobSystem::Group()
+{
+	// Tâche sans fonction, jamais mise en file : l'appelant la termine avec Finish une fois sa part faite
+	return Create(nullptr, false);
+}
+
+void JobSystem::Spawn(RangeTask& task, size_t begin, size_t end)
+{
+	auto job = Create(nullptr, false);
+	job->range = &task;
+	job->begin = begin;
+	job->end = end;
+	job->parent = task.group;
+	task.group->unfinished.fetch_add(1, std::memory_order_relaxed);
+	job->blockers.store(0, std::memory_order_relaxed);
+	Enqueue(job);
+}
+
+JobSystem::Handle JobSystem::Submit(std::function<void()> function, const std::vector<Handle>& dependencies)
+{
+	auto job = Create(std::move(function), false);
+	Schedule(job, dependencies);
+	return job;
+}
+
+JobSystem::Handle JobSystem::SubmitMain(std::function<void()> function, const std::vector<Handle>& dependencies)
+{
+	auto job = Create(std::move(function), true);
+	Schedule(job, dependencies);
+	return job;
+}
+
+void JobSystem::Schedule(const Handle& job, const std::vector<Handle>& dependencies)
+{
+	// blockers vaut 1 pendant l'inscription : une dépendance qui se termine entre-temps ne peut pas lancer la tâche
+	for (const auto& dependency : dependencies)
+	{
+		if (!dependency)
+			continue;
+
+		std::lock_guard<std::mutex> lock(dependency->mutex);
+		if (!dependency->done.load(std::memory_order_acquire))
+		{
+			job->blockers.fetch_add(1, std::memory_order_relaxed);
+			dependency->continuations.push_back(job);
+		}
+	}
+
+	if (job->blockers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		Enqueue(job);
+}
+
+size_t JobSystem::QueueIndex() const
+{
+	return currentSlot.pool == this ? currentSlot.index : 0;
+}
+
+void JobSystem::Enqueue(const Handle& job)
+{
+	if (job->mainThread)
+	{
+		std::lock_guard<std::mutex> lock(mainQueue.mutex);
+		mainQueue.PushBack(job);
+		return;
+	}
+
+	{
+		auto& queue = *queues[QueueIndex()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.PushBack(job);
+	}
+
+	// Les deux compteurs sont séquentiellement cohérents : soit le thread qui s'endort voit la tâche,
+	// soit on le voit endormi et on le réveille sous le mutex
+	queued.fetch_add(1);
+	if (sleeping.load() > 0)
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		wake.notify_one();
+	}
+}
+
+JobSystem::Handle JobSystem::Pop()
+{
+	// Sa propre file par la fin (dernière tâche créée, encore en cache), puis vol par le début des autres
+	const auto own = QueueIndex();
+	for (size_t i = 0; i < queues.size(); i++)
+	{
+		const auto index = (own + i) % queues.size();
+		auto& queue = *queues[index];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.Empty())
+			continue;
+
+		Handle job;
+		if (i == 0)
+			job = queue.PopBack();
+		else
+		{
+			job = queue.PopFront();
+			stolen.fetch_add(1, std::memory_order_relaxed);
+		}
+		queued.fetch_sub(1);
+		return job;
+	}
+	return nullptr;
+}
+
+bool JobSystem::RunOne()
+{
+	const auto job = Pop();
+	if (!job)
+		return false;
+
+	Execute(job);
+	return true;
+}
+
+void JobSystem::Execute(const Handle& job)
+{
+	try
+	{
+		if (job->range)
+			job->range->run(*job->range, job->begin, job->end);
+		else if (job->function)
+			job->function();
+	}
+	catch (...)
+	{
+		Fail(job, std::current_exception());
+	}
+
+	// La fonction n'est plus utile : ses captures sont libérées avant la fin des sous-tâches
+	job->function = nullptr;
+	executed.fetch_add(1, std::memory_order_relaxed);
+	Finish(job);
+}
+
+void JobSystem::Fail(const Handle& job, std::exception_ptr error)
+{
+	std::lock_guard<std::mutex> lock(job->mutex);
+	if (!job->error)
+		job->error = error;
+}
+
+void JobSystem::Finish(const Handle& job)
+{
+	if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		return;
+
+	std::vector<Handle> continuations;
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(job->mutex);
+		job->done.store(true, std::memory_order_release);
+		continuations.swap(job->continuations);
+		error = job->error;
+	}
+
+	for (const auto& continuation : continuations)
+	{
+		if (continuation->blockers.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			Enqueue(continuation);
+	}
+
+	if (const auto parent = std::move(job->parent))
+	{
+		if (error)
+			Fail(parent, error);
+		Finish(parent);
+	}
+}
+
+bool JobSystem::IsDone(const Handle& job) const
+{
+	return job->done.load(std::memory_order_acquire);
+}
+
+void JobSystem::Wait(const Handle& job)
+{
+	const auto onMainThread = std::this_thread::get_id() == mainThread;
+	while (!IsDone(job))
+	{
+		if (RunOne())
+			continue;
+		if (onMainThread && RunMainThreadJobs() > 0)
+			continue;
+		std::this_thread::yield();
+	}
+
+	std::exception_ptr error;
+	{
+		std::lock_guard<std::mutex> lock(job->mutex);
+		error = job->error;
+	}
+	if (error)
+		std::rethrow_exception(error);
+}
+
+size_t JobSystem::RunMainThreadJobs()
+{
+	// Seulement les tâches déjà en file : celles qu'elles soumettent attendront l'appel suivant
+	size_t pending;
+	{
+		std::lock_guard<std::mutex> lock(mainQueue.mutex);
+		pending = mainQueue.Size();
+	}
+
+	for (size_t i = 0; i < pending; i++)
+	{
+		Handle job;
+		{
+			std::lock_guard<std::mutex> lock(mainQueue.mutex);
+			job = mainQueue.PopFront();
+		}
+		Execute(job);
+	}
+	return pending;
+}
+
+void JobSystem::WorkerLoop(size_t index)
+{
+	currentSlot = { this, index };
+
+	for (;;)
+	{
+		if (RunOne())
+			continue;
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleeping.fetch_add(1);
+		wake.wait(lock, [&] { return !running || queued.load() > 0; });
+		sleeping.fetch_sub(1);
+		if (!running)
+			break;
+	}
+}
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+template <typename T>
+class JobFuture;
+
+struct JobStats
+{
+	uint64_t executed = 0;
+	uint64_t stolen = 0; // pris dans la file d'un autre thread
+};
+
+// Pool de threads à vol de tâches, partagé par les chargements, les traitements de maillages et la mise à jour
+// de la frame. Chaque thread du pool a sa file : il empile et dépile ses tâches par la fin, les threads inoccupés
+// volent par le début. Les threads extérieurs au pool (thread principal, std::async...) partagent une file commune.
+// Une tâche peut attendre d'autres tâches (dépendances) et créer des sous-tâches : elle n'est terminée qu'avec elles.
+// Les tâches soumises avec SubmitMain ne s'exécutent que sur le thread principal, dans RunMainThreadJobs ou Wait :
+// c'est là que vont les appels GL.
+// Wait aide pendant l'attente (exécute d'autres tâches) : les attentes imbriquées ne bloquent pas le pool.
+class JobSystem
+{
+public:
+	struct Job;
+	using Handle = std::shared_ptr<Job>;
+
+	// threadCount compte l'appelant : threadCount - 1 threads sont créés. Le thread qui construit le pool
+	// est le thread principal.
+	explicit JobSystem(size_t threadCount = std::max<unsigned>(1, std::thread::hardware_concurrency()));
+	~JobSystem();
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	// Pool commun, créé au premier appel : le faire depuis le thread principal
+	static JobSystem& Instance();
+
+	size_t ThreadCount() const { return queues.size(); }
+
+	// La tâche part quand toutes ses dépendances sont terminées
+	Handle Submit(std::function<void()> function, const std::vector<Handle>& dependencies = {});
+	Handle SubmitMain(std::function<void()> function, const std::vector<Handle>& dependencies = {});
+
+	// Submit pour une fonction qui renvoie une valeur, lue avec JobFuture::Get
+	template <typename F>
+	JobFuture<std::invoke_result_t<F>> Async(F&& function, const std::vector<Handle>& dependencies = {});
+
+	// Attend la fin de la tâche et de ses sous-tâches en exécutant d'autres tâches (et celles du thread principal
+	// si on y est). Relance la première exception levée par la tâche ou ses sous-tâches.
+	void Wait(const Handle& job);
+	bool IsDone(const Handle& job) const;
+
+	// Exécute les tâches en attente du thread principal ; à appeler depuis lui, une fois par frame
+	size_t RunMainThreadJobs();
+
+	// Appelle func(begin, end) sur des tranches de [0, count). Le grain s'adapte au nombre de threads
+	// (environ 4 tranches par thread, jamais moins de minGrain éléments) et les tranches sont découpées
+	// récursivement en deux : un thread qui vole prend toujours la plus grosse moitié restante.
+	template <typename F>
+	void ParallelFor(size_t count, F&& func, size_t minGrain = 1);
+
+	// Découpe fixe en nChunks tranches contiguës, func(chunk, begin, end) ; la dernière est traitée par l'appelant.
+	// Le découpage ne dépend que de count et nChunks.
+	template <typename F>
+	void ParallelForChunks(size_t count, size_t nChunks, F&& func);
+
+	JobStats Stats() const;
+
+private:
+	// File circulaire de tâches : ne réalloue que pour dépasser sa plus grande taille, contrairement à std::deque
+	class WorkQueue
+	{
+	public:
+		std::mutex mutex;
+
+		WorkQueue() : ring(256) {}
+		bool Empty() const { return size == 0; }
+		size_t Size() const { return size; }
+		void PushBack(Handle job);
+		Handle PopBack();
+		Handle PopFront();
+
+	private:
+		std::vector<Handle> ring;
+		size_t head = 0;
+		size_t size = 0;
+	};
+
+	// Blocs recyclés pour les tâches (objet et compteur de shared_ptr ensemble) : une fois le pool chaud,
+	// soumettre une tâche n'alloue plus. Partagé avec les Handle, qui peuvent survivre au JobSystem.
+	struct BlockPool
+	{
+		std::mutex mutex;
+		std::vector<void*> blocks;
+		size_t blockSize = 0;
+
+		~BlockPool();
+		void* Allocate(size_t size);
+		void Deallocate(void* block, size_t size);
+	};
+
+	template <typename T>
+	struct PoolAllocator
+	{
+		using value_type = T;
+
+		std::shared_ptr<BlockPool> pool;
+
+		explicit PoolAllocator(std::shared_ptr<BlockPool> pool) : pool(std::move(pool)) {}
+		template <typename U>
+		PoolAllocator(const PoolAllocator<U>& other) : pool(other.pool) {}
+
+		T* allocate(size_t n) { return static_cast<T*>(pool->Allocate(n * sizeof(T))); }
+		void deallocate(T* p, size_t n) { pool->Deallocate(p, n * sizeof(T)); }
+
+		template <typename U>
+		bool operator==(const PoolAllocator<U>& other) const { return pool == other.pool; }
+		template <typename U>
+		bool operator!=(const PoolAllocator<U>& other) const { return pool != other.pool; }
+	};
+
+	// Tranches d'un ParallelFor ou d'un ParallelForChunks, sur la pile de l'appelant qui attend leur fin.
+	// Les sous-tâches n'y font que référence : pas de std::function (ni d'allocation) par tranche.
+	struct RangeTask
+	{
+		void (*run)(RangeTask& task, size_t begin, size_t end);
+		JobSystem* pool;
+		Handle group;
+		void* func;
+		size_t count;
+		size_t parameter; // grain pour ParallelFor, nombre de tranches pour ParallelForChunks
+	};
+
+	template <typename F>
+	static void RunSplit(RangeTask& task, size_t begin, size_t end);
+	template <typename F>
+	static void RunChunk(RangeTask& task, size_t chunk, size_t);
+
+	Handle Create(std::function<void()> function, bool mainThread);
+	void Spawn(RangeTask& task, size_t begin, size_t end);
+	Handle Group();
+	void Schedule(const Handle& job, const std::vector<Handle>& dependencies);
+	void Enqueue(const Handle& job);
+	void Execute(const Handle& job);
+	void Finish(const Handle& job);
+	void Fail(const Handle& job, std::exception_ptr error);
+
+	size_t QueueIndex() const;
+	Handle Pop();
+	bool RunOne();
+	void WorkerLoop(size_t index);
+
+	std::shared_ptr<BlockPool> blockPool = std::make_shared<BlockPool>();
+	std::vector<std::unique_ptr<WorkQueue>> queues; // 0 : threads extérieurs au pool
+	WorkQueue mainQueue;
+	std::thread::id mainThread;
+
+	std::atomic<size_t> queued{ 0 };
+	std::atomic<size_t> sleeping{ 0 };
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+	bool running = true;
+
+	std::atomic<uint64_t> executed{ 0 };
+	std::atomic<uint64_t> stolen{ 0 };
+
+	std::vector<std::thread> workers;
+};
+
+struct JobSystem::Job
+{
+	std::function<void()> function;
+	RangeTask* range = nullptr; // à la place de function pour une tranche : range->run(*range, begin, end)
+	size_t begin = 0, end = 0;
+	Handle parent;
+	bool mainThread = false;
+
+	std::atomic<int> unfinished{ 1 }; // la tâche elle-même et ses sous-tâches en cours
+	std::atomic<int> blockers{ 1 };   // dépendances non terminées, plus 1 tant que Schedule n'a pas fini
+	std::atomic<bool> done{ false };
+
+	std::mutex mutex; // continuations et error
+	std::vector<Handle> continuations;
+	std::exception_ptr error;
+};
+
+template <typename F>
+void JobSystem::RunSplit(RangeTask& task, size_t begin, size_t end)
+{
+	// La moitié haute part dans la file du thread, la basse est traitée tout de suite
+	while (end - begin > task.parameter)
+	{
+		const auto middle = begin + (end - begin) / 2;
+		task.pool->Spawn(task, middle, end);
+		end = middle;
+	}
+	(*static_cast<F*>(task.func))(begin, end);
+}
+
+template <typename F>
+void JobSystem::RunChunk(RangeTask& task, size_t chunk, size_t)
+{
+	const auto chunkBegin = [&](size_t c) { return task.count * c / task.parameter; };
+	(*static_cast<F*>(task.func))(chunk, chunkBegin(chunk), chunkBegin(chunk + 1));
+}
+
+template <typename F>
+void JobSystem::ParallelFor(size_t count, F&& func, size_t minGrain)
+{
+	if (count == 0)
+		return;
+
+	const auto grain = std::max<size_t>(std::max<size_t>(1, minGrain), count / (ThreadCount() * 4));
+	if (ThreadCount() == 1 || count <= grain)
+	{
+		func((size_t) 0, count);
+		return;
+	}
+
+	using Func = std::remove_reference_t<F>;
+	RangeTask task{ &RunSplit<Func>, this, Group(), (void*) &func, count, grain };
+	try
+	{
+		RunSplit<Func>(task, 0, count);
+	}
+	catch (...)
+	{
+		Fail(task.group, std::current_exception());
+	}
+	Finish(task.group);
+	Wait(task.group);
+}
+
+template <typename F>
+void JobSystem::ParallelForChunks(size_t count, size_t nChunks, F&& func)
+{
+	if (count == 0 || nChunks == 0)
+		return;
+
+	if (nChunks == 1)
+	{
+		func((size_t) 0, (size_t) 0, count);
+		return;
+	}
+
+	using Func = std::remove_reference_t<F>;
+	RangeTask task{ &RunChunk<Func>, this, Group(), (void*) &func, count, nChunks };
+	for (size_t chunk = 0; chunk + 1 < nChunks; chunk++)
+		Spawn(task, chunk, chunk + 1);
+
+	try
+	{
+		RunChunk<Func>(task, nChunks - 1, nChunks);
+	}
+	catch (...)
+	{
+		Fail(task.group, std::current_exception());
+	}
+	Finish(task.group);
+	Wait(task.group);
+}
+
+// Résultat d'une tâche lancée avec JobSystem::Async. Contrairement à std::future, Get aide le pool pendant
+// l'attente : l'appeler depuis une tâche, ou avec un pool d'un seul thread, ne bloque pas.
+template <typename T>
+class JobFuture
+{
+public:
+	JobFuture() = default;
+	JobFuture(JobSystem& pool, JobSystem::Handle job, std::shared_ptr<std::optional<T>> value)
+		: pool(&pool), job(std::move(job)), value(std::move(value))
+	{
+	}
+
+	bool Valid() const { return job != nullptr; }
+	bool IsReady() const { return pool->IsDone(job); }
+
+	// Pour faire dépendre d'autres tâches de ce résultat
+	const JobSystem::Handle& Job() const { return job; }
+
+	// Attend la fin de la tâche et déplace son résultat : à n'appeler qu'une fois. Relance l'exception de la tâche.
+	T Get()
+	{
+		pool->Wait(job);
+		return std::move(**value);
+	}
+
+private:
+	JobSystem* pool = nullptr;
+	JobSystem::Handle job;
+	std::shared_ptr<std::optional<T>> value;
+};
+
+template <typename F>
+JobFuture<std::invoke_result_t<F>> JobSystem::Async(F&& function, const std::vector<Handle>& dependencies)
+{
+	using T = std::invoke_result_t<F>;
+	auto value = std::make_shared<std::optional<T>>();
+	auto job = Submit([value, function = std::forward<F>(function)]() mutable { value->emplace(function()); }, dependencies);
+	return JobFuture<T>(*this, std::move(job), std::move(value));
+}
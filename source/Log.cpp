@@ -0,0 +1,242 @@
+#include "Log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	const char* LevelName(LogLevel l)
+	{
+		switch (l)
+		{
+		case LogLevel::Trace: return "trace";
+		case LogLevel::Debug: return "debug";
+		case LogLevel::Info: return "info";
+		case LogLevel::Warning: return "warning";
+		case LogLevel::Error: return "error";
+		default: return "";
+		}
+	}
+}
+
+std::atomic<int> Logger::level{ (int) LogLevel::Info };
+
+Logger& Logger::Instance()
+{
+	static Logger logger(4096);
+	return logger;
+}
+
+Logger::Logger(size_t capacity)
+	: slots(new Slot[capacity]), mask(capacity - 1), start(std::chrono::steady_clock::now())
+{
+	// capacity doit être une puissance de 2 ; chaque case attend le producteur du tour 0
+	for (size_t i = 0; i < capacity; i++)
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+
+	thread = std::thread(&Logger::Run, this);
+}
+
+Logger::~Logger()
+{
+	Shutdown();
+}
+
+void Logger::Push(LogLevel l, const char* text, size_t length)
+{
+	length = std::min(length, MaxMessage);
+
+	// Annoncé avant de lire async : soit Shutdown voit ce producteur et l'attend, soit le producteur voit
+	// async à faux (les deux opérations sont séquentiellement cohérentes)
+	producers.fetch_add(1);
+	struct Leave
+	{
+		std::atomic<uint32_t>& producers;
+		~Leave() { producers.fetch_sub(1, std::memory_order_release); }
+	} leave{ producers };
+
+	// Après Shutdown, plus de thread pour vider l'anneau : écriture directe
+	if (!async.load())
+	{
+		std::string line;
+		Format(line, l, std::chrono::steady_clock::now(), text, length);
+		std::fwrite(line.data(), 1, line.size(), Output());
+		written.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	// File bornée de Vyukov : la séquence d'une case dit si elle est libre pour ce tour
+	auto pos = enqueuePos.load(std::memory_order_relaxed);
+	Slot* slot;
+	for (;;)
+	{
+		slot = &slots[pos & mask];
+		const auto sequence = slot->sequence.load(std::memory_order_acquire);
+		const auto diff = (intptr_t) sequence - (intptr_t) pos;
+		if (diff == 0)
+		{
+			if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		else
+		{
+			pos = enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->level = l;
+	slot->length = (uint32_t) length;
+	slot->time = std::chrono::steady_clock::now();
+	std::memcpy(slot->text, text, length);
+	slot->sequence.store(pos + 1, std::memory_order_release);
+
+	// Les erreurs sont écrites sans attendre le prochain réveil du thread, de même qu'une rafale
+	// qui remplit un quart de l'anneau
+	if (l >= LogLevel::Error || (pos & (mask >> 2)) == 0)
+	{
+		kick.store(true, std::memory_order_relaxed);
+		wake.notify_one();
+	}
+}
+
+size_t Logger::Drain(std::string& batch)
+{
+	size_t count = 0;
+	for (;;)
+	{
+		auto& slot = slots[dequeuePos & mask];
+		if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1)
+			break;
+
+		Format(batch, slot.level, slot.time, slot.text, slot.length);
+		slot.sequence.store(dequeuePos + mask + 1, std::memory_order_release);
+		dequeuePos++;
+		count++;
+	}
+	return count;
+}
+
+void Logger::Format(std::string& out, LogLevel l, std::chrono::steady_clock::time_point time, const char* text, size_t length) const
+{
+	char prefix[48];
+	const auto seconds = std::chrono::duration<double>(time - start).count();
+	const auto n = std::snprintf(prefix, sizeof(prefix), "[%9.3f] [%s] ", seconds, LevelName(l));
+	out.append(prefix, n);
+	out.append(text, length);
+	out += '\n';
+}
+
+void Logger::Run()
+{
+	std::string batch;
+	std::unique_lock<std::mutex> lock(mutex);
+	for (;;)
+	{
+		const auto stopping = !running;
+		lock.unlock();
+
+		batch.clear();
+		const auto count = Drain(batch);
+		if (count > 0)
+		{
+			const auto file = Output();
+			std::fwrite(batch.data(), 1, batch.size(), file);
+			std::fflush(file);
+			written.fetch_add(count, std::memory_order_relaxed);
+		}
+
+		lock.lock();
+		consumed = dequeuePos;
+		drained.notify_all();
+		if (stopping && count == 0)
+			break;
+
+		wake.wait_for(lock, std::chrono::milliseconds(5), [&] { return !running || flushTarget > consumed || kick.exchange(false, std::memory_order_relaxed); });
+	}
+}
+
+void Logger::Flush()
+{
+	if (!async.load(std::memory_order_acquire))
+	{
+		std::fflush(Output());
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	// Les messages pris après ce point ne sont pas attendus
+	const auto target = enqueuePos.load(std::memory_order_acquire);
+	flushTarget = std::max(flushTarget, target);
+	wake.notify_one();
+	drained.wait(lock, [&] { return consumed >= target || !running; });
+}
+
+void Logger::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		if (!running)
+			return;
+		running = false;
+	}
+	async.store(false);
+
+	// Un producteur qui a vu async à vrai a peut-être pris une case sans l'avoir encore publiée :
+	// le dernier passage s'arrêterait avant elle
+	while (producers.load(std::memory_order_acquire) > 0)
+		std::this_thread::yield();
+
+	wake.notify_one();
+	thread.join();
+
+	// Messages publiés pendant le dernier passage du thread
+	std::string batch;
+	written.fetch_add(Drain(batch), std::memory_order_relaxed);
+	std::fwrite(batch.data(), 1, batch.size(), Output());
+	std::fflush(Output());
+}
+
+LoggerStats Logger::Stats() const
+{
+	LoggerStats stats;
+	stats.written = written.load(std::memory_order_relaxed);
+	stats.dropped = dropped.load(std::memory_order_relaxed);
+	return stats;
+}
+
+void LogLine::Append(const char* v)
+{
+	Append(v, std::strlen(v));
+}
+
+void LogLine::Append(const char* v, size_t size)
+{
+	const auto n = std::min(size, (size_t) Logger::MaxMessage - length);
+	std::memcpy(buffer + length, v, n);
+	length += (uint32_t) n;
+}
+
+void LogLine::Append(long long v)
+{
+	char text[24];
+	Append(text, std::snprintf(text, sizeof(text), "%lld", v));
+}
+
+void LogLine::Append(unsigned long long v)
+{
+	char text[24];
+	Append(text, std::snprintf(text, sizeof(text), "%llu", v));
+}
+
+void LogLine::Append(double v)
+{
+	// Même rendu que std::cout par défaut (6 chiffres significatifs)
+	char text[32];
+	Append(text, std::snprintf(text, sizeof(text), "%g", v));
+}
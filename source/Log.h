@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+enum class LogLevel : int
+{
+	Trace,
+	Debug,
+	Info,
+	Warning,
+	Error,
+	Off
+};
+
+struct LoggerStats
+{
+	uint64_t written = 0;
+	uint64_t dropped = 0; // messages perdus parce que l'anneau était plein
+};
+
+// Journal asynchrone : les threads écrivent des messages formatés dans un anneau de taille fixe sans verrou
+// (file bornée multi-producteurs), un thread d'arrière-plan les écrit sur la sortie standard par lots.
+// Un message filtré par le niveau ne coûte qu'une lecture atomique. Si l'anneau est plein, le message
+// est perdu et compté plutôt que de bloquer l'appelant.
+class Logger
+{
+public:
+	static constexpr size_t MaxMessage = 240;
+
+	static Logger& Instance();
+
+	static bool Enabled(LogLevel l) { return (int) l >= level.load(std::memory_order_relaxed); }
+	static void SetLevel(LogLevel l) { level.store((int) l, std::memory_order_relaxed); }
+
+	void Push(LogLevel l, const char* text, size_t length);
+
+	// Destination des messages, stdout par défaut ; le fichier doit rester ouvert tant qu'il est utilisé
+	void SetOutput(std::FILE* file) { output.store(file, std::memory_order_release); }
+	std::FILE* Output() const { return output.load(std::memory_order_acquire); }
+
+	// Attend que tous les messages déjà poussés soient écrits
+	void Flush();
+	// Vide l'anneau et arrête le thread ; les messages suivants sont écrits directement
+	void Shutdown();
+
+	LoggerStats Stats() const;
+	// Messages que l'anneau peut garder avant d'en perdre
+	size_t Capacity() const { return mask + 1; }
+
+	~Logger();
+
+private:
+	Logger(size_t capacity);
+
+	struct Slot
+	{
+		std::atomic<size_t> sequence;
+		LogLevel level;
+		uint32_t length;
+		std::chrono::steady_clock::time_point time;
+		char text[MaxMessage];
+	};
+
+	void Run();
+	size_t Drain(std::string& batch);
+	void Format(std::string& out, LogLevel l, std::chrono::steady_clock::time_point time, const char* text, size_t length) const;
+
+	static std::atomic<int> level;
+
+	std::unique_ptr<Slot[]> slots;
+	size_t mask;
+	alignas(64) std::atomic<size_t> enqueuePos{ 0 };
+	alignas(64) size_t dequeuePos = 0;
+	std::atomic<uint64_t> dropped{ 0 };
+	std::atomic<uint64_t> written{ 0 };
+	std::atomic<std::FILE*> output{ stdout };
+
+	std::chrono::steady_clock::time_point start;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable drained;
+	size_t flushTarget = 0;
+	size_t consumed = 0; // copie de dequeuePos protégée par mutex
+	bool running = true;
+	std::atomic<bool> async{ true };
+	std::atomic<uint32_t> producers{ 0 }; // Push en cours, attendus par Shutdown
+	std::atomic<bool> kick{ false }; // réveil demandé par un producteur, sans prendre le mutex
+	std::thread thread;
+};
+
+// Ligne de journal construite avec <<, poussée dans le Logger à sa destruction :
+//   Log(LogLevel::Info) << "Yoda Size : " << nTrianglesYoda;
+// Si le niveau est filtré, aucun argument n'est formaté. Le texte est tronqué à Logger::MaxMessage.
+class LogLine
+{
+public:
+	LogLine(LogLevel l)
+		: level(l), enabled(Logger::Enabled(l))
+	{
+	}
+	~LogLine()
+	{
+		if (enabled)
+			Logger::Instance().Push(level, buffer, length);
+	}
+
+	LogLine(const LogLine&) = delete;
+	LogLine& operator=(const LogLine&) = delete;
+
+	LogLine& operator<<(const char* v) { if (enabled) Append(v); return *this; }
+	LogLine& operator<<(const std::string& v) { if (enabled) Append(v.data(), v.size()); return *this; }
+	LogLine& operator<<(char v) { if (enabled) Append(&v, 1); return *this; }
+	LogLine& operator<<(bool v) { if (enabled) Append(v ? "true" : "false"); return *this; }
+	LogLine& operator<<(int v) { if (enabled) Append((long long) v); return *this; }
+	LogLine& operator<<(long v) { if (enabled) Append((long long) v); return *this; }
+	LogLine& operator<<(long long v) { if (enabled) Append(v); return *this; }
+	LogLine& operator<<(unsigned v) { if (enabled) Append((unsigned long long) v); return *this; }
+	LogLine& operator<<(unsigned long v) { if (enabled) Append((unsigned long long) v); return *this; }
+	LogLine& operator<<(unsigned long long v) { if (enabled) Append(v); return *this; }
+	LogLine& operator<<(float v) { if (enabled) Append((double) v); return *this; }
+	LogLine& operator<<(double v) { if (enabled) Append(v); return *this; }
+
+	// Autres types : passe par leur operator<< sur std::ostream
+	template <typename T>
+	LogLine& operator<<(const T& v)
+	{
+		if (enabled)
+		{
+			std::ostringstream s;
+			s << v;
+			const auto text = s.str();
+			Append(text.data(), text.size());
+		}
+		return *this;
+	}
+
+private:
+	void Append(const char* v);
+	void Append(const char* v, size_t size);
+	void Append(long long v);
+	void Append(unsigned long long v);
+	void Append(double v);
+
+	LogLevel level;
+	bool enabled;
+	uint32_t length = 0;
+	char buffer[Logger::MaxMessage];
+};
+
+inline LogLine Log(LogLevel l)
+{
+	return LogLine(l);
+}
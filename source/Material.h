@@ -1,8 +1,11 @@
 #pragma once
 
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 
 struct Material
 {
 	glm::vec3 albedo;
+	// Zone de la texture du matériau dans l'atlas : uv atlas = xy + uv * zw
+	glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
 };
\ No newline at end of file
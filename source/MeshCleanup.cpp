@@ -0,0 +1,187 @@
+#include "MeshCleanup.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "Parallel.h"
+#include "RadixSort.h"
+
+namespace
+{
+	enum class Status : uint8_t
+	{
+		Keep,
+		Degenerate,
+		NearDegenerate,
+		Duplicate
+	};
+
+	using SortedVertices = std::array<glm::vec3, 3>;
+
+	// Entrée du tri des doublons : hash des sommets triés et indice du triangle
+	struct HashedTriangle
+	{
+		uint64_t key;
+		uint32_t index;
+	};
+
+	bool LessVertex(const glm::vec3& a, const glm::vec3& b)
+	{
+		if (a.x != b.x) return a.x < b.x;
+		if (a.y != b.y) return a.y < b.y;
+		return a.z < b.z;
+	}
+
+	// Sommets triés pour que deux facettes identiques donnent le même triplet quel que soit l'ordre de parcours
+	SortedVertices SortVertices(const Triangle& t)
+	{
+		SortedVertices v{ t.p0, t.p1, t.p2 };
+		if (LessVertex(v[1], v[0])) std::swap(v[0], v[1]);
+		if (LessVertex(v[2], v[1])) std::swap(v[1], v[2]);
+		if (LessVertex(v[1], v[0])) std::swap(v[0], v[1]);
+		return v;
+	}
+
+	// FNV-1a sur les bits des coordonnées ; -0 et +0 sont confondus
+	uint64_t HashVertices(const SortedVertices& v)
+	{
+		uint64_t h = 14695981039346656037ull;
+		for (auto&& p : v)
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				const float f = p[i] + 0.0f;
+				uint32_t bits;
+				std::memcpy(&bits, &f, sizeof(bits));
+				h = (h ^ bits) * 1099511628211ull;
+			}
+		}
+		return h;
+	}
+
+	bool IsFinite(const glm::vec3& p)
+	{
+		return std::isfinite(p.x) && std::isfinite(p.y) && std::isfinite(p.z);
+	}
+
+	Status Classify(const Triangle& t, float minQuality)
+	{
+		if (!IsFinite(t.p0) || !IsFinite(t.p1) || !IsFinite(t.p2))
+			return Status::Degenerate;
+
+		// Même calcul que CreateTriangleWithNormals : un produit vectoriel nul donne une normale NaN
+		const auto n = glm::cross(t.p0 - t.p1, t.p0 - t.p2);
+		const auto doubleArea2 = glm::dot(n, n);
+		if (!(doubleArea2 > 0.0f) || !std::isfinite(doubleArea2))
+			return Status::Degenerate;
+
+		// Qualité = 2 * aire / arête² : indépendante de l'échelle, proche de 0 pour les aiguilles et les éclats
+		const auto e0 = glm::dot(t.p1 - t.p0, t.p1 - t.p0);
+		const auto e1 = glm::dot(t.p2 - t.p1, t.p2 - t.p1);
+		const auto e2 = glm::dot(t.p0 - t.p2, t.p0 - t.p2);
+		const auto longest2 = std::max(e0, std::max(e1, e2));
+		if (std::sqrt(doubleArea2) < minQuality * longest2)
+			return Status::NearDegenerate;
+
+		return Status::Keep;
+	}
+}
+
+CleanupReport RemoveDegenerateTriangles(TriangleList& outTriangles, float minQuality)
+{
+	const auto n = outTriangles.size();
+	std::vector<Status> status(n);
+	std::vector<HashedTriangle> order(n);
+
+	// Classification et hachage indépendants par triangle ; les triangles rejetés gardent le hash 0
+	ParallelFor(n, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			status[i] = Classify(outTriangles[i], minQuality);
+			const auto hash = status[i] == Status::Keep ? HashVertices(SortVertices(outTriangles[i])) : 0;
+			order[i] = { hash, (uint32_t) i };
+		}
+	});
+
+	// Doublons : tri par base parallèle et stable des (hash, indice), donc par hash puis par indice,
+	// puis comparaison exacte à l'intérieur de chaque groupe de même hash ; la première occurrence est conservée
+	std::vector<HashedTriangle> scratch;
+	RadixSortByKey(order, scratch);
+
+	// Chaque tranche traite les groupes qui commencent chez elle, quitte à déborder sur la suivante :
+	// un groupe n'est vu que par une tranche, les statuts qu'il modifie ne sont lus que par elle
+	ParallelFor(n, [&](size_t begin, size_t end)
+	{
+		auto groupBegin = begin;
+		while (groupBegin > 0 && groupBegin < n && order[groupBegin].key == order[groupBegin - 1].key)
+			groupBegin++;
+
+		while (groupBegin < end)
+		{
+			auto groupEnd = groupBegin + 1;
+			while (groupEnd < n && order[groupEnd].key == order[groupBegin].key)
+				groupEnd++;
+
+			for (auto j = groupBegin + 1; j < groupEnd; j++)
+			{
+				if (status[order[j].index] != Status::Keep)
+					continue;
+
+				const auto vj = SortVertices(outTriangles[order[j].index]);
+				for (auto k = groupBegin; k < j; k++)
+				{
+					if (status[order[k].index] == Status::Keep && SortVertices(outTriangles[order[k].index]) == vj)
+					{
+						status[order[j].index] = Status::Duplicate;
+						break;
+					}
+				}
+			}
+
+			groupBegin = groupEnd;
+		}
+	});
+
+	// Compaction parallèle : comptage par tranche, somme préfixe, puis recopie à la bonne position
+	const auto nChunks = ChunkCount(n);
+	std::vector<size_t> chunkOffsets(nChunks + 1, 0);
+	ParallelForChunks(n, nChunks, [&](size_t chunk, size_t begin, size_t end)
+	{
+		chunkOffsets[chunk + 1] = std::count(status.begin() + begin, status.begin() + end, Status::Keep);
+	});
+
+	for (size_t chunk = 0; chunk < nChunks; chunk++)
+	{
+		chunkOffsets[chunk + 1] += chunkOffsets[chunk];
+	}
+
+	CleanupReport report;
+	report.kept = chunkOffsets[nChunks];
+	if (report.kept == n)
+		return report;
+
+	for (auto s : status)
+	{
+		report.degenerate += s == Status::Degenerate;
+		report.nearDegenerate += s == Status::NearDegenerate;
+		report.duplicate += s == Status::Duplicate;
+	}
+
+	TriangleList compacted(report.kept);
+	ParallelForChunks(n, nChunks, [&](size_t chunk, size_t begin, size_t end)
+	{
+		auto dst = chunkOffsets[chunk];
+		for (size_t i = begin; i < end; i++)
+		{
+			if (status[i] == Status::Keep)
+				compacted[dst++] = outTriangles[i];
+		}
+	});
+
+	outTriangles.swap(compacted);
+	return report;
+}
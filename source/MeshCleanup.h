@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+
+#include "Triangle.h"
+
+// Bilan d'un nettoyage de maillage
+struct CleanupReport
+{
+	size_t degenerate = 0;     // aire nulle ou coordonnées invalides (normale NaN)
+	size_t nearDegenerate = 0; // triangles aplatis sous le seuil de qualité
+	size_t duplicate = 0;      // facettes ayant les mêmes sommets qu'une facette précédente
+	size_t kept = 0;
+
+	size_t Removed() const { return degenerate + nearDegenerate + duplicate; }
+};
+
+// Supprime les triangles dégénérés, quasi dégénérés et dupliqués en conservant l'ordre des autres.
+// minQuality est le rapport 2 * aire / (plus grande arête)² en dessous duquel un triangle est jugé trop aplati
+// (0 désactive le test). Les doublons sont détectés sur les triplets de sommets triés, quel que soit l'ordre.
+CleanupReport RemoveDegenerateTriangles(TriangleList& outTriangles, float minQuality = 1e-6f);
@@ -1,5 +1,12 @@
 #pragma once
-void CreateTriangleWithNormals(const std::vector<Triangle>& triangles, std::vector<TriangleWithNormal>& outTrianglesWithNormals)
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Triangle.h"
+
+inline void CreateTriangleWithNormals(const TriangleList& triangles, TriangleWithNormalList& outTrianglesWithNormals)
 {
 	for (size_t i = 0; i < triangles.size(); i++)
 	{
@@ -14,7 +21,7 @@ void CreateTriangleWithNormals(const std::vector<Triangle>& triangles, std::vect
 	}
 }
 
-void CenterAllVertex(std::vector<Triangle>& outTriangles)
+inline void CenterAllVertex(TriangleList& outTriangles)
 {
     // Calcul du centre de l'objet
     glm::vec3 gravityCenter(0.0f);
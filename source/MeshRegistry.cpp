@@ -0,0 +1,113 @@
+#include "MeshRegistry.h"
+
+#include <stdexcept>
+#include <string>
+
+MeshRegistry::MeshRegistry(size_t capacityInBytes)
+	: allocator(capacityInBytes), gpuBytes(MemoryCategory::GpuBuffer, capacityInBytes)
+{
+	glCreateBuffers(1, &vbo);
+	glNamedBufferData(vbo, capacityInBytes, nullptr, GL_STATIC_DRAW);
+}
+
+MeshRegistry::~MeshRegistry()
+{
+	glDeleteBuffers(1, &vbo);
+}
+
+MeshHandle MeshRegistry::Add(const TriangleWithNormalList& triangles)
+{
+	// BufferAllocator refuse les blocs de taille nulle
+	if (triangles.empty())
+		return {};
+
+	const auto size = triangles.size() * sizeof(TriangleWithNormal);
+
+	auto offset = allocator.Allocate(size, VertexStride);
+	if (offset == BufferAllocator::InvalidOffset && allocator.Stats().free >= size)
+	{
+		Defragment();
+		offset = allocator.Allocate(size, VertexStride);
+	}
+
+	if (offset == BufferAllocator::InvalidOffset)
+		throw std::runtime_error("Mesh registry full: cannot allocate " + std::to_string(size) + " bytes");
+
+	glNamedBufferSubData(vbo, offset, size, triangles.data());
+
+	const MeshHandle mesh{ nextId++ };
+	offsets[mesh.id] = offset;
+	generation++;
+	return mesh;
+}
+
+void MeshRegistry::Remove(MeshHandle mesh)
+{
+	if (!mesh.Valid())
+		return;
+
+	const auto it = offsets.find(mesh.id);
+	if (it == offsets.end())
+		throw std::invalid_argument("Unknown mesh handle");
+
+	allocator.Free(it->second);
+	offsets.erase(it);
+	generation++;
+}
+
+MeshRange MeshRegistry::Range(MeshHandle mesh) const
+{
+	if (!mesh.Valid())
+		return { 0, 0 };
+
+	const auto offset = offsets.at(mesh.id);
+	return { (GLint) (offset / VertexStride), (GLsizei) (allocator.SizeOf(offset) / VertexStride) };
+}
+
+std::vector<MeshRange> MeshRegistry::Ranges() const
+{
+	std::vector<MeshRange> ranges(nextId, MeshRange{ 0, 0 });
+	for (auto&& [id, offset] : offsets)
+		ranges[id] = Range({ id });
+	return ranges;
+}
+
+void MeshRegistry::Defragment()
+{
+	const auto moves = allocator.Defragment();
+	if (moves.empty())
+		return;
+
+	// glCopyNamedBufferSubData interdit les zones qui se chevauchent dans un même buffer :
+	// les blocs déplacés passent par un buffer temporaire
+	const auto stats = allocator.Stats();
+	GLuint staging;
+	glCreateBuffers(1, &staging);
+	glNamedBufferData(staging, stats.capacity, nullptr, GL_STREAM_COPY);
+	TrackedBytes stagingBytes(MemoryCategory::GpuBuffer, stats.capacity);
+
+	for (auto&& move : moves)
+	{
+		glCopyNamedBufferSubData(vbo, staging, move.from, move.to, move.size);
+	}
+	for (auto&& move : moves)
+	{
+		glCopyNamedBufferSubData(staging, vbo, move.to, move.to, move.size);
+	}
+
+	glDeleteBuffers(1, &staging);
+	generation++;
+
+	// Les offsets suivent les déplacements
+	for (auto&& [id, offset] : offsets)
+	{
+		for (auto&& move : moves)
+		{
+			if (move.from == offset)
+			{
+				offset = move.to;
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "AssetMemory.h"
+#include "BufferAllocator.h"
+#include "Triangle.h"
+
+// L'identifiant 0 désigne un maillage vide : il n'occupe rien dans le VBO et se dessine avec une plage vide
+struct MeshHandle
+{
+	uint32_t id = 0;
+
+	bool Valid() const { return id != 0; }
+};
+
+// Sommets d'un maillage dans le VBO partagé, prêts pour glDrawArrays(GL_TRIANGLES, first, count)
+struct MeshRange
+{
+	GLint first;
+	GLsizei count;
+};
+
+// Regroupe plusieurs maillages dans un seul VBO de taille fixe.
+// Les maillages peuvent être ajoutés et retirés à l'exécution sans renvoyer les autres au GPU.
+class MeshRegistry
+{
+public:
+	static constexpr size_t VertexStride = sizeof(TriangleWithNormal) / 3;
+
+	explicit MeshRegistry(size_t capacityInBytes);
+	~MeshRegistry();
+
+	MeshRegistry(const MeshRegistry&) = delete;
+	MeshRegistry& operator=(const MeshRegistry&) = delete;
+
+	// Défragmente puis réessaie si aucun bloc libre ne convient ; lève une exception si le buffer est plein.
+	// Un maillage sans triangle donne un MeshHandle invalide, de plage { 0, 0 }.
+	MeshHandle Add(const TriangleWithNormalList& triangles);
+	// Sans effet sur un MeshHandle invalide
+	void Remove(MeshHandle mesh);
+	MeshRange Range(MeshHandle mesh) const;
+	// Plages de tous les maillages indexées par identifiant, { 0, 0 } pour les identifiants libres
+	std::vector<MeshRange> Ranges() const;
+	// Change à chaque Add, Remove ou Defragment qui déplace des maillages : les plages copiées sont alors périmées
+	uint64_t Generation() const { return generation; }
+
+	// Tasse les maillages au début du VBO en passant par un buffer temporaire
+	void Defragment();
+
+	GLuint Buffer() const { return vbo; }
+	BufferAllocatorStats Stats() const { return allocator.Stats(); }
+
+private:
+	GLuint vbo;
+	BufferAllocator allocator;
+	std::unordered_map<uint32_t, size_t> offsets; // identifiant -> offset en octets
+	uint32_t nextId = 1;
+	uint64_t generation = 0;
+	TrackedBytes gpuBytes;
+};
@@ -0,0 +1,114 @@
+#include "MeshTransform.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define MESH_TRANSFORM_SSE 1
+#endif
+
+#include "Parallel.h"
+
+namespace
+{
+	// Matrices prêtes pour la multiplication par la gauche : p' = rows[0] * x + rows[1] * y + rows[2] * z + rows[3]
+	struct BakeMatrices
+	{
+		glm::vec4 rows[4];
+		glm::vec4 normalRows[3];
+	};
+
+	BakeMatrices MakeBakeMatrices(const glm::mat4& transform)
+	{
+		// vec4(p, 1) * M == transpose(M) * vec4(p, 1)
+		const auto t = glm::transpose(transform);
+		const auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(t)));
+
+		BakeMatrices m;
+		for (int i = 0; i < 4; i++)
+			m.rows[i] = t[i];
+		for (int i = 0; i < 3; i++)
+			m.normalRows[i] = glm::vec4(normalMatrix[i], 0.0f);
+		return m;
+	}
+
+#ifdef MESH_TRANSFORM_SSE
+	// Les vec3 ne sont pas alignés sur 16 octets : chargement par composante et écriture de 12 octets
+	// pour ne jamais déborder sur le champ suivant (qui peut appartenir à une autre tranche)
+	inline __m128 Transform(const __m128* rows, const glm::vec3& v, bool point)
+	{
+		auto r = _mm_mul_ps(rows[0], _mm_set1_ps(v.x));
+		r = _mm_add_ps(r, _mm_mul_ps(rows[1], _mm_set1_ps(v.y)));
+		r = _mm_add_ps(r, _mm_mul_ps(rows[2], _mm_set1_ps(v.z)));
+		return point ? _mm_add_ps(r, rows[3]) : r;
+	}
+
+	inline void Store(glm::vec3& out, __m128 v)
+	{
+		alignas(16) float tmp[4];
+		_mm_store_ps(tmp, v);
+		std::memcpy(&out, tmp, sizeof(glm::vec3));
+	}
+
+	inline __m128 Normalize(__m128 v)
+	{
+		const auto sq = _mm_mul_ps(v, v);
+		alignas(16) float s[4];
+		_mm_store_ps(s, sq);
+		const auto len = std::sqrt(s[0] + s[1] + s[2]);
+		return _mm_div_ps(v, _mm_set1_ps(len));
+	}
+
+	void BakeRange(TriangleWithNormal* triangles, size_t begin, size_t end, const BakeMatrices& m)
+	{
+		__m128 rows[4], normalRows[3];
+		for (int i = 0; i < 4; i++)
+			rows[i] = _mm_loadu_ps(&m.rows[i].x);
+		for (int i = 0; i < 3; i++)
+			normalRows[i] = _mm_loadu_ps(&m.normalRows[i].x);
+
+		for (size_t i = begin; i < end; i++)
+		{
+			auto& t = triangles[i];
+			Store(t.p0, Transform(rows, t.p0, true));
+			Store(t.p1, Transform(rows, t.p1, true));
+			Store(t.p2, Transform(rows, t.p2, true));
+			Store(t.n0, Normalize(Transform(normalRows, t.n0, false)));
+			Store(t.n1, Normalize(Transform(normalRows, t.n1, false)));
+			Store(t.n2, Normalize(Transform(normalRows, t.n2, false)));
+		}
+	}
+#else
+	inline glm::vec3 Transform(const glm::vec4* rows, const glm::vec3& v, bool point)
+	{
+		const auto r = rows[0] * v.x + rows[1] * v.y + rows[2] * v.z;
+		return glm::vec3(point ? r + rows[3] : r);
+	}
+
+	void BakeRange(TriangleWithNormal* triangles, size_t begin, size_t end, const BakeMatrices& m)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			auto& t = triangles[i];
+			t.p0 = Transform(m.rows, t.p0, true);
+			t.p1 = Transform(m.rows, t.p1, true);
+			t.p2 = Transform(m.rows, t.p2, true);
+			t.n0 = glm::normalize(Transform(m.normalRows, t.n0, false));
+			t.n1 = glm::normalize(Transform(m.normalRows, t.n1, false));
+			t.n2 = glm::normalize(Transform(m.normalRows, t.n2, false));
+		}
+	}
+#endif
+}
+
+void BakeTransform(TriangleWithNormal* triangles, size_t count, const glm::mat4& transform)
+{
+	const auto m = MakeBakeMatrices(transform);
+	ParallelFor(count, [&](size_t begin, size_t end) { BakeRange(triangles, begin, end, m); });
+}
+
+void BakeTransform(TriangleWithNormalList& outTriangles, const glm::mat4& transform)
+{
+	BakeTransform(outTriangles.data(), outTriangles.size(), transform);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Triangle.h"
+
+// Applique une transformation statique une fois pour toutes aux sommets, avec la même convention que shader.vert
+// (vec4(position, 1.0) * transform). Les normales sont transformées par l'inverse transposée puis renormalisées.
+// Le maillage peut ensuite être dessiné avec une transformation identité.
+void BakeTransform(TriangleWithNormal* triangles, size_t count, const glm::mat4& transform);
+void BakeTransform(TriangleWithNormalList& outTriangles, const glm::mat4& transform);
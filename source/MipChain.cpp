@@ -0,0 +1,251 @@
+#include "MipChain.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define MIP_CHAIN_SSE 1
+#endif
+
+#include "Parallel.h"
+
+namespace
+{
+	// Flottants supplémentaires en fin de ligne : les pixels de 3 canaux sont lus et écrits par 4
+	const int Padding = 4;
+
+	// Noyau séparable de réduction par 2 : la sortie x lit les texels 2x + first + k
+	struct Kernel
+	{
+		int first;
+		std::vector<float> weights;
+	};
+
+	double BesselI0(double x)
+	{
+		double sum = 1.0, term = 1.0;
+		for (int k = 1; k < 20; k++)
+		{
+			term *= (x / (2.0 * k)) * (x / (2.0 * k));
+			sum += term;
+		}
+		return sum;
+	}
+
+	Kernel MakeKernel(MipFilter filter)
+	{
+		if (filter == MipFilter::Box)
+			return { 0, { 0.5f, 0.5f } };
+
+		// Centre de la sortie entre les texels 2x et 2x + 1 : les 6 prises sont à ±0.5, ±1.5, ±2.5 texels
+		const double pi = 3.14159265358979323846;
+		const double alpha = 4.0, radius = 3.0;
+		Kernel kernel{ -2, std::vector<float>(6) };
+		double sum = 0.0;
+		std::vector<double> w(6);
+		for (int k = 0; k < 6; k++)
+		{
+			const auto d = k - 2.5;
+			const auto x = pi * d * 0.5;
+			const auto sinc = std::sin(x) / x;
+			const auto t = d / radius;
+			w[k] = sinc * BesselI0(alpha * std::sqrt(1.0 - t * t)) / BesselI0(alpha);
+			sum += w[k];
+		}
+		for (int k = 0; k < 6; k++)
+			kernel.weights[k] = (float) (w[k] / sum);
+		return kernel;
+	}
+
+	const float* SrgbToLinearTable()
+	{
+		static const auto table = []
+		{
+			std::vector<float> t(256);
+			for (int i = 0; i < 256; i++)
+			{
+				const auto c = i / 255.0;
+				t[i] = (float) (c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+			}
+			return t;
+		}();
+		return table.data();
+	}
+
+	// Encodage sRGB indexé par la valeur linéaire quantifiée sur 12 bits
+	const uint8_t* LinearToSrgbTable()
+	{
+		static const auto table = []
+		{
+			std::vector<uint8_t> t(4096);
+			for (int i = 0; i < 4096; i++)
+			{
+				const auto l = i / 4095.0;
+				const auto c = l <= 0.0031308 ? l * 12.92 : 1.055 * std::pow(l, 1.0 / 2.4) - 0.055;
+				t[i] = (uint8_t) std::lround(std::min(1.0, std::max(0.0, c)) * 255.0);
+			}
+			return t;
+		}();
+		return table.data();
+	}
+
+	// Niveau en flottants linéaires, alpha laissé tel quel. Les valeurs viennent de l'arène de BuildMipChain
+	// et vivent jusqu'à la fin de la construction de la chaîne.
+	struct LinearLevel
+	{
+		int width, height;
+		float* values;
+	};
+
+	LinearLevel AllocateLevel(int width, int height, int channels, AssetArena& arena)
+	{
+		const auto size = (size_t) width * height * channels;
+		LinearLevel level{ width, height, arena.AllocateArray<float>(size + Padding) };
+		std::fill(level.values + size, level.values + size + Padding, 0.0f);
+		return level;
+	}
+
+	LinearLevel ToLinear(const TextureImage& image, AssetArena& arena)
+	{
+		const auto toLinear = SrgbToLinearTable();
+		const auto c = image.channels;
+
+		const auto level = AllocateLevel(image.width, image.height, c, arena);
+		ParallelFor(image.pixels.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+				level.values[i] = c == 4 && i % 4 == 3 ? image.pixels[i] / 255.0f : toLinear[image.pixels[i]];
+		}, 1 << 16);
+		return level;
+	}
+
+	TextureImage ToSrgb(const LinearLevel& level, int channels)
+	{
+		const auto toSrgb = LinearToSrgbTable();
+
+		TextureImage image;
+		image.width = level.width;
+		image.height = level.height;
+		image.channels = channels;
+		image.pixels.resize((size_t) level.width * level.height * channels);
+		ParallelFor(image.pixels.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const auto v = std::min(1.0f, std::max(0.0f, level.values[i]));
+				image.pixels[i] = channels == 4 && i % 4 == 3 ? (uint8_t) (v * 255.0f + 0.5f) : toSrgb[(int) (v * 4095.0f + 0.5f)];
+			}
+		}, 1 << 16);
+		return image;
+	}
+
+	// Passe verticale : row = somme des lignes pondérées, sur toute la largeur (données contiguës)
+	void FilterRows(const LinearLevel& src, int channels, int y, const Kernel& kernel, float* row)
+	{
+		const auto n = (size_t) src.width * channels;
+		std::fill(row, row + n, 0.0f);
+		for (size_t k = 0; k < kernel.weights.size(); k++)
+		{
+			const auto sy = std::min(std::max(2 * y + kernel.first + (int) k, 0), src.height - 1);
+			const auto in = src.values + (size_t) sy * n;
+			const auto w = kernel.weights[k];
+
+			size_t i = 0;
+#ifdef MIP_CHAIN_SSE
+			const auto vw = _mm_set1_ps(w);
+			for (; i + 4 <= n; i += 4)
+				_mm_storeu_ps(row + i, _mm_add_ps(_mm_loadu_ps(row + i), _mm_mul_ps(vw, _mm_loadu_ps(in + i))));
+#endif
+			for (; i < n; i++)
+				row[i] += w * in[i];
+		}
+	}
+
+	// Passe horizontale sur la ligne filtrée verticalement
+	void FilterColumns(const float* row, int srcWidth, int channels, const Kernel& kernel, float* out, int dstWidth)
+	{
+		for (int x = 0; x < dstWidth; x++)
+		{
+			auto o = out + (size_t) x * channels;
+#ifdef MIP_CHAIN_SSE
+			if (channels >= 3)
+			{
+				// 3 canaux : le 4e flottant déborde sur le pixel suivant, réécrit à l'itération suivante
+				auto sum = _mm_setzero_ps();
+				for (size_t k = 0; k < kernel.weights.size(); k++)
+				{
+					const auto sx = std::min(std::max(2 * x + kernel.first + (int) k, 0), srcWidth - 1);
+					sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(kernel.weights[k]), _mm_loadu_ps(row + (size_t) sx * channels)));
+				}
+				_mm_storeu_ps(o, sum);
+				continue;
+			}
+#endif
+			for (int c = 0; c < channels; c++)
+			{
+				auto sum = 0.0f;
+				for (size_t k = 0; k < kernel.weights.size(); k++)
+				{
+					const auto sx = std::min(std::max(2 * x + kernel.first + (int) k, 0), srcWidth - 1);
+					sum += kernel.weights[k] * row[(size_t) sx * channels + c];
+				}
+				o[c] = sum;
+			}
+		}
+	}
+
+	LinearLevel Downsample(const LinearLevel& src, int channels, const Kernel& kernel, AssetArena& arena)
+	{
+		const auto dst = AllocateLevel(std::max(1, src.width / 2), std::max(1, src.height / 2), channels, arena);
+
+		ParallelFor(dst.height, [&](size_t begin, size_t end)
+		{
+			// Sortie dans une ligne locale : le débordement de la passe horizontale ne touche pas la ligne d'une autre tranche
+			std::vector<float> row((size_t) src.width * channels + Padding);
+			std::vector<float> out((size_t) dst.width * channels + Padding);
+			for (auto y = begin; y < end; y++)
+			{
+				FilterRows(src, channels, (int) y, kernel, row.data());
+				FilterColumns(row.data(), src.width, channels, kernel, out.data(), dst.width);
+				std::copy(out.begin(), out.end() - Padding, dst.values + y * dst.width * channels);
+			}
+		}, 16);
+		return dst;
+	}
+}
+
+int MipLevelCount(int width, int height)
+{
+	auto levels = 1;
+	for (auto size = std::max(width, height); size > 1; size /= 2)
+		levels++;
+	return levels;
+}
+
+std::vector<TextureImage> BuildMipChain(const TextureImage& base, MipFilter filter)
+{
+	std::vector<TextureImage> levels;
+	if (base.width <= 0 || base.height <= 0)
+		return levels;
+
+	const auto count = MipLevelCount(base.width, base.height);
+	const auto kernel = MakeKernel(filter);
+
+	// Niveaux intermédiaires en flottants, tous libérés ensemble à la fin : un seul bloc de la taille de la chaîne
+	size_t linearBytes = 0;
+	for (int i = 0, w = base.width, h = base.height; i < count; i++, w = std::max(1, w / 2), h = std::max(1, h / 2))
+		linearBytes += ((size_t) w * h * base.channels + Padding) * sizeof(float) + 64;
+	AssetArena arena(MemoryCategory::CpuTexture, linearBytes);
+
+	levels.reserve(count);
+	levels.push_back(base);
+
+	auto current = ToLinear(base, arena);
+	for (int i = 1; i < count; i++)
+	{
+		current = Downsample(current, base.channels, kernel, arena);
+		levels.push_back(ToSrgb(current, base.channels));
+	}
+	return levels;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "AssetMemory.h"
+
+// Texels côté CPU : alignés et comptés dans le relevé mémoire
+using TextureBytes = std::vector<uint8_t, TrackedAllocator<uint8_t, MemoryCategory::CpuTexture>>;
+
+// Image 8 bits par canal, lignes contiguës sans remplissage
+struct TextureImage
+{
+	int width = 0;
+	int height = 0;
+	int channels = 0;
+	TextureBytes pixels;
+};
+
+enum class MipFilter
+{
+	Box,    // moyenne 2x2
+	Kaiser  // sinc fenêtrée de Kaiser sur 6 texels, plus net que Box
+};
+
+// Nombre de niveaux d'une chaîne complète jusqu'à 1x1
+int MipLevelCount(int width, int height);
+
+// Chaîne complète, niveau 0 compris (copie de base). Les canaux sont supposés sRGB : le filtrage se fait en
+// espace linéaire puis le résultat est ré-encodé, ce qui évite l'assombrissement des mips d'une moyenne en gamma.
+// Chaque niveau est calculé depuis le précédent gardé en flottants linéaires, les lignes sont réparties sur
+// les threads et filtrées en SSE quand il est disponible. Avec 4 canaux, le 4e (alpha) est filtré tel quel.
+std::vector<TextureImage> BuildMipChain(const TextureImage& base, MipFilter filter = MipFilter::Box);
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+
+#include "JobSystem.h"
+
+// Nombre de threads disponibles pour les traitements parallèles : ceux du pool commun, appelant compris
+inline size_t WorkerCount()
+{
+	return JobSystem::Instance().ThreadCount();
+}
+
+// Nombre de tranches à utiliser pour count éléments, avec au moins minPerChunk éléments par tranche
+inline size_t ChunkCount(size_t count, size_t minPerChunk = 4096)
+{
+	const auto byGrain = (count + minPerChunk - 1) / minPerChunk;
+	return std::max<size_t>(1, std::min(WorkerCount(), byGrain));
+}
+
+// Découpe [0, count) en nChunks tranches contiguës et appelle func(chunk, begin, end) sur chacune, dans le pool commun.
+// Le découpage ne dépend que de count et nChunks : deux appels successifs voient les mêmes tranches.
+// La dernière tranche est traitée par le thread appelant.
+template <typename F>
+void ParallelForChunks(size_t count, size_t nChunks, F&& func)
+{
+	JobSystem::Instance().ParallelForChunks(count, nChunks, std::forward<F>(func));
+}
+
+// Appelle func(begin, end) sur des tranches de [0, count) d'au moins minPerChunk éléments, réparties par le pool commun
+template <typename F>
+void ParallelFor(size_t count, F&& func, size_t minPerChunk = 4096)
+{
+	JobSystem::Instance().ParallelFor(count, std::forward<F>(func), minPerChunk);
+}
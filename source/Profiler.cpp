@@ -0,0 +1,262 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define PROFILER_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_TSC 1
+#endif
+
+namespace
+{
+	uint64_t SteadyNs()
+	{
+		return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	uint64_t Ticks()
+	{
+#ifdef PROFILER_TSC
+		return __rdtsc();
+#else
+		return SteadyNs();
+#endif
+	}
+
+	void AppendEscaped(std::string& out, const char* text)
+	{
+		for (auto p = text; *p; p++)
+		{
+			if (*p == '"' || *p == '\\')
+				out += '\\';
+			if ((unsigned char) *p >= 0x20)
+				out += *p;
+		}
+	}
+
+	// Microsecondes avec trois décimales : trace_event attend des µs mais garde la précision des ns
+	void AppendMicroseconds(std::string& out, uint64_t ns)
+	{
+		char text[32];
+		std::snprintf(text, sizeof(text), "%llu.%03llu", (unsigned long long) (ns / 1000), (unsigned long long) (ns % 1000));
+		out += text;
+	}
+}
+
+// Anneau prêté au thread pour sa durée de vie ; rendu à sa fin pour être repris par un autre thread
+struct Profiler::RingLease
+{
+	ThreadRing* ring = nullptr;
+
+	~RingLease()
+	{
+		if (ring)
+			ring->free.store(true, std::memory_order_release);
+	}
+};
+
+std::atomic<bool> Profiler::enabled{ true };
+
+Profiler& Profiler::Instance()
+{
+	static Profiler profiler;
+	return profiler;
+}
+
+Profiler::Profiler()
+	: startNs(SteadyNs()), startTicks(Ticks()), history(HistoryCapacity)
+{
+	trackNames[GpuTrack] = "GPU";
+
+#ifdef PROFILER_TSC
+	// Premier rapport sur 1 ms ; Collect le précise ensuite sur toute la durée écoulée
+	while (SteadyNs() - startNs < 1000000)
+	{
+	}
+	Calibrate();
+#endif
+}
+
+void Profiler::Calibrate()
+{
+#ifdef PROFILER_TSC
+	const auto ticks = Ticks() - startTicks;
+	if (ticks > 0)
+		nsPerTick.store((double) (SteadyNs() - startNs) / ticks, std::memory_order_relaxed);
+#endif
+}
+
+uint64_t Profiler::Now() const
+{
+	return (uint64_t) ((Ticks() - startTicks) * nsPerTick.load(std::memory_order_relaxed));
+}
+
+uint32_t& Profiler::Depth()
+{
+	thread_local uint32_t depth = 0;
+	return depth;
+}
+
+Profiler::ThreadRing& Profiler::Ring()
+{
+	thread_local RingLease lease;
+	if (lease.ring)
+		return *lease.ring;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto& ring : rings)
+	{
+		auto expected = true;
+		if (ring->free.compare_exchange_strong(expected, false, std::memory_order_acquire))
+		{
+			lease.ring = ring.get();
+			return *lease.ring;
+		}
+	}
+
+	rings.push_back(std::make_unique<ThreadRing>());
+	rings.back()->track = (uint32_t) rings.size() - 1;
+	lease.ring = rings.back().get();
+	if (trackNames.find(lease.ring->track) == trackNames.end())
+		trackNames[lease.ring->track] = "Thread " + std::to_string(lease.ring->track);
+	return *lease.ring;
+}
+
+uint32_t Profiler::ThreadTrack()
+{
+	return Ring().track;
+}
+
+void Profiler::NameTrack(uint32_t track, std::string name)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	trackNames[track] = std::move(name);
+}
+
+void Profiler::Push(const ProfileEvent& event)
+{
+	Push(Ring(), event);
+}
+
+void Profiler::Push(ThreadRing& ring, const ProfileEvent& event)
+{
+	// Un seul producteur par anneau : head n'est écrit que par ce thread, tail n'avance que dans Collect
+	const auto head = ring.head.load(std::memory_order_relaxed);
+	if (head - ring.tail.load(std::memory_order_acquire) >= RingCapacity)
+	{
+		dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	ring.events[head % RingCapacity] = event;
+	ring.head.store(head + 1, std::memory_order_release);
+}
+
+void Profiler::Record(const char* name, uint64_t beginNs, uint32_t depth)
+{
+	auto& ring = Ring();
+	Push(ring, { name, beginNs, Now(), ring.track, depth });
+}
+
+size_t Profiler::Collect()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	Calibrate();
+
+	size_t collected = 0;
+	for (auto& ring : rings)
+	{
+		const auto tail = ring->tail.load(std::memory_order_relaxed);
+		const auto head = ring->head.load(std::memory_order_acquire);
+		for (auto i = tail; i != head; i++)
+			history[historyHead++ % HistoryCapacity] = ring->events[i % RingCapacity];
+
+		ring->tail.store(head, std::memory_order_release);
+		collected += (size_t) (head - tail);
+	}
+	return collected;
+}
+
+std::vector<ProfileEvent> Profiler::History() const
+{
+	if (historyHead <= HistoryCapacity)
+		return std::vector<ProfileEvent>(history.begin(), history.begin() + (ptrdiff_t) historyHead);
+
+	// L'anneau a fait le tour : le plus ancien est à la prochaine place à écrire
+	const auto oldest = history.begin() + (ptrdiff_t) (historyHead % HistoryCapacity);
+	std::vector<ProfileEvent> events(oldest, history.end());
+	events.insert(events.end(), history.begin(), oldest);
+	return events;
+}
+
+std::vector<ProfileEvent> Profiler::Events() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return History();
+}
+
+void Profiler::Clear()
+{
+	Collect();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	historyHead = 0;
+}
+
+ProfilerStats Profiler::Stats() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	const auto overwritten = historyHead > HistoryCapacity ? historyHead - HistoryCapacity : 0;
+	return { historyHead, dropped.load(std::memory_order_relaxed), overwritten };
+}
+
+bool Profiler::ExportChromeTrace(const std::string& path)
+{
+	Collect();
+
+	std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		// Les événements "X" d'une même piste s'emboîtent d'après leurs dates : l'ordre de début suffit
+		auto events = History();
+		std::stable_sort(events.begin(), events.end(), [](const ProfileEvent& a, const ProfileEvent& b)
+		{
+			return a.track != b.track ? a.track < b.track : a.beginNs != b.beginNs ? a.beginNs < b.beginNs : a.depth < b.depth;
+		});
+
+		for (const auto& [track, name] : trackNames)
+		{
+			json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(track) + ",\"args\":{\"name\":\"";
+			AppendEscaped(json, name.c_str());
+			json += "\"}},\n";
+		}
+
+		for (const auto& event : events)
+		{
+			json += "{\"name\":\"";
+			AppendEscaped(json, event.name);
+			json += event.track == GpuTrack ? "\",\"cat\":\"gpu\"" : "\",\"cat\":\"cpu\"";
+			json += ",\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(event.track) + ",\"ts\":";
+			AppendMicroseconds(json, event.beginNs);
+			json += ",\"dur\":";
+			AppendMicroseconds(json, event.endNs > event.beginNs ? event.endNs - event.beginNs : 0);
+			json += "},\n";
+		}
+	}
+	// Pas de virgule après le dernier élément
+	json.erase(json.size() - 2);
+	json += "\n]}\n";
+
+	const auto file = std::fopen(path.c_str(), "wb");
+	if (!file)
+		return false;
+
+	const auto ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+	return std::fclose(file) == 0 && ok;
+}
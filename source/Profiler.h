@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Intervalle mesuré, en nanosecondes depuis le démarrage du profiler. name doit vivre jusqu'à l'export
+// (littéral ou chaîne statique) : seul le pointeur est copié dans l'anneau.
+struct ProfileEvent
+{
+	const char* name;
+	uint64_t beginNs;
+	uint64_t endNs;
+	uint32_t track; // piste de la trace : un thread, ou GpuTrack
+	uint32_t depth; // profondeur d'imbrication sur la piste
+};
+
+struct ProfilerStats
+{
+	uint64_t recorded = 0;
+	uint64_t dropped = 0;     // événements perdus parce que l'anneau du thread était plein
+	uint64_t overwritten = 0; // plus anciens événements remplacés dans l'historique borné
+};
+
+// Profiler hiérarchique : chaque thread écrit ses intervalles dans son propre anneau (un producteur, un
+// consommateur, sans verrou), Collect les rassemble depuis n'importe quel thread et ExportChromeTrace les écrit au
+// format trace_event de chrome://tracing et Perfetto. Ne dépend pas d'OpenGL ; les mesures GPU viennent de GpuProfiler.
+// Les anneaux des threads terminés sont réutilisés par les suivants, avec leur piste.
+// L'historique est lui aussi un anneau alloué au démarrage : seuls les HistoryCapacity derniers événements sont
+// gardés, la mémoire et la trace ne grossissent pas avec la durée de la session.
+class Profiler
+{
+public:
+	static constexpr size_t RingCapacity = 16384;
+	static constexpr size_t HistoryCapacity = 1 << 18; // 8 Mo, plusieurs minutes à 60 fps
+	static constexpr uint32_t GpuTrack = 0xFFFF;
+
+	static Profiler& Instance();
+
+	static bool Enabled() { return enabled.load(std::memory_order_relaxed); }
+	static void SetEnabled(bool e) { enabled.store(e, std::memory_order_relaxed); }
+
+	// Horloge des événements, en ns depuis le démarrage du profiler. Sur x86 c'est le compteur de cycles (rdtsc,
+	// quelques ns au lieu de quelques dizaines pour steady_clock), converti avec un rapport mesuré contre
+	// steady_clock au démarrage puis affiné à chaque Collect ; ailleurs, steady_clock.
+	uint64_t Now() const;
+
+	// Ajoute un événement à l'anneau du thread appelant ; perdu et compté si l'anneau est plein
+	void Push(const ProfileEvent& event);
+
+	// Push d'un intervalle terminé maintenant, sur la piste du thread appelant
+	void Record(const char* name, uint64_t beginNs, uint32_t depth);
+
+	// Piste du thread appelant, et nom affiché pour une piste
+	uint32_t ThreadTrack();
+	void NameTrack(uint32_t track, std::string name);
+
+	// Vide les anneaux dans l'historique ; à appeler régulièrement (une fois par frame) pour ne rien perdre.
+	// N'alloue pas.
+	size_t Collect();
+
+	// Collect, puis écrit tout l'historique en JSON trace_event. Faux si le fichier ne peut pas être écrit.
+	bool ExportChromeTrace(const std::string& path);
+
+	// Copie de l'historique collecté, du plus ancien au plus récent
+	std::vector<ProfileEvent> Events() const;
+	void Clear();
+
+	ProfilerStats Stats() const;
+
+	// Profondeur courante du thread appelant, tenue par ProfileScope
+	static uint32_t& Depth();
+
+private:
+	Profiler();
+
+	struct ThreadRing
+	{
+		std::unique_ptr<ProfileEvent[]> events{ new ProfileEvent[RingCapacity] };
+		alignas(64) std::atomic<uint64_t> head{ 0 }; // écrit par le thread propriétaire
+		alignas(64) std::atomic<uint64_t> tail{ 0 }; // écrit par Collect
+		std::atomic<bool> free{ false };
+		uint32_t track = 0;
+	};
+
+	struct RingLease;
+	ThreadRing& Ring();
+	void Push(ThreadRing& ring, const ProfileEvent& event);
+	// Événements gardés, du plus ancien au plus récent ; mutex pris
+	std::vector<ProfileEvent> History() const;
+
+	static std::atomic<bool> enabled;
+
+	void Calibrate();
+
+	uint64_t startNs;    // steady_clock au démarrage
+	uint64_t startTicks; // compteur de cycles au démarrage
+	std::atomic<double> nsPerTick{ 1.0 };
+	std::atomic<uint64_t> dropped{ 0 };
+
+	mutable std::mutex mutex; // anneaux, historique et noms ; jamais pris par Push sauf au premier appel d'un thread
+	std::vector<std::unique_ptr<ThreadRing>> rings;
+	std::vector<ProfileEvent> history; // anneau de HistoryCapacity événements
+	uint64_t historyHead = 0;          // événements collectés depuis Clear
+	std::map<uint32_t, std::string> trackNames;
+};
+
+// Mesure la durée de vie de l'objet sur le thread courant :
+//   { const ProfileScope scope("Light update"); ... }
+// Si le profiler est désactivé, le coût se limite à une lecture atomique.
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char* name)
+		: name(name), enabled(Profiler::Enabled())
+	{
+		if (enabled)
+		{
+			depth = Profiler::Depth()++;
+			begin = Profiler::Instance().Now();
+		}
+	}
+	~ProfileScope()
+	{
+		if (enabled)
+		{
+			Profiler::Instance().Record(name, begin, depth);
+			Profiler::Depth()--;
+		}
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	const char* name;
+	bool enabled;
+	uint32_t depth = 0;
+	uint64_t begin = 0;
+};
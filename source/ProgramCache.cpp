@@ -0,0 +1,128 @@
+#include "ProgramCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+#include "Hash.h"
+
+namespace
+{
+	// En-tête des fichiers de cache, suivi de size octets de binaire
+	struct FileHeader
+	{
+		char magic[4];
+		uint32_t formatVersion;
+		uint64_t key;
+		uint32_t binaryFormat;
+		uint32_t size;
+		uint64_t checksum;
+	};
+
+	const char Magic[4] = { 'S', 'I', 'P', 'B' };
+	const uint32_t FormatVersion = 1;
+
+	// La longueur précède chaque chaîne : ("ab", "c") et ("a", "bc") ne se confondent pas
+	uint64_t HashString(uint64_t h, const std::string& s)
+	{
+		const uint64_t length = s.size();
+		h = Fnv1a(h, &length, sizeof(length));
+		return Fnv1a(h, s.data(), s.size());
+	}
+}
+
+uint64_t MakeProgramCacheKey(const std::vector<std::string>& sources,
+	const std::string& vendor, const std::string& renderer, const std::string& version,
+	const std::vector<std::string>& defines)
+{
+	auto h = Fnv1a(FnvOffset, &FormatVersion, sizeof(FormatVersion));
+	for (auto&& source : sources)
+		h = HashString(h, source);
+
+	h = HashString(h, vendor);
+	h = HashString(h, renderer);
+	h = HashString(h, version);
+
+	for (auto&& define : defines)
+		h = HashString(h, define);
+
+	return h;
+}
+
+ProgramCache::ProgramCache(std::string directory)
+	: directory(std::move(directory))
+{
+}
+
+std::string ProgramCache::PathFor(uint64_t key) const
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long) key);
+	return (std::filesystem::path(directory) / name).string();
+}
+
+bool ProgramCache::Load(uint64_t key, ProgramBinary& outBinary) const
+{
+	std::ifstream file(PathFor(key), std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	FileHeader header;
+	if (!file.read((char*) &header, sizeof(header)))
+		return false;
+
+	if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.formatVersion != FormatVersion || header.key != key)
+		return false;
+
+	ProgramBinary binary;
+	binary.format = header.binaryFormat;
+	binary.data.resize(header.size);
+	if (!file.read((char*) binary.data.data(), header.size))
+		return false;
+
+	// Rien ne doit suivre le binaire, et son contenu doit correspondre à la somme de contrôle
+	if (file.peek() != std::ifstream::traits_type::eof() || Fnv1a(FnvOffset, binary.data.data(), binary.data.size()) != header.checksum)
+		return false;
+
+	outBinary = std::move(binary);
+	return true;
+}
+
+bool ProgramCache::Store(uint64_t key, const ProgramBinary& binary) const
+{
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+
+	// Écriture dans un fichier temporaire puis renommage : un lecteur ne voit jamais de fichier à moitié écrit
+	const auto path = PathFor(key);
+	const auto temporary = path + ".tmp";
+	{
+		std::ofstream file(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return false;
+
+		FileHeader header;
+		std::memcpy(header.magic, Magic, sizeof(Magic));
+		header.formatVersion = FormatVersion;
+		header.key = key;
+		header.binaryFormat = binary.format;
+		header.size = (uint32_t) binary.data.size();
+		header.checksum = Fnv1a(FnvOffset, binary.data.data(), binary.data.size());
+
+		file.write((const char*) &header, sizeof(header));
+		file.write((const char*) binary.data.data(), binary.data.size());
+		if (!file)
+			return false;
+	}
+
+	std::filesystem::rename(temporary, path, error);
+	return !error;
+}
+
+void ProgramCache::Invalidate(uint64_t key) const
+{
+	std::error_code error;
+	std::filesystem::remove(PathFor(key), error);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Programme GPU sérialisé par glGetProgramBinary
+struct ProgramBinary
+{
+	uint32_t format = 0;
+	std::vector<uint8_t> data;
+};
+
+// Clé d'un programme : sources des shaders, identité du driver et defines injectés.
+// Tout changement de l'un d'eux donne une autre clé, donc un autre fichier.
+uint64_t MakeProgramCacheKey(const std::vector<std::string>& sources,
+	const std::string& vendor, const std::string& renderer, const std::string& version,
+	const std::vector<std::string>& defines = {});
+
+// Cache disque des binaires de programmes, un fichier par clé. Indépendant d'OpenGL.
+// Un fichier tronqué, corrompu ou d'une autre version de format est ignoré par Load.
+class ProgramCache
+{
+public:
+	explicit ProgramCache(std::string directory);
+
+	bool Load(uint64_t key, ProgramBinary& outBinary) const;
+	// Renvoie faux si le fichier n'a pas pu être écrit ; le cache reste optionnel
+	bool Store(uint64_t key, const ProgramBinary& binary) const;
+	// À appeler quand le driver refuse un binaire chargé (mise à jour du driver...)
+	void Invalidate(uint64_t key) const;
+
+	std::string PathFor(uint64_t key) const;
+
+private:
+	std::string directory;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "FrameArena.h"
+#include "Parallel.h"
+
+// Tri par base 256 (LSD) parallèle et stable d'éléments portant un champ uint64_t key.
+// Les passes où tous les octets sont identiques sont sautées. scratch sert de tampon de même taille ;
+// les histogrammes viennent de arena s'il est donné, sinon du tas.
+template <typename T>
+void RadixSortByKey(std::vector<T>& items, std::vector<T>& scratch, LinearArena* arena = nullptr)
+{
+	const auto n = items.size();
+	if (n < 2)
+		return;
+
+	scratch.resize(n);
+	auto* src = &items;
+	auto* dst = &scratch;
+
+	const auto nChunks = ChunkCount(n, 16384);
+	ArenaVector<size_t> offsets(nChunks * 256, 0, arena);
+
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		// Histogramme de l'octet courant, par tranche
+		std::fill(offsets.begin(), offsets.end(), 0);
+		ParallelForChunks(n, nChunks, [&](size_t chunk, size_t begin, size_t end)
+		{
+			auto histogram = offsets.data() + chunk * 256;
+			for (size_t i = begin; i < end; i++)
+				histogram[((*src)[i].key >> shift) & 0xFF]++;
+		});
+
+		// Si toutes les clés ont le même octet, la passe ne changerait rien
+		bool uniform = false;
+		for (size_t digit = 0; digit < 256 && !uniform; digit++)
+		{
+			size_t total = 0;
+			for (size_t chunk = 0; chunk < nChunks; chunk++)
+				total += offsets[chunk * 256 + digit];
+			uniform = total == n;
+		}
+
+		if (uniform)
+			continue;
+
+		// Position de départ de chaque (octet, tranche) : les tranches d'un même octet se suivent dans l'ordre, ce qui garde le tri stable
+		size_t position = 0;
+		for (size_t digit = 0; digit < 256; digit++)
+		{
+			for (size_t chunk = 0; chunk < nChunks; chunk++)
+			{
+				const auto count = offsets[chunk * 256 + digit];
+				offsets[chunk * 256 + digit] = position;
+				position += count;
+			}
+		}
+
+		ParallelForChunks(n, nChunks, [&](size_t chunk, size_t begin, size_t end)
+		{
+			auto cursors = offsets.data() + chunk * 256;
+			for (size_t i = begin; i < end; i++)
+			{
+				const auto& item = (*src)[i];
+				(*dst)[cursors[(item.key >> shift) & 0xFF]++] = item;
+			}
+		});
+
+		std::swap(src, dst);
+	}
+
+	if (src != &items)
+		items.swap(scratch);
+}
@@ -0,0 +1,22 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "RadixSort.h"
+
+uint64_t MakeSortKey(uint32_t program, uint32_t material, uint32_t mesh, float depth)
+{
+	const auto maxDepth = (1u << 24) - 1;
+	const auto d = std::isfinite(depth) ? std::clamp(depth, 0.0f, 1.0f) : 1.0f;
+
+	return ((uint64_t) (program & 0xFF) << 56)
+		| ((uint64_t) (material & 0xFFFF) << 40)
+		| ((uint64_t) (mesh & 0xFFFF) << 24)
+		| (uint64_t) (d * maxDepth);
+}
+
+void RenderQueue::Sort(LinearArena* arena)
+{
+	RadixSortByKey(commands, scratch, arena);
+}
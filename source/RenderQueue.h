@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "FrameArena.h"
+
+// Clé de tri 64 bits d'un draw call, des bits de poids fort aux bits de poids faible :
+// programme (8 bits) | matériau (16 bits) | maillage (16 bits) | profondeur (24 bits).
+// Trier par clé regroupe les draws qui partagent le même état et les ordonne d'avant en arrière.
+// La clé ne sert qu'à l'ordre : au-delà de ces tailles les identifiants sont tronqués, deux états peuvent partager
+// un groupe, mais l'état réel de chaque draw est relu à la soumission (DrawState).
+uint64_t MakeSortKey(uint32_t program, uint32_t material, uint32_t mesh, float depth);
+
+// État complet d'un draw, sans troncature
+struct DrawState
+{
+	uint32_t program;
+	uint32_t material;
+	uint32_t mesh;
+};
+
+struct RenderCommand
+{
+	uint64_t key;
+	uint32_t entity;
+};
+
+struct SubmitStats
+{
+	size_t draws = 0;
+	size_t programChanges = 0;
+	size_t materialChanges = 0;
+	size_t meshChanges = 0;
+};
+
+// File de draw calls enregistrés pendant la frame, triés par clé avant d'être soumis.
+// Indépendante d'OpenGL : la soumission appelle des fonctions fournies par l'appelant.
+class RenderQueue
+{
+public:
+	void Clear() { commands.clear(); }
+	void Reserve(size_t count) { commands.reserve(count); }
+	void Push(uint64_t key, uint32_t entity) { commands.push_back({ key, entity }); }
+
+	// Tri par base 256 (LSD) parallèle et stable ; les passes où tous les octets sont identiques sont sautées.
+	// Les histogrammes viennent de arena s'il est donné, sinon du tas.
+	void Sort(LinearArena* arena = nullptr);
+
+	const std::vector<RenderCommand>& Commands() const { return commands; }
+
+	// Parcourt les commandes triées et n'appelle bindProgram, bindMaterial et bindMesh qu'en cas de changement.
+	// stateOf(entity) renvoie le DrawState de l'entité ; changer de programme oblige à redéfinir le matériau et le maillage.
+	template <typename StateOf, typename BindProgram, typename BindMaterial, typename BindMesh, typename Draw>
+	SubmitStats Submit(StateOf&& stateOf, BindProgram&& bindProgram, BindMaterial&& bindMaterial, BindMesh&& bindMesh, Draw&& draw) const
+	{
+		SubmitStats stats;
+		bool bound = false;
+		DrawState current{ 0, 0, 0 };
+
+		for (auto&& command : commands)
+		{
+			const DrawState state = stateOf(command.entity);
+
+			const auto newProgram = !bound || state.program != current.program;
+			if (newProgram)
+			{
+				current.program = state.program;
+				bindProgram(current.program);
+				stats.programChanges++;
+			}
+
+			if (newProgram || state.material != current.material)
+			{
+				current.material = state.material;
+				bindMaterial(current.material);
+				stats.materialChanges++;
+			}
+
+			if (newProgram || state.mesh != current.mesh)
+			{
+				current.mesh = state.mesh;
+				bindMesh(current.mesh);
+				stats.meshChanges++;
+			}
+
+			bound = true;
+			draw(command);
+			stats.draws++;
+		}
+
+		return stats;
+	}
+
+private:
+	std::vector<RenderCommand> commands;
+	std::vector<RenderCommand> scratch;
+};
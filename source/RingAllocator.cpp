@@ -0,0 +1,79 @@
+#include "RingAllocator.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+RingAllocator::RingAllocator(size_t bytesPerFrame, size_t frameCount, size_t alignment, FenceCallbacks fences)
+	: bytesPerFrame(bytesPerFrame)
+	, alignment(alignment)
+	, fences(std::move(fences))
+	, fenceHandles(frameCount, nullptr)
+{
+	if (frameCount == 0 || alignment == 0)
+		throw std::invalid_argument("RingAllocator: frame count and alignment must be non zero");
+
+	// Chaque section commence sur un offset aligné
+	this->bytesPerFrame = (bytesPerFrame + alignment - 1) / alignment * alignment;
+
+	// Commence sur la dernière section pour que la première frame utilise la section 0
+	frame = frameCount - 1;
+}
+
+RingAllocator::~RingAllocator()
+{
+	for (auto fence : fenceHandles)
+	{
+		if (fence && this->fences.release)
+			this->fences.release(fence);
+	}
+}
+
+void RingAllocator::BeginFrame()
+{
+	if (inFrame)
+		throw std::logic_error("RingAllocator: BeginFrame called twice without EndFrame");
+
+	frame = (frame + 1) % fenceHandles.size();
+	cursor = 0;
+	inFrame = true;
+	stats.frames++;
+
+	auto& fence = fenceHandles[frame];
+	if (fence)
+	{
+		if (fences.wait(fence))
+			stats.stalls++;
+
+		fences.release(fence);
+		fence = nullptr;
+	}
+}
+
+void RingAllocator::EndFrame()
+{
+	if (!inFrame)
+		throw std::logic_error("RingAllocator: EndFrame called without BeginFrame");
+
+	fenceHandles[frame] = fences.insert();
+	stats.peakFrameBytes = std::max(stats.peakFrameBytes, cursor);
+	inFrame = false;
+}
+
+size_t RingAllocator::Allocate(size_t size)
+{
+	if (!inFrame)
+		throw std::logic_error("RingAllocator: Allocate called outside of a frame");
+
+	const auto offset = (cursor + alignment - 1) / alignment * alignment;
+	if (offset + size > bytesPerFrame)
+	{
+		stats.overflows++;
+		return InvalidOffset;
+	}
+
+	stats.allocations++;
+	stats.bytes += offset + size - cursor;
+	cursor = offset + size;
+	return frame * bytesPerFrame + offset;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// Barrières GPU vues par l'allocateur. Avec OpenGL ce sont des GLsync ; sans contexte, n'importe quel jeton.
+struct FenceCallbacks
+{
+	std::function<void*()> insert;       // pose une barrière après les commandes déjà soumises
+	std::function<bool(void*)> wait;     // attend la barrière, renvoie vrai s'il a fallu bloquer
+	std::function<void(void*)> release;  // détruit la barrière
+};
+
+struct RingAllocatorStats
+{
+	size_t frames = 0;
+	size_t allocations = 0;
+	size_t bytes = 0;        // octets alloués, alignement compris
+	size_t stalls = 0;       // attentes qui ont réellement bloqué le CPU
+	size_t overflows = 0;    // allocations refusées faute de place dans la section
+	size_t peakFrameBytes = 0;
+};
+
+// Allocateur linéaire dans un buffer découpé en frameCount sections, une par frame en vol.
+// Une section n'est réutilisée qu'une fois franchie la barrière posée à la fin de la frame qui l'a remplie,
+// ce qui permet d'écrire dans un buffer mappé en permanence pendant que le GPU lit les frames précédentes.
+// Ne dépend pas d'OpenGL : seules les barrières passent par les callbacks.
+class RingAllocator
+{
+public:
+	static constexpr size_t InvalidOffset = (size_t) -1;
+
+	RingAllocator(size_t bytesPerFrame, size_t frameCount, size_t alignment, FenceCallbacks fences);
+	~RingAllocator();
+
+	RingAllocator(const RingAllocator&) = delete;
+	RingAllocator& operator=(const RingAllocator&) = delete;
+
+	// Passe à la section suivante en attendant que le GPU ait fini de la lire
+	void BeginFrame();
+	// Pose la barrière de la section courante
+	void EndFrame();
+
+	// Offset dans le buffer complet, multiple de l'alignement, ou InvalidOffset si la section est pleine
+	size_t Allocate(size_t size);
+
+	size_t Capacity() const { return bytesPerFrame * fenceHandles.size(); }
+	size_t CurrentFrame() const { return frame; }
+	const RingAllocatorStats& Stats() const { return stats; }
+
+private:
+	size_t bytesPerFrame;
+	size_t alignment;
+	FenceCallbacks fences;
+	std::vector<void*> fenceHandles; // barrière en attente par section, nullptr si aucune
+
+	size_t frame = 0;
+	size_t cursor = 0;
+	bool inFrame = false;
+	RingAllocatorStats stats;
+};
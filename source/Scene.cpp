@@ -0,0 +1,111 @@
+#include "Scene.h"
+
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SCENE_SSE 1
+#endif
+
+#include "Parallel.h"
+
+namespace
+{
+	// Rebond sur un axe pour count entités : position += vitesse * dt, puis inversion de la vitesse hors limites
+	void UpdateAxis(float* position, float* velocity, const float* limit, size_t count, float dt)
+	{
+		size_t i = 0;
+
+#ifdef SCENE_SSE
+		const auto step = _mm_set1_ps(dt);
+		const auto signBit = _mm_set1_ps(-0.0f);
+		for (; i + 4 <= count; i += 4)
+		{
+			auto p = _mm_loadu_ps(position + i);
+			auto v = _mm_loadu_ps(velocity + i);
+			const auto l = _mm_loadu_ps(limit + i);
+
+			p = _mm_add_ps(p, _mm_mul_ps(v, step));
+
+			// Hors limites si |p| > l, sans branchement : on bascule le bit de signe de la vitesse
+			const auto outside = _mm_cmpgt_ps(_mm_andnot_ps(signBit, p), l);
+			v = _mm_xor_ps(v, _mm_and_ps(outside, signBit));
+
+			_mm_storeu_ps(position + i, p);
+			_mm_storeu_ps(velocity + i, v);
+		}
+#endif
+
+		for (; i < count; i++)
+		{
+			position[i] += velocity[i] * dt;
+			if (position[i] < -limit[i] || limit[i] < position[i])
+			{
+				velocity[i] *= -1;
+			}
+		}
+	}
+}
+
+uint32_t Scene::AddMaterial(const Material& material)
+{
+	materials.push_back(material);
+	return (uint32_t) (materials.size() - 1);
+}
+
+size_t Scene::AddEntity(uint32_t mesh, uint32_t material, const glm::mat4& transform, float radius, glm::vec2 translate, glm::vec2 velocity, glm::vec2 limit)
+{
+	translateX.push_back(translate.x);
+	translateY.push_back(translate.y);
+	velocityX.push_back(velocity.x);
+	velocityY.push_back(velocity.y);
+	limitX.push_back(limit.x);
+	limitY.push_back(limit.y);
+	transforms.push_back(transform);
+	radii.push_back(radius);
+	materialIndices.push_back(material);
+	meshes.push_back(mesh);
+
+	return meshes.size() - 1;
+}
+
+glm::vec4 Scene::ClipCenter(size_t i) const
+{
+	// vec4(0, 0, 0, 1) * transform + vec4(translate, 1.0) : composante w de chaque colonne plus la translation
+	const auto& m = transforms[i];
+	return glm::vec4(m[0].w + translateX[i], m[1].w + translateY[i], m[2].w, m[3].w + 1.0f);
+}
+
+bool Scene::IsVisible(size_t i) const
+{
+	const auto r = radii[i];
+	const auto center = ClipCenter(i);
+
+	return std::abs(center.x) - r <= center.w
+		&& std::abs(center.y) - r <= center.w
+		&& std::abs(center.z) - r <= center.w;
+}
+
+void Scene::Reserve(size_t count)
+{
+	translateX.reserve(count);
+	translateY.reserve(count);
+	velocityX.reserve(count);
+	velocityY.reserve(count);
+	limitX.reserve(count);
+	limitY.reserve(count);
+	transforms.reserve(count);
+	radii.reserve(count);
+	materialIndices.reserve(count);
+	meshes.reserve(count);
+}
+
+void Scene::Update(float dt)
+{
+	// Grosses tranches : le découpage ne vaut la peine qu'à partir de quelques dizaines de milliers d'entités
+	ParallelFor(Size(), [&](size_t begin, size_t end)
+	{
+		UpdateAxis(translateX.data() + begin, velocityX.data() + begin, limitX.data() + begin, end - begin, dt);
+		UpdateAxis(translateY.data() + begin, velocityY.data() + begin, limitY.data() + begin, end - begin, dt);
+	}, 32768);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Material.h"
+
+// Scène orientée données : chaque composante des entités est stockée dans son propre tableau contigu (SoA),
+// l'entité i étant l'indice i de chaque tableau. Aucune dépendance à OpenGL.
+struct Scene
+{
+	// Déplacement dans le plan de l'écran (uniform translate de shader.vert) et rebond sur les bords
+	std::vector<float> translateX, translateY;
+	std::vector<float> velocityX, velocityY; // unités par seconde
+	std::vector<float> limitX, limitY;
+
+	std::vector<glm::mat4> transforms;
+	std::vector<float> radii; // rayon englobant une fois transformé, pour le test de visibilité
+	std::vector<uint32_t> materialIndices;
+	std::vector<uint32_t> meshes; // identifiant de maillage (MeshHandle::id côté rendu)
+
+	std::vector<Material> materials;
+
+	uint32_t AddMaterial(const Material& material);
+
+	// Une vitesse nulle donne une entité immobile
+	size_t AddEntity(uint32_t mesh, uint32_t material, const glm::mat4& transform, float radius, glm::vec2 translate,
+		glm::vec2 velocity = glm::vec2(0.0f), glm::vec2 limit = glm::vec2(1.7f, 1.7f));
+
+	// Centre de l'entité en coordonnées de clip, comme le calcule shader.vert pour l'origine du maillage
+	glm::vec4 ClipCenter(size_t i) const;
+	// Vrai si la sphère englobante de l'entité recoupe le volume de clip -w <= x, y, z <= w
+	bool IsVisible(size_t i) const;
+
+	void Reserve(size_t count);
+	size_t Size() const { return meshes.size(); }
+
+	// Avance toutes les entités de dt secondes : la vitesse s'inverse sur un axe dès que l'entité sort de ses limites
+	void Update(float dt);
+};
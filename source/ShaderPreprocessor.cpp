@@ -0,0 +1,197 @@
+#include "ShaderPreprocessor.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#include "Hash.h"
+
+namespace
+{
+	// Reste de la ligne après la directive si la ligne commence par elle (espaces ignorés), nullptr sinon
+	const char* Directive(const std::string& line, const char* directive)
+	{
+		auto p = line.c_str();
+		while (*p == ' ' || *p == '\t')
+			p++;
+		if (*p++ != '#')
+			return nullptr;
+		while (*p == ' ' || *p == '\t')
+			p++;
+
+		const auto length = std::char_traits<char>::length(directive);
+		if (line.compare(p - line.c_str(), length, directive) != 0)
+			return nullptr;
+		p += length;
+		return *p == '\0' || *p == ' ' || *p == '\t' || *p == '"' || *p == '\r' ? p : nullptr;
+	}
+
+	size_t SourceIndex(ExpandedShader& out, const std::string& path)
+	{
+		const auto it = std::find(out.files.begin(), out.files.end(), path);
+		if (it != out.files.end())
+			return it - out.files.begin();
+
+		out.files.push_back(path);
+		return out.files.size() - 1;
+	}
+
+	void AppendLine(std::string& out, size_t line, size_t source)
+	{
+		out += "#line " + std::to_string(line) + " " + std::to_string(source) + "\n";
+	}
+}
+
+std::vector<ShaderDefines> MakePermutations(const std::vector<PermutationAxis>& axes)
+{
+	std::vector<ShaderDefines> permutations(1);
+	for (const auto& axis : axes)
+	{
+		std::vector<ShaderDefines> next;
+		next.reserve(permutations.size() * axis.values.size());
+		for (const auto& permutation : permutations)
+		{
+			for (const auto& value : axis.values)
+			{
+				next.push_back(permutation);
+				next.back().push_back({ axis.name, value });
+			}
+		}
+		permutations = std::move(next);
+	}
+	return permutations;
+}
+
+ShaderPreprocessor::ShaderPreprocessor(std::string includeDirectory)
+	: includeDirectory(std::move(includeDirectory))
+{
+}
+
+const ExpandedShader& ShaderPreprocessor::Expand(const std::string& path, const ShaderDefines& defines)
+{
+	auto key = path;
+	for (const auto& define : defines)
+		key += '\n' + define.name + '=' + define.value;
+
+	const auto cached = expanded.find(key);
+	if (cached != expanded.end())
+	{
+		hits++;
+		return cached->second;
+	}
+	misses++;
+
+	ExpandedShader shader;
+	Context context{ shader, {}, {} };
+	Append(context, path, &defines);
+	shader.hash = Fnv1a(FnvOffset, shader.source.data(), shader.source.size());
+
+	return expanded.emplace(std::move(key), std::move(shader)).first->second;
+}
+
+const std::string& ShaderPreprocessor::ReadFile(const std::string& path)
+{
+	const auto cached = files.find(path);
+	if (cached != files.end())
+		return cached->second;
+
+	std::ifstream file(path.c_str(), std::ios::in);
+	if (!file.good())
+	{
+		throw std::runtime_error("File not found: " + path);
+	}
+
+	std::ostringstream contents;
+	contents << file.rdbuf();
+	return files.emplace(path, contents.str()).first->second;
+}
+
+std::string ShaderPreprocessor::Resolve(const std::string& includer, const std::string& name) const
+{
+	const auto relative = std::filesystem::path(includer).parent_path() / name;
+	if (includeDirectory.empty() || std::filesystem::exists(relative))
+		return relative.lexically_normal().generic_string();
+
+	return (std::filesystem::path(includeDirectory) / name).lexically_normal().generic_string();
+}
+
+void ShaderPreprocessor::Append(Context& context, const std::string& path, const ShaderDefines* defines)
+{
+	if (std::find(context.stack.begin(), context.stack.end(), path) != context.stack.end())
+	{
+		throw std::runtime_error("Cyclic #include: " + path);
+	}
+
+	const auto& text = ReadFile(path);
+	const auto source = SourceIndex(context.out, path);
+	auto& out = context.out.source;
+	context.stack.push_back(path);
+
+	// Sans #version, les defines vont en tête du fichier racine
+	auto definesPending = defines != nullptr;
+	const auto appendDefines = [&](size_t nextLine)
+	{
+		for (const auto& define : *defines)
+			out += "#define " + define.name + " " + define.value + "\n";
+		AppendLine(out, nextLine, source);
+		definesPending = false;
+	};
+	if (definesPending && text.find("#version") == std::string::npos)
+		appendDefines(1);
+
+	std::istringstream lines(text);
+	std::string line;
+	for (size_t lineNumber = 1; std::getline(lines, line); lineNumber++)
+	{
+		if (const auto rest = Directive(line, "include"))
+		{
+			const auto open = std::string(rest).find('"');
+			const auto close = open == std::string::npos ? open : std::string(rest).find('"', open + 1);
+			if (close == std::string::npos)
+			{
+				throw std::runtime_error(path + "(" + std::to_string(lineNumber) + "): malformed #include");
+			}
+
+			const auto included = Resolve(path, std::string(rest + open + 1, rest + close));
+			if (std::find(context.once.begin(), context.once.end(), included) == context.once.end())
+			{
+				AppendLine(out, 1, SourceIndex(context.out, included));
+				Append(context, included, nullptr);
+				AppendLine(out, lineNumber + 1, source);
+			}
+			else
+			{
+				out += "\n";
+			}
+			continue;
+		}
+
+		if (const auto rest = Directive(line, "pragma"))
+		{
+			if (std::string(rest).find("once") != std::string::npos)
+			{
+				context.once.push_back(path);
+				out += "\n";
+				continue;
+			}
+		}
+
+		if (Directive(line, "version") && defines == nullptr)
+		{
+			// Seul le fichier racine porte la version
+			out += "\n";
+			continue;
+		}
+
+		out += line;
+		out += "\n";
+
+		if (definesPending && Directive(line, "version"))
+			appendDefines(lineNumber + 1);
+	}
+
+	context.stack.pop_back();
+}
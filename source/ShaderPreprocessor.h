@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// #define injecté dans une source GLSL
+struct ShaderDefine
+{
+	std::string name;
+	std::string value;
+};
+
+using ShaderDefines = std::vector<ShaderDefine>;
+
+// Dimension d'une permutation : un define et les valeurs qu'il peut prendre (ex. TEXTURED 0/1, LIGHT_COUNT 1/2/4)
+struct PermutationAxis
+{
+	std::string name;
+	std::vector<std::string> values;
+};
+
+// Produit cartésien des axes, dans l'ordre des axes puis des valeurs
+std::vector<ShaderDefines> MakePermutations(const std::vector<PermutationAxis>& axes);
+
+// Source GLSL développée, prête pour glShaderSource
+struct ExpandedShader
+{
+	std::string source;
+	uint64_t hash = 0;              // hash du texte développé : deux permutations identiques ont le même
+	std::vector<std::string> files; // fichiers lus ; l'indice est le numéro de source des directives #line
+};
+
+// Préprocesseur GLSL côté CPU, indépendant d'OpenGL : développe les #include "fichier" (chemin relatif au
+// fichier qui inclut, puis au dossier d'includes), respecte #pragma once et insère les defines juste après
+// #version. Des directives #line conservent les numéros de ligne des erreurs du driver.
+// Les fichiers lus et les sources développées sont gardés en cache pour toute la durée de vie de l'objet.
+class ShaderPreprocessor
+{
+public:
+	explicit ShaderPreprocessor(std::string includeDirectory = "");
+
+	// Lance std::runtime_error si un fichier est introuvable ou si les includes forment un cycle
+	const ExpandedShader& Expand(const std::string& path, const ShaderDefines& defines = {});
+
+	size_t CacheHits() const { return hits; }
+	size_t CacheMisses() const { return misses; }
+
+private:
+	struct Context
+	{
+		ExpandedShader& out;
+		std::vector<std::string> stack;
+		std::vector<std::string> once;
+	};
+
+	const std::string& ReadFile(const std::string& path);
+	std::string Resolve(const std::string& includer, const std::string& name) const;
+	void Append(Context& context, const std::string& path, const ShaderDefines* defines);
+
+	std::string includeDirectory;
+	std::map<std::string, std::string> files;
+	std::map<std::string, ExpandedShader> expanded; // clé : chemin puis defines
+	size_t hits = 0, misses = 0;
+};
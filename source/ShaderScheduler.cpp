@@ -0,0 +1,243 @@
+#include "ShaderScheduler.h"
+
+#include <cstring>
+#include <stdexcept>
+
+// Jetons de GL_KHR_parallel_shader_compile, absents du loader glad (4.6 core sans extensions)
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace
+{
+	using MaxShaderCompilerThreads = void (APIENTRY*)(GLuint count);
+
+	std::string GlString(GLenum name)
+	{
+		const auto s = glGetString(name);
+		return s ? (const char*) s : "";
+	}
+
+	bool HasExtension(const char* name)
+	{
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (GLint i = 0; i < count; i++)
+		{
+			const auto extension = (const char*) glGetStringi(GL_EXTENSIONS, i);
+			if (extension && std::strcmp(extension, name) == 0)
+				return true;
+		}
+		return false;
+	}
+
+	double MillisecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+ShaderScheduler::ShaderScheduler(const ProgramCache* cache, ProcLoader loader)
+	: cache(cache)
+{
+	const auto khr = HasExtension("GL_KHR_parallel_shader_compile");
+	parallel = khr || HasExtension("GL_ARB_parallel_shader_compile");
+
+	// Laisse le driver choisir le nombre de threads de compilation (0xFFFFFFFF)
+	if (parallel && loader)
+	{
+		const auto maxThreads = (MaxShaderCompilerThreads) loader(khr ? "glMaxShaderCompilerThreadsKHR" : "glMaxShaderCompilerThreadsARB");
+		if (maxThreads)
+			maxThreads(0xFFFFFFFF);
+	}
+
+	// Sans format binaire supporté par le driver, le cache ne sert à rien
+	GLint formats = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+	binaries = cache && formats > 0;
+
+	driver[0] = GlString(GL_VENDOR);
+	driver[1] = GlString(GL_RENDERER);
+	driver[2] = GlString(GL_VERSION);
+}
+
+ShaderScheduler::~ShaderScheduler()
+{
+	for (auto& entry : entries)
+	{
+		for (const auto s : entry.shaders)
+			glDeleteShader(s);
+	}
+}
+
+size_t ShaderScheduler::Submit(std::string name, const std::vector<ShaderStage>& stages)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	std::vector<std::pair<GLuint, std::string>> sources;
+	std::string sourceKey;
+	for (const auto& stage : stages)
+	{
+		const auto& shader = preprocessor.Expand(stage.path, stage.defines);
+		sources.emplace_back(stage.type, shader.source);
+		sourceKey += std::to_string(stage.type) + ":" + std::to_string(shader.hash) + ";";
+	}
+
+	// Les defines sans effet sur le texte développé ne créent pas de nouveau programme
+	const auto existing = programsBySource.find(sourceKey);
+	if (existing != programsBySource.end())
+	{
+		deduplicated++;
+		return existing->second;
+	}
+	programsBySource.emplace(sourceKey, entries.size());
+
+	entries.emplace_back();
+	auto& entry = entries.back();
+	entry.name = std::move(name);
+	entry.start = start;
+	entry.sources = std::move(sources);
+
+	std::vector<std::string> keySources;
+	for (const auto& source : entry.sources)
+	{
+		keySources.push_back(std::to_string(source.first) + source.second);
+	}
+
+	ProgramBinary binary;
+	if (binaries)
+	{
+		entry.key = MakeProgramCacheKey(keySources, driver[0], driver[1], driver[2]);
+		entry.timing.fromCache = cache->Load(entry.key, binary);
+	}
+
+	if (entry.timing.fromCache)
+	{
+		// Le statut du link est lu dans Finish : un binaire refusé y est recompilé
+		entry.program = glCreateProgram();
+		glProgramBinary(entry.program, binary.format, binary.data.data(), (GLsizei) binary.data.size());
+	}
+	else
+	{
+		Compile(entry);
+	}
+
+	entry.timing.submitMs = MillisecondsSince(entry.start);
+	return entries.size() - 1;
+}
+
+void ShaderScheduler::Compile(Entry& entry)
+{
+	// Aucune lecture de statut ici : glGetShaderiv(GL_COMPILE_STATUS) attendrait la fin de la compilation
+	entry.program = glCreateProgram();
+	for (const auto& source : entry.sources)
+	{
+		const auto s = glCreateShader(source.first);
+		const auto data = source.second.data();
+		const auto size = (GLint) source.second.size();
+		glShaderSource(s, 1, &data, &size);
+		glCompileShader(s);
+
+		glAttachShader(entry.program, s);
+		entry.shaders.push_back(s);
+	}
+
+	// Autorise glGetProgramBinary pour le cache de programmes
+	glProgramParameteri(entry.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glLinkProgram(entry.program);
+}
+
+void ShaderScheduler::Finish(Entry& entry)
+{
+	GLint success;
+	glGetProgramiv(entry.program, GL_LINK_STATUS, &success);
+
+	if (!success && entry.timing.fromCache)
+	{
+		// Binaire refusé (driver mis à jour...) : on recompile et on remplace le fichier
+		glDeleteProgram(entry.program);
+		cache->Invalidate(entry.key);
+		entry.timing.fromCache = false;
+
+		Compile(entry);
+		glGetProgramiv(entry.program, GL_LINK_STATUS, &success);
+	}
+
+	if (!success)
+	{
+		// Journal du premier shader en échec, à défaut celui du link
+		GLchar infoLog[512];
+		GLsizei l = 0;
+		for (const auto s : entry.shaders)
+		{
+			GLint compiled;
+			glGetShaderiv(s, GL_COMPILE_STATUS, &compiled);
+			if (!compiled)
+			{
+				glGetShaderInfoLog(s, 512, &l, infoLog);
+				break;
+			}
+		}
+		if (l == 0)
+			glGetProgramInfoLog(entry.program, 512, &l, infoLog);
+
+		throw std::runtime_error(entry.name + ": " + std::string(infoLog, l));
+	}
+
+	for (const auto s : entry.shaders)
+	{
+		glDetachShader(entry.program, s);
+		glDeleteShader(s);
+	}
+	entry.shaders.clear();
+
+	if (binaries && !entry.timing.fromCache)
+	{
+		GLint length = 0;
+		glGetProgramiv(entry.program, GL_PROGRAM_BINARY_LENGTH, &length);
+
+		ProgramBinary binary;
+		GLenum format = 0;
+		binary.data.resize(length);
+		glGetProgramBinary(entry.program, length, nullptr, &format, binary.data.data());
+		binary.format = format;
+
+		cache->Store(entry.key, binary);
+	}
+
+	entry.sources.clear();
+	entry.ready = true;
+	entry.timing.readyMs = MillisecondsSince(entry.start);
+}
+
+size_t ShaderScheduler::Poll()
+{
+	size_t pending = 0;
+	for (auto& entry : entries)
+	{
+		if (entry.ready)
+			continue;
+
+		GLint complete = 0;
+		if (parallel)
+			glGetProgramiv(entry.program, GL_COMPLETION_STATUS_KHR, &complete);
+
+		if (complete)
+			Finish(entry);
+		else
+			pending++;
+	}
+	return pending;
+}
+
+void ShaderScheduler::WaitAll()
+{
+	for (auto& entry : entries)
+	{
+		if (!entry.ready)
+			Finish(entry);
+	}
+}
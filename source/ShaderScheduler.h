@@ -0,0 +1,92 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ProgramCache.h"
+#include "ShaderPreprocessor.h"
+
+// Temps de préparation d'un programme, en millisecondes
+struct ProgramTiming
+{
+	double submitMs = 0.0;  // temps CPU passé dans Submit (lecture des fichiers, envoi au driver)
+	double readyMs = 0.0;   // du début de Submit à la constatation de la fin du link
+	bool fromCache = false; // chargé depuis le cache binaire
+};
+
+// Étape d'un programme : fichier GLSL développé par ShaderPreprocessor avec ses defines
+struct ShaderStage
+{
+	GLuint type;
+	std::string path;
+	ShaderDefines defines = {};
+};
+
+// Compile tous les programmes soumis sans attendre leur statut. Avec GL_KHR_parallel_shader_compile
+// (ou la version ARB), Poll consulte GL_COMPLETION_STATUS_KHR et ne bloque jamais ; sans l'extension,
+// les statuts ne sont lus que dans WaitAll, ce qui laisse au driver le temps de compiler en arrière-plan.
+class ShaderScheduler
+{
+public:
+	// Même signature que glfwGetProcAddress : l'adresse est un pointeur de fonction, pas un void*
+	using ProcAddress = void (*)();
+	using ProcLoader = ProcAddress (*)(const char*);
+
+	// cache est optionnel ; loader (glfwGetProcAddress) sert à charger glMaxShaderCompilerThreadsKHR
+	explicit ShaderScheduler(const ProgramCache* cache = nullptr, ProcLoader loader = nullptr);
+	~ShaderScheduler();
+
+	ShaderScheduler(const ShaderScheduler&) = delete;
+	ShaderScheduler& operator=(const ShaderScheduler&) = delete;
+
+	// Lance la compilation et le link des étapes et renvoie l'identifiant du programme.
+	// Une permutation dont les sources développées sont identiques à un programme déjà soumis renvoie son identifiant.
+	size_t Submit(std::string name, const std::vector<ShaderStage>& stages);
+
+	// Termine les programmes prêts sans bloquer et renvoie le nombre de programmes encore en cours.
+	// Lance std::runtime_error avec le journal du driver si une compilation ou un link a échoué.
+	size_t Poll();
+	void WaitAll();
+
+	bool IsReady(size_t id) const { return entries[id].ready; }
+	// 0 tant que le programme n'est pas prêt
+	GLuint Program(size_t id) const { return entries[id].ready ? entries[id].program : 0; }
+	const std::string& Name(size_t id) const { return entries[id].name; }
+	const ProgramTiming& Timing(size_t id) const { return entries[id].timing; }
+	size_t Size() const { return entries.size(); }
+	size_t Deduplicated() const { return deduplicated; }
+
+	const ShaderPreprocessor& Preprocessor() const { return preprocessor; }
+
+	bool ParallelCompile() const { return parallel; }
+
+private:
+	struct Entry
+	{
+		std::string name;
+		std::vector<std::pair<GLuint, std::string>> sources; // (type, contenu)
+		std::vector<GLuint> shaders;
+		GLuint program = 0;
+		uint64_t key = 0;
+		bool ready = false;
+		std::chrono::steady_clock::time_point start;
+		ProgramTiming timing;
+	};
+
+	void Compile(Entry& entry);
+	void Finish(Entry& entry);
+
+	const ProgramCache* cache;
+	bool parallel = false;
+	bool binaries = false;
+	std::string driver[3];
+	std::vector<Entry> entries;
+	ShaderPreprocessor preprocessor;
+	std::map<std::string, size_t> programsBySource; // types et hash des sources développées -> identifiant
+	size_t deduplicated = 0;
+};
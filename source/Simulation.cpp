@@ -0,0 +1,124 @@
+#include "Simulation.h"
+
+#include <algorithm>
+
+#include "Profiler.h"
+
+Simulation::Simulation(const Scene& scene, double stepSeconds, LightPath lightPath)
+	: scene(scene), stepSeconds(stepSeconds), lightPath(std::move(lightPath))
+{
+}
+
+Simulation::~Simulation()
+{
+	Stop();
+}
+
+double Simulation::Now() const
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void Simulation::Capture(SimulationState& state, double time) const
+{
+	state.translateX = scene.translateX;
+	state.translateY = scene.translateY;
+	state.lightPosition = lightPath ? lightPath(time) : glm::vec3(0.0f);
+}
+
+void Simulation::Start()
+{
+	if (running)
+		return;
+
+	// Premier instantané immobile au temps 0 : le rendu a un état à afficher avant le premier pas
+	start = std::chrono::steady_clock::now();
+	auto& first = snapshots.Back();
+	Capture(first.current, 0.0);
+	first.previous = first.current;
+	first.time = 0.0;
+	first.step = 0;
+	snapshots.Publish();
+
+	running = true;
+	thread = std::thread(&Simulation::Run, this);
+}
+
+void Simulation::Stop()
+{
+	running = false;
+	if (thread.joinable())
+		thread.join();
+}
+
+void Simulation::Run()
+{
+	Profiler::Instance().NameTrack(Profiler::Instance().ThreadTrack(), "Simulation");
+
+	SimulationState current;
+	Capture(current, 0.0);
+
+	uint64_t step = 0;
+	while (running)
+	{
+		std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>((double) (step + 1) * stepSeconds)));
+
+		// Après un long arrêt (débogueur, fenêtre déplacée...) on abandonne le retard au lieu de le rattraper d'un coup
+		const auto due = (uint64_t) (Now() / stepSeconds);
+		if (due > step + MaxCatchUpSteps)
+		{
+			skippedSteps += due - step - 1;
+			step = due - 1;
+		}
+
+		const ProfileScope stepScope("Simulation step");
+		auto& snapshot = snapshots.Back();
+		snapshot.previous = current;
+
+		scene.Update((float) stepSeconds);
+		step++;
+		Capture(current, (double) step * stepSeconds);
+
+		snapshot.current = current;
+		snapshot.time = (double) step * stepSeconds;
+		snapshot.step = step;
+		snapshots.Publish();
+		steps++;
+	}
+}
+
+glm::vec3 Simulation::Interpolate(Scene& target)
+{
+	snapshots.Acquire();
+	const auto& snapshot = snapshots.Front();
+	if (snapshot.current.translateX.size() != target.Size())
+		return snapshot.current.lightPosition;
+
+	// Le rendu a un pas de retard : au temps now - stepSeconds, entre previous (time - stepSeconds) et current (time)
+	const auto age = Now() - snapshot.time;
+	const auto alpha = (float) std::clamp(age / stepSeconds, 0.0, 1.0);
+
+	for (size_t i = 0; i < target.Size(); i++)
+	{
+		target.translateX[i] = glm::mix(snapshot.previous.translateX[i], snapshot.current.translateX[i], alpha);
+		target.translateY[i] = glm::mix(snapshot.previous.translateY[i], snapshot.current.translateY[i], alpha);
+	}
+
+	frames++;
+	snapshotAgeSumMs += age * 1000.0;
+	maxSnapshotAgeMs = std::max(maxSnapshotAgeMs, age * 1000.0);
+
+	return glm::mix(snapshot.previous.lightPosition, snapshot.current.lightPosition, alpha);
+}
+
+SimulationStats Simulation::Stats() const
+{
+	SimulationStats stats;
+	stats.steps = steps;
+	stats.skippedSteps = skippedSteps;
+	stats.frames = frames;
+	stats.meanSnapshotAgeMs = frames > 0 ? snapshotAgeSumMs / (double) frames : 0.0;
+	stats.maxSnapshotAgeMs = maxSnapshotAgeMs;
+	return stats;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <glm/vec3.hpp>
+
+#include "Scene.h"
+#include "TripleBuffer.h"
+
+// Partie de la scène que la simulation fait évoluer
+struct SimulationState
+{
+	std::vector<float> translateX, translateY;
+	glm::vec3 lightPosition = glm::vec3(0.0f);
+};
+
+// États avant et après le dernier pas : le rendu interpole entre les deux sans attendre le pas suivant
+struct SimulationSnapshot
+{
+	SimulationState previous, current;
+	double time = 0.0; // temps simulé de current, en secondes depuis Start
+	uint64_t step = 0;
+};
+
+struct SimulationStats
+{
+	uint64_t steps = 0;
+	uint64_t skippedSteps = 0; // pas abandonnés après un retard de plus de MaxCatchUpSteps
+	uint64_t frames = 0;       // appels à Interpolate
+	double meanSnapshotAgeMs = 0.0; // âge du dernier état publié au moment du rendu
+	double maxSnapshotAgeMs = 0.0;
+};
+
+// Simulation à pas fixe sur son propre thread. Chaque pas avance les entités de stepSeconds par Scene::Update et la lumière
+// selon lightPath(temps), puis publie un instantané dans un triple buffer : la simulation et le rendu ne s'attendent
+// jamais. Le rendu affiche l'état d'un pas en retard, interpolé au temps courant, quelle que soit sa fréquence.
+class Simulation
+{
+public:
+	using LightPath = std::function<glm::vec3(double seconds)>;
+
+	static constexpr int MaxCatchUpSteps = 8;
+
+	// La simulation travaille sur sa copie de la scène : seules les translations de la scène du rendu sont réécrites
+	Simulation(const Scene& scene, double stepSeconds, LightPath lightPath);
+	~Simulation();
+
+	Simulation(const Simulation&) = delete;
+	Simulation& operator=(const Simulation&) = delete;
+
+	void Start();
+	void Stop();
+
+	// Écrit dans scene les translations interpolées au temps courant et renvoie la position de la lumière.
+	// Interpolate et Stats ne s'appellent que depuis un seul thread, celui du rendu.
+	glm::vec3 Interpolate(Scene& scene);
+
+	double StepSeconds() const { return stepSeconds; }
+	// Secondes depuis Start
+	double Now() const;
+
+	SimulationStats Stats() const;
+
+private:
+	void Run();
+	void Capture(SimulationState& state, double time) const;
+
+	Scene scene;
+	const double stepSeconds;
+	const LightPath lightPath;
+
+	TripleBuffer<SimulationSnapshot> snapshots;
+	std::chrono::steady_clock::time_point start;
+
+	std::atomic<bool> running{ false };
+	std::thread thread;
+
+	std::atomic<uint64_t> steps{ 0 };
+	std::atomic<uint64_t> skippedSteps{ 0 };
+
+	// Côté rendu
+	uint64_t frames = 0;
+	double snapshotAgeSumMs = 0.0;
+	double maxSnapshotAgeMs = 0.0;
+};
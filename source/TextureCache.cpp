@@ -0,0 +1,212 @@
+#include "TextureCache.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <utility>
+
+#include "Hash.h"
+
+namespace
+{
+	// En-tête des fichiers de cache, suivi de levelCount LevelHeader, de rectCount tables d'atlas puis des pixels de chaque niveau
+	struct FileHeader
+	{
+		char magic[4];
+		uint32_t formatVersion;
+		uint64_t key;
+		uint32_t levelCount;
+		uint32_t channels;
+		uint32_t compression;
+		uint32_t rectCount;
+		uint64_t checksum;
+	};
+
+	struct LevelHeader
+	{
+		uint32_t width, height;
+	};
+
+	const char Magic[4] = { 'S', 'I', 'T', 'X' };
+	const uint32_t FormatVersion = 3;
+
+	size_t LevelSize(const TextureImage& level, TextureCompression compression)
+	{
+		return compression == TextureCompression::Bc1 ? Bc1Size(level.width, level.height) : (size_t) level.width * level.height * level.channels;
+	}
+
+	uint64_t Checksum(const std::vector<TextureImage>& levels, const std::vector<glm::vec4>& uvRects)
+	{
+		auto h = Fnv1a(FnvOffset, uvRects.data(), uvRects.size() * sizeof(glm::vec4));
+		for (const auto& level : levels)
+			h = Fnv1a(h, level.pixels.data(), level.pixels.size());
+		return h;
+	}
+
+	// Nom propre à chaque écriture : deux Store de la même clé, depuis deux threads ou deux processus,
+	// n'écrivent jamais dans le même fichier temporaire
+	std::string TemporaryPath(const std::string& path)
+	{
+		static std::atomic<uint64_t> counter{ 0 };
+		const auto thread = std::hash<std::thread::id>()(std::this_thread::get_id());
+		const auto clock = std::chrono::steady_clock::now().time_since_epoch().count();
+
+		char suffix[64];
+		std::snprintf(suffix, sizeof(suffix), ".%llx.%llx.tmp", (unsigned long long) (thread ^ (size_t) clock), (unsigned long long) counter++);
+		return path + suffix;
+	}
+}
+
+uint64_t MakeTextureCacheKey(const std::string& path, const TextureOptions& options)
+{
+	std::error_code error;
+	const uint64_t size = std::filesystem::file_size(path, error);
+	const int64_t time = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+
+	auto h = Fnv1a(FnvOffset, &FormatVersion, sizeof(FormatVersion));
+	h = Fnv1a(h, path.data(), path.size());
+	h = Fnv1a(h, &size, sizeof(size));
+	h = Fnv1a(h, &time, sizeof(time));
+	h = Fnv1a(h, &options.channels, sizeof(options.channels));
+	h = Fnv1a(h, &options.filter, sizeof(options.filter));
+	h = Fnv1a(h, &options.compression, sizeof(options.compression));
+	if (options.compression != TextureCompression::None)
+		h = Fnv1a(h, &options.quality, sizeof(options.quality));
+	return h;
+}
+
+uint64_t MakeTextureCacheKey(const std::vector<std::string>& paths, const TextureOptions& options, const AtlasOptions& atlasOptions)
+{
+	auto h = Fnv1a(FnvOffset, &atlasOptions.padding, sizeof(atlasOptions.padding));
+	h = Fnv1a(h, &atlasOptions.alignment, sizeof(atlasOptions.alignment));
+	h = Fnv1a(h, &atlasOptions.maxSize, sizeof(atlasOptions.maxSize));
+	for (const auto& path : paths)
+	{
+		const auto key = MakeTextureCacheKey(path, options);
+		h = Fnv1a(h, &key, sizeof(key));
+	}
+	return h;
+}
+
+TextureCache::TextureCache(std::string directory)
+	: directory(std::move(directory))
+{
+}
+
+std::string TextureCache::PathFor(uint64_t key) const
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.tex", (unsigned long long) key);
+	return (std::filesystem::path(directory) / name).string();
+}
+
+bool TextureCache::Load(uint64_t key, LoadedTexture& outTexture) const
+{
+	std::ifstream file(PathFor(key), std::ios::in | std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	FileHeader header;
+	if (!file.read((char*) &header, sizeof(header)))
+		return false;
+
+	if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.formatVersion != FormatVersion || header.key != key
+		|| header.levelCount == 0 || header.levelCount > 32 || header.channels == 0 || header.channels > 4
+		|| header.compression > (uint32_t) TextureCompression::Bc1 || header.rectCount > 65536)
+		return false;
+	const auto compression = (TextureCompression) header.compression;
+
+	std::vector<LevelHeader> sizes(header.levelCount);
+	if (!file.read((char*) sizes.data(), sizes.size() * sizeof(LevelHeader)))
+		return false;
+
+	std::vector<glm::vec4> uvRects(header.rectCount);
+	if (!file.read((char*) uvRects.data(), uvRects.size() * sizeof(glm::vec4)))
+		return false;
+
+	std::vector<TextureImage> levels(header.levelCount);
+	for (size_t i = 0; i < levels.size(); i++)
+	{
+		auto& level = levels[i];
+		level.width = (int) sizes[i].width;
+		level.height = (int) sizes[i].height;
+		level.channels = (int) header.channels;
+
+		// Une taille aberrante vient d'un fichier corrompu
+		if (level.width <= 0 || level.height <= 0 || level.width > 65536 || level.height > 65536)
+			return false;
+
+		level.pixels.resize(LevelSize(level, compression));
+		if (!file.read((char*) level.pixels.data(), level.pixels.size()))
+			return false;
+	}
+
+	if (file.peek() != std::ifstream::traits_type::eof() || Checksum(levels, uvRects) != header.checksum)
+		return false;
+
+	outTexture.levels = std::move(levels);
+	outTexture.compression = compression;
+	outTexture.uvRects = std::move(uvRects);
+	return true;
+}
+
+bool TextureCache::Store(uint64_t key, const LoadedTexture& texture) const
+{
+	const auto& levels = texture.levels;
+	if (levels.empty())
+		return false;
+
+	std::error_code error;
+	std::filesystem::create_directories(directory, error);
+
+	// Écriture dans un fichier temporaire puis renommage : un lecteur ne voit jamais de fichier à moitié écrit
+	const auto path = PathFor(key);
+	const auto temporary = TemporaryPath(path);
+	{
+		std::ofstream file(temporary, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return false;
+
+		FileHeader header;
+		std::memcpy(header.magic, Magic, sizeof(Magic));
+		header.formatVersion = FormatVersion;
+		header.key = key;
+		header.levelCount = (uint32_t) levels.size();
+		header.channels = (uint32_t) levels[0].channels;
+		header.compression = (uint32_t) texture.compression;
+		header.rectCount = (uint32_t) texture.uvRects.size();
+		header.checksum = Checksum(levels, texture.uvRects);
+		file.write((const char*) &header, sizeof(header));
+
+		for (const auto& level : levels)
+		{
+			const LevelHeader size{ (uint32_t) level.width, (uint32_t) level.height };
+			file.write((const char*) &size, sizeof(size));
+		}
+		file.write((const char*) texture.uvRects.data(), texture.uvRects.size() * sizeof(glm::vec4));
+		for (const auto& level : levels)
+			file.write((const char*) level.pixels.data(), level.pixels.size());
+
+		if (!file)
+		{
+			file.close();
+			std::filesystem::remove(temporary, error);
+			return false;
+		}
+	}
+
+	// Le dernier renommage gagne ; les deux fichiers sont complets
+	std::filesystem::rename(temporary, path, error);
+	if (error)
+	{
+		std::error_code ignored;
+		std::filesystem::remove(temporary, ignored);
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <glm/vec4.hpp>
+
+#include "AtlasPacker.h"
+#include "BlockCompression.h"
+#include "MipChain.h"
+
+enum class TextureCompression
+{
+	None, // pixels de channels octets
+	Bc1   // blocs BC1 de 8 octets (GL_COMPRESSED_RGB_S3TC_DXT1_EXT), sans alpha
+};
+
+struct TextureOptions
+{
+	int channels = 3; // SOIL_LOAD_RGB...
+	MipFilter filter = MipFilter::Box;
+	TextureCompression compression = TextureCompression::None;
+	Bc1Quality quality = Bc1Quality::Normal;
+};
+
+// Texture décodée avec sa chaîne de mips, prête à être envoyée niveau par niveau.
+// Compressés, les pixels de chaque niveau contiennent ses blocs et channels reste celui de l'image source.
+struct LoadedTexture
+{
+	std::vector<TextureImage> levels;
+	TextureCompression compression = TextureCompression::None;
+	std::vector<glm::vec4> uvRects; // atlas : table de correspondance de chaque image source, voir TextureAtlas
+	bool fromCache = false;
+	double decodeMs = 0.0;
+	double packMs = 0.0;
+	double occupancy = 0.0; // atlas : aire des images sur l'aire du niveau 0
+	double mipMs = 0.0;
+	double compressMs = 0.0;
+	double psnr = 0.0; // du niveau 0 compressé par rapport à l'image décodée
+};
+
+// Clé d'une texture : chemin, taille et date de modification du fichier, et options de chargement
+uint64_t MakeTextureCacheKey(const std::string& path, const TextureOptions& options);
+
+// Clé d'un atlas : clés de chaque image dans l'ordre et options d'empaquetage
+uint64_t MakeTextureCacheKey(const std::vector<std::string>& paths, const TextureOptions& options, const AtlasOptions& atlasOptions);
+
+// Cache disque des chaînes de mips décodées, un fichier par clé, même principe que ProgramCache.
+// Un fichier tronqué, corrompu ou d'une autre version de format est ignoré par Load.
+class TextureCache
+{
+public:
+	explicit TextureCache(std::string directory);
+
+	bool Load(uint64_t key, LoadedTexture& outTexture) const;
+	// Thread-safe : chaque appel écrit son propre fichier temporaire avant de le renommer
+	bool Store(uint64_t key, const LoadedTexture& texture) const;
+
+	std::string PathFor(uint64_t key) const;
+
+private:
+	std::string directory;
+};
@@ -0,0 +1,116 @@
+#include "TextureLoader.h"
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+#include <SOIL/SOIL.h>
+
+namespace
+{
+	double MillisecondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	TextureImage Decode(const std::string& path, int channels)
+	{
+		TextureImage image;
+		const auto pixels = SOIL_load_image(path.c_str(), &image.width, &image.height, nullptr, channels);
+		if (!pixels)
+		{
+			throw std::runtime_error("Texture not loaded: " + path + " (" + SOIL_last_result() + ")");
+		}
+
+		image.channels = channels;
+		image.pixels.assign(pixels, pixels + (size_t) image.width * image.height * channels);
+		SOIL_free_image_data(pixels);
+		return image;
+	}
+
+	// Mips puis compression du niveau 0 décodé ou empaqueté
+	void BuildLevels(const TextureImage& base, const TextureOptions& options, LoadedTexture& texture)
+	{
+		const auto mipStart = std::chrono::steady_clock::now();
+		texture.levels = BuildMipChain(base, options.filter);
+		texture.mipMs = MillisecondsSince(mipStart);
+
+		if (options.compression == TextureCompression::Bc1)
+		{
+			const auto compressStart = std::chrono::steady_clock::now();
+			for (auto& level : texture.levels)
+				level.pixels = EncodeBc1(level, options.quality);
+			texture.compression = TextureCompression::Bc1;
+			texture.compressMs = MillisecondsSince(compressStart);
+
+			const auto& top = texture.levels[0];
+			texture.psnr = Psnr(base, DecodeBc1(top.pixels.data(), top.width, top.height));
+		}
+	}
+}
+
+LoadedTexture LoadTexture(const std::string& path, const TextureOptions& options, const TextureCache* cache)
+{
+	LoadedTexture texture;
+	const auto key = cache ? MakeTextureCacheKey(path, options) : 0;
+	if (cache && cache->Load(key, texture))
+	{
+		texture.fromCache = true;
+		return texture;
+	}
+
+	const auto decodeStart = std::chrono::steady_clock::now();
+	const auto base = Decode(path, options.channels);
+	texture.decodeMs = MillisecondsSince(decodeStart);
+
+	BuildLevels(base, options, texture);
+
+	if (cache)
+		cache->Store(key, texture);
+
+	return texture;
+}
+
+JobFuture<LoadedTexture> LoadTextureAsync(std::string path, const TextureOptions& options, const TextureCache* cache)
+{
+	return JobSystem::Instance().Async([=]() { return LoadTexture(path, options, cache); });
+}
+
+LoadedTexture LoadTextureAtlas(const std::vector<std::string>& paths, const TextureOptions& options, const AtlasOptions& atlasOptions, const TextureCache* cache)
+{
+	LoadedTexture texture;
+	const auto key = cache ? MakeTextureCacheKey(paths, options, atlasOptions) : 0;
+	if (cache && cache->Load(key, texture))
+	{
+		texture.fromCache = true;
+		return texture;
+	}
+
+	// Une tâche par image ; ParallelFor relance l'exception d'une image illisible
+	const auto decodeStart = std::chrono::steady_clock::now();
+	std::vector<TextureImage> images(paths.size());
+	JobSystem::Instance().ParallelFor(paths.size(), [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+			images[i] = Decode(paths[i], options.channels);
+	});
+	texture.decodeMs = MillisecondsSince(decodeStart);
+
+	const auto packStart = std::chrono::steady_clock::now();
+	auto atlas = BuildAtlas(images, atlasOptions);
+	texture.packMs = MillisecondsSince(packStart);
+	texture.occupancy = atlas.occupancy;
+	texture.uvRects = std::move(atlas.uvRects);
+
+	BuildLevels(atlas.image, options, texture);
+
+	if (cache)
+		cache->Store(key, texture);
+
+	return texture;
+}
+
+JobFuture<LoadedTexture> LoadTextureAtlasAsync(std::vector<std::string> paths, const TextureOptions& options, const AtlasOptions& atlasOptions, const TextureCache* cache)
+{
+	return JobSystem::Instance().Async( [=]() { return LoadTextureAtlas(paths, options, atlasOptions, cache); });
+}
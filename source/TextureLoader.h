@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "JobSystem.h"
+#include "TextureCache.h"
+
+// Décode l'image avec SOIL, construit ses mips et les compresse si demandé, ou relit le résultat depuis le cache.
+// Lance std::runtime_error si l'image ne peut pas être décodée.
+LoadedTexture LoadTexture(const std::string& path, const TextureOptions& options, const TextureCache* cache = nullptr);
+
+// LoadTexture dans le pool commun ; le cache doit vivre jusqu'à la fin du chargement
+JobFuture<LoadedTexture> LoadTextureAsync(std::string path, const TextureOptions& options, const TextureCache* cache = nullptr);
+
+// Décode les images en parallèle dans le pool et les regroupe dans un seul atlas avant les mips et la compression.
+// uvRects donne, dans l'ordre de paths, où lire chaque image : un matériau change de table, pas de texture.
+LoadedTexture LoadTextureAtlas(const std::vector<std::string>& paths, const TextureOptions& options, const AtlasOptions& atlasOptions, const TextureCache* cache = nullptr);
+
+// LoadTextureAtlas dans le pool commun
+JobFuture<LoadedTexture> LoadTextureAtlasAsync(std::vector<std::string> paths, const TextureOptions& options, const AtlasOptions& atlasOptions, const TextureCache* cache = nullptr);
@@ -3,6 +3,8 @@
 #include <glm/glm.hpp>
 #include <vector>
 
+#include "AssetMemory.h"
+
 struct Triangle
 {
 	glm::vec3 p0, p1, p2;
@@ -12,3 +14,7 @@ struct TriangleWithNormal
 {
 	glm::vec3 p0, n0, p1, n1, p2, n2;
 };
+
+// Triangles des maillages côté CPU : alignés et comptés dans le relevé mémoire
+using TriangleList = std::vector<Triangle, TrackedAllocator<Triangle, MemoryCategory::CpuMesh>>;
+using TriangleWithNormalList = std::vector<TriangleWithNormal, TrackedAllocator<TriangleWithNormal, MemoryCategory::CpuMesh>>;
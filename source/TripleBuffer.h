@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Échange sans verrou d'une valeur entre un seul écrivain et un seul lecteur. L'écrivain remplit Back puis Publish,
+// le lecteur appelle Acquire puis lit Front : aucun des deux n'attend l'autre, le lecteur voit toujours la dernière
+// valeur publiée complète et garde la même tant qu'il n'en prend pas de nouvelle.
+template <typename T>
+class TripleBuffer
+{
+public:
+	// Écrivain
+	T& Back() { return slots[back]; }
+	void Publish()
+	{
+		back = middle.exchange(back | FreshBit, std::memory_order_acq_rel) & IndexMask;
+	}
+
+	// Lecteur : vrai si une nouvelle valeur a été prise
+	bool Acquire()
+	{
+		if ((middle.load(std::memory_order_relaxed) & FreshBit) == 0)
+			return false;
+		front = middle.exchange(front, std::memory_order_acq_rel) & IndexMask;
+		return true;
+	}
+	const T& Front() const { return slots[front]; }
+
+private:
+	static constexpr uint8_t IndexMask = 3;
+	static constexpr uint8_t FreshBit = 4; // middle contient une valeur que le lecteur n'a pas encore prise
+
+	T slots[3];
+	uint8_t back = 0;
+	std::atomic<uint8_t> middle{ 1 };
+	uint8_t front = 2;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Miroirs C++ des blocs std140 de shader.vert et shader.frag : un vec3 y occupe 16 octets.
+
+// Bloc FrameData (binding 0) : données communes à toute la frame
+struct FrameUniforms
+{
+	glm::vec4 lightPosition; // xyz
+	glm::vec4 lightEmitted;  // xyz
+};
+
+// Bloc DrawData (binding 1) : données d'un draw call
+struct DrawUniforms
+{
+	glm::mat4 transform;
+	glm::vec4 translate; // xyz
+	glm::vec4 albedo;    // rgb
+	glm::vec4 uvRect;    // Material::uvRect
+};
+
+static_assert(sizeof(FrameUniforms) == 32, "FrameData std140 layout");
+static_assert(sizeof(DrawUniforms) == 112, "DrawData std140 layout");
+
+// Points de binding des blocs, fixés dans les shaders avec layout(binding = ...)
+enum UniformBinding : unsigned
+{
+	FrameDataBinding = 0,
+	DrawDataBinding = 1
+};
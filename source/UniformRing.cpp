@@ -0,0 +1,69 @@
+#include "UniformRing.h"
+
+#include <stdexcept>
+#include <string>
+
+namespace
+{
+	size_t UniformOffsetAlignment()
+	{
+		GLint alignment = 0;
+		glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+		return alignment > 0 ? (size_t) alignment : 256;
+	}
+
+	FenceCallbacks GlFences()
+	{
+		FenceCallbacks fences;
+		fences.insert = []() -> void* { return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0); };
+		fences.wait = [](void* fence)
+		{
+			// Premier essai sans attente : dans le cas normal le GPU a fini depuis longtemps
+			auto status = glClientWaitSync((GLsync) fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+			if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+				return false;
+
+			while (status == GL_TIMEOUT_EXPIRED)
+			{
+				status = glClientWaitSync((GLsync) fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+			}
+			return true;
+		};
+		fences.release = [](void* fence) { glDeleteSync((GLsync) fence); };
+		return fences;
+	}
+
+	size_t SectionSize(size_t allocationsPerFrame, size_t maxAllocationSize, size_t alignment)
+	{
+		return allocationsPerFrame * ((maxAllocationSize + alignment - 1) / alignment * alignment);
+	}
+}
+
+UniformRing::UniformRing(size_t allocationsPerFrame, size_t maxAllocationSize, size_t frameCount)
+	: allocator(SectionSize(allocationsPerFrame, maxAllocationSize, UniformOffsetAlignment()), frameCount, UniformOffsetAlignment(), GlFences())
+{
+	const auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	glCreateBuffers(1, &buffer);
+	glNamedBufferStorage(buffer, allocator.Capacity(), nullptr, flags);
+	gpuBytes.Set(allocator.Capacity());
+	mapped = (unsigned char*) glMapNamedBufferRange(buffer, 0, allocator.Capacity(), flags);
+
+	if (!mapped)
+		throw std::runtime_error("Cannot map uniform ring buffer");
+}
+
+UniformRing::~UniformRing()
+{
+	glUnmapNamedBuffer(buffer);
+	glDeleteBuffers(1, &buffer);
+}
+
+size_t UniformRing::Allocate(size_t size)
+{
+	const auto offset = allocator.Allocate(size);
+	if (offset == RingAllocator::InvalidOffset)
+		throw std::runtime_error("Uniform ring full: cannot allocate " + std::to_string(size) + " bytes");
+
+	return offset;
+}
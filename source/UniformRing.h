@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstring>
+
+#include "AssetMemory.h"
+#include "RingAllocator.h"
+
+// Buffer d'uniforms mappé en permanence et découpé en frames en vol (triple buffering par défaut).
+// Les données sont écrites directement dans la mémoire mappée puis liées par glBindBufferRange.
+class UniformRing
+{
+public:
+	// Dimensionne chaque section pour allocationsPerFrame blocs d'au plus maxAllocationSize octets
+	UniformRing(size_t allocationsPerFrame, size_t maxAllocationSize, size_t frameCount = 3);
+	~UniformRing();
+
+	UniformRing(const UniformRing&) = delete;
+	UniformRing& operator=(const UniformRing&) = delete;
+
+	void BeginFrame() { allocator.BeginFrame(); }
+	void EndFrame() { allocator.EndFrame(); }
+
+	// Copie data dans la section de la frame courante et renvoie son offset dans Buffer()
+	template <typename T>
+	GLintptr Write(const T& data)
+	{
+		const auto offset = Allocate(sizeof(T));
+		std::memcpy(mapped + offset, &data, sizeof(T));
+		return (GLintptr) offset;
+	}
+
+	GLuint Buffer() const { return buffer; }
+	const RingAllocatorStats& Stats() const { return allocator.Stats(); }
+
+private:
+	size_t Allocate(size_t size);
+
+	GLuint buffer;
+	unsigned char* mapped;
+	RingAllocator allocator;
+	TrackedBytes gpuBytes{ MemoryCategory::GpuBuffer };
+};
@@ -1,69 +0,0 @@
-#include "glad/glad.h"
-
-#include <vector>
-#include <fstream>
-#include <sstream>
-#include <iostream>
-
-GLuint MakeShader(GLuint t, std::string path)
-{
-	std::cout << path << std::endl;
-	std::ifstream file(path.c_str(), std::ios::in);
-
-	if(!file.good())
-	{
-		throw std::runtime_error("File not found: " + path);
-	}
-
-	std::ostringstream contents;
-	contents << file.rdbuf();
-	file.close();
-
-	const auto content = contents.str();
-	std::cout << content << std::endl;
-
-	const auto s = glCreateShader(t);
-
-	GLint sizes[] = {(GLint) content.size()};
-	const auto data = content.data();
-
-	glShaderSource(s, 1, &data, sizes);
-	glCompileShader(s);
-
-	GLint success;
-	glGetShaderiv(s, GL_COMPILE_STATUS, &success);
-	if(!success)
-	{
-		GLchar infoLog[512];
-		GLsizei l;
-		glGetShaderInfoLog(s, 512, &l, infoLog);
-
-		throw std::runtime_error(infoLog);
-	}
-
-	return s;
-}
-
-GLuint AttachAndLink(std::vector<GLuint> shaders)
-{
-	const auto prg = glCreateProgram();
-	for(const auto s : shaders)
-	{
-		glAttachShader(prg, s);
-	}
-
-	glLinkProgram(prg);
-
-	GLint success;
-	glGetProgramiv(prg, GL_LINK_STATUS, &success);
-	if(!success)
-	{
-		GLchar infoLog[512];
-		GLsizei l;
-		glGetProgramInfoLog(prg, 512, &l, infoLog);
-
-		throw std::runtime_error(infoLog);
-	}
-
-	return prg;
-}
@@ -2,7 +2,7 @@
 
 #include <fstream>
 
-std::vector<Triangle> ReadStl(const char * filename)
+TriangleList ReadStl(const char * filename)
 {
 	std::ifstream file(filename, std::ios::in | std::ios::binary);
 	if (file.is_open())
@@ -13,7 +13,7 @@ std::vector<Triangle> ReadStl(const char * filename)
 		unsigned triCount;
 		file.read((char*) &triCount, 4);
 
-		std::vector<Triangle> tris;
+		TriangleList tris;
 		tris.reserve(triCount);
 
 		for(unsigned i = 0; i < triCount; ++i)
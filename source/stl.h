@@ -5,4 +5,4 @@
 
 #include "Triangle.h"
 
-std::vector<Triangle> ReadStl(const char * filename);
+TriangleList ReadStl(const char * filename);
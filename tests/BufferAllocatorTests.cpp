@@ -0,0 +1,116 @@
+#include <cstring>
+#include <vector>
+
+#include "../source/BufferAllocator.h"
+
+#include "TestSupport.h"
+
+TEST(BufferAllocator, AllocatesFromTheStart)
+{
+	BufferAllocator allocator(1024);
+	CHECK_EQ(allocator.Allocate(100), (size_t) 0);
+	CHECK_EQ(allocator.Allocate(50), (size_t) 100);
+
+	const auto stats = allocator.Stats();
+	CHECK_EQ(stats.used, (size_t) 150);
+	CHECK_EQ(stats.free, (size_t) 874);
+	CHECK_EQ(stats.allocationCount, (size_t) 2);
+	CHECK_EQ(allocator.SizeOf(100), (size_t) 50);
+}
+
+TEST(BufferAllocator, AlignsToAnyMultiple)
+{
+	BufferAllocator allocator(1024);
+	allocator.Allocate(10);
+	// 24 n'est pas une puissance de deux : les sommets de TriangleWithNormal font 24 octets
+	const auto offset = allocator.Allocate(48, 24);
+	CHECK_EQ(offset, (size_t) 24);
+
+	// Le rembourrage reste libre et resert à une petite allocation
+	CHECK_EQ(allocator.Allocate(14), (size_t) 10);
+}
+
+TEST(BufferAllocator, FailsWhenFull)
+{
+	BufferAllocator allocator(100);
+	CHECK_EQ(allocator.Allocate(100), (size_t) 0);
+	CHECK_EQ(allocator.Allocate(1), BufferAllocator::InvalidOffset);
+	CHECK_EQ(allocator.Stats().failedAllocations, (size_t) 1);
+}
+
+TEST(BufferAllocator, PicksTheBestFit)
+{
+	BufferAllocator allocator(1000);
+	const auto a = allocator.Allocate(300);
+	allocator.Allocate(10);
+	const auto b = allocator.Allocate(100);
+	allocator.Allocate(10);
+	allocator.Free(a);
+	allocator.Free(b);
+
+	// Trois trous : 300 au début, 100 au milieu, le reste à la fin ; 80 va dans celui de 100
+	CHECK_EQ(allocator.Allocate(80), b);
+}
+
+TEST(BufferAllocator, MergesFreedNeighbours)
+{
+	BufferAllocator allocator(300);
+	const auto a = allocator.Allocate(100);
+	const auto b = allocator.Allocate(100);
+	const auto c = allocator.Allocate(100);
+
+	allocator.Free(a);
+	allocator.Free(c);
+	CHECK_EQ(allocator.Stats().freeBlockCount, (size_t) 2);
+
+	allocator.Free(b);
+	const auto stats = allocator.Stats();
+	CHECK_EQ(stats.freeBlockCount, (size_t) 1);
+	CHECK_EQ(stats.largestFreeBlock, (size_t) 300);
+	CHECK_EQ(stats.Fragmentation(), 0.0f);
+}
+
+TEST(BufferAllocator, RejectsUnknownOffsets)
+{
+	BufferAllocator allocator(100);
+	allocator.Allocate(10);
+	CHECK_THROWS(allocator.Free(5), std::invalid_argument);
+	CHECK_THROWS(allocator.Allocate(0), std::invalid_argument);
+}
+
+TEST(BufferAllocator, DefragmentPacksAndReportsMoves)
+{
+	BufferAllocator allocator(256);
+	const auto a = allocator.Allocate(32);
+	const auto b = allocator.Allocate(32, 16);
+	const auto c = allocator.Allocate(40, 8);
+	allocator.Allocate(16);
+	allocator.Free(a);
+	allocator.Free(allocator.Allocate(8)); // trou sans effet sur le tassement
+
+	// Copie des octets pour vérifier que les déplacements, appliqués dans l'ordre, gardent les données
+	std::vector<unsigned char> buffer(256, 0);
+	std::memset(buffer.data() + b, 0xB, 32);
+	std::memset(buffer.data() + c, 0xC, 40);
+
+	CHECK(allocator.Stats().Fragmentation() > 0.0f);
+	const auto moves = allocator.Defragment();
+	CHECK(!moves.empty());
+	for (const auto& move : moves)
+	{
+		CHECK(move.to < move.from);
+		std::memmove(buffer.data() + move.to, buffer.data() + move.from, move.size);
+	}
+
+	// b passe en 0, c juste derrière sur un multiple de 8
+	CHECK_EQ(allocator.SizeOf(0), (size_t) 32);
+	CHECK_EQ(allocator.SizeOf(32), (size_t) 40);
+	CHECK_EQ((int) buffer[0], 0xB);
+	CHECK_EQ((int) buffer[31], 0xB);
+	CHECK_EQ((int) buffer[32], 0xC);
+	CHECK_EQ((int) buffer[71], 0xC);
+
+	const auto stats = allocator.Stats();
+	CHECK_EQ(stats.freeBlockCount, (size_t) 1);
+	CHECK_EQ(stats.used + stats.free, (size_t) 256);
+}
@@ -0,0 +1,235 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "../source/AssetMemory.h"
+#include "../source/ChunkStreamer.h"
+#include "../source/ChunkedMesh.h"
+#include "../source/JobSystem.h"
+
+#include "TestSupport.h"
+
+namespace
+{
+	// STL binaire de triangles alignés le long de x : les cellules de la grille, donc les morceaux, se suivent en x
+	void WriteLineStl(const std::string& path, uint32_t count)
+	{
+		std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		const char header[80] = {};
+		file.write(header, sizeof(header));
+		file.write((const char*) &count, sizeof(count));
+		for (uint32_t i = 0; i < count; i++)
+		{
+			const auto x = (float) i * 0.125f;
+			const float record[12] = { 0, 0, 0, x, 0, 0, x + 0.1f, 0, 0, x, 0.1f, 0.05f * (float) (i % 3) };
+			const uint16_t attribute = 0;
+			file.write((const char*) record, sizeof(record));
+			file.write((const char*) &attribute, sizeof(attribute));
+		}
+	}
+
+	// Fichier de morceaux de 16 triangles au plus, construit dans un dossier temporaire
+	struct ChunkFixture
+	{
+		TemporaryDirectory directory{ "ChunkStreaming" };
+		uint64_t key = 0;
+		std::string path;
+
+		explicit ChunkFixture(uint32_t triangles = 2048)
+		{
+			const auto stl = directory.File("line.stl");
+			WriteLineStl(stl, triangles);
+			ChunkBuildOptions options;
+			options.gridResolution = 16;
+			options.maxChunkTriangles = 16;
+			key = MakeChunkFileKey(stl, options);
+			path = ChunkFilePath(directory.Path(), key);
+			BuildChunkFile(stl, path, key, options);
+		}
+	};
+
+	std::vector<TriangleWithNormal> ReadChunk(const ChunkFile& file, uint32_t chunk)
+	{
+		std::vector<TriangleWithNormal> triangles(file.Chunks()[chunk].triangleCount);
+		file.Read(chunk, triangles.data());
+		return triangles;
+	}
+
+	bool SameTriangles(const TriangleWithNormal* a, const std::vector<TriangleWithNormal>& b)
+	{
+		return std::memcmp(a, b.data(), b.size() * sizeof(TriangleWithNormal)) == 0;
+	}
+}
+
+TEST(ChunkStreaming, ConcurrentReadsMatchSerialReads)
+{
+	const ChunkFixture fixture;
+	const ChunkFile file(fixture.path, fixture.key);
+	const auto count = (uint32_t) file.Chunks().size();
+	CHECK(count > 16);
+
+	std::vector<std::vector<TriangleWithNormal>> expected;
+	for (uint32_t chunk = 0; chunk < count; chunk++)
+		expected.push_back(ReadChunk(file, chunk));
+
+	// Quatre lecteurs sur le même ChunkFile, chacun dans un ordre différent
+	std::vector<int> mismatches(4, 0);
+	std::vector<std::thread> readers;
+	for (int reader = 0; reader < 4; reader++)
+	{
+		readers.emplace_back([&, reader]()
+		{
+			for (int pass = 0; pass < 20; pass++)
+			{
+				for (uint32_t i = 0; i < count; i++)
+				{
+					const auto chunk = (i * 7 + (uint32_t) reader * 5) % count;
+					if (!SameTriangles(ReadChunk(file, chunk).data(), expected[chunk]))
+						mismatches[reader]++;
+				}
+			}
+		});
+	}
+	for (auto& reader : readers)
+		reader.join();
+
+	for (int reader = 0; reader < 4; reader++)
+		CHECK_EQ(mismatches[reader], 0);
+}
+
+TEST(ChunkStreaming, UploadsStayUnderTheFrameLimit)
+{
+	const ChunkFixture fixture;
+	const ChunkFile file(fixture.path, fixture.key);
+
+	for (size_t threads : { 1, 4 })
+	{
+		JobSystem jobs(threads);
+		ChunkStreamerOptions options;
+		options.gpuSlots = 12;
+		options.prefetchChunks = 4;
+		options.maxUploadsPerFrame = 3;
+		ChunkStreamer streamer(file, options, jobs);
+
+		std::set<uint32_t> uploaded;
+		for (int frame = 0; frame < 2000 && streamer.Draws().size() < options.gpuSlots; frame++)
+		{
+			// Laisse aux threads de travail le temps de lire entre deux frames
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			streamer.Update(glm::vec3(0.0f));
+			CHECK(streamer.Uploads().size() <= options.maxUploadsPerFrame);
+			for (const auto& upload : streamer.Uploads())
+			{
+				CHECK(upload.slot < streamer.GpuSlots());
+				CHECK(SameTriangles(upload.triangles, ReadChunk(file, upload.chunk)));
+				uploaded.insert(upload.chunk);
+			}
+		}
+
+		// Vue immobile : les gpuSlots morceaux les plus proches finissent tous sur le GPU, envoyés une fois chacun
+		CHECK_EQ(streamer.Draws().size(), options.gpuSlots);
+		CHECK_EQ(uploaded.size(), options.gpuSlots);
+		CHECK_EQ(streamer.Stats().uploads, (uint64_t) options.gpuSlots);
+	}
+}
+
+TEST(ChunkStreaming, PinnedChunksAreNeverEvicted)
+{
+	const ChunkFixture fixture;
+	const ChunkFile file(fixture.path, fixture.key);
+
+	// Cache de 2 morceaux pour 4 voulus, un envoi par frame : chaque morceau lu attend son envoi dans le cache.
+	// S'il était repris avant, il serait relu : chaque morceau doit être lu une seule fois.
+	JobSystem jobs(1);
+	ChunkStreamerOptions options;
+	options.cpuBudgetBytes = 2 * file.MaxChunkTriangles() * sizeof(TriangleWithNormal);
+	options.gpuSlots = 4;
+	options.prefetchChunks = 0;
+	options.maxUploadsPerFrame = 1;
+	ChunkStreamer streamer(file, options, jobs);
+
+	std::set<uint32_t> uploaded;
+	uint64_t uploadedBytes = 0;
+	for (int frame = 0; frame < 50; frame++)
+	{
+		streamer.Update(glm::vec3(0.0f));
+		CHECK(streamer.Stats().cpuResident <= 2);
+		for (const auto& upload : streamer.Uploads())
+		{
+			CHECK(SameTriangles(upload.triangles, ReadChunk(file, upload.chunk)));
+			uploaded.insert(upload.chunk);
+			uploadedBytes += upload.triangleCount * sizeof(TriangleWithNormal);
+		}
+	}
+
+	const auto stats = streamer.Stats();
+	CHECK_EQ(uploaded.size(), (size_t) 4);
+	CHECK_EQ(stats.drawn, (size_t) 4);
+	CHECK_EQ(stats.misses, (uint64_t) 4);
+	CHECK_EQ(stats.bytesRead, uploadedBytes);
+	// Les morceaux déjà envoyés ont laissé leur place aux suivants
+	CHECK_EQ(stats.cpuEvictions, (uint64_t) 2);
+}
+
+TEST(ChunkStreaming, LeastRecentlyWantedSlotIsReused)
+{
+	const ChunkFixture fixture;
+	const ChunkFile file(fixture.path, fixture.key);
+	const auto& chunks = file.Chunks();
+	const auto minX = std::min_element(chunks.begin(), chunks.end(), [](const ChunkInfo& a, const ChunkInfo& b) { return a.boundsMin.x < b.boundsMin.x; })->boundsMin.x;
+	const auto maxX = std::max_element(chunks.begin(), chunks.end(), [](const ChunkInfo& a, const ChunkInfo& b) { return a.boundsMax.x < b.boundsMax.x; })->boundsMax.x;
+
+	JobSystem jobs(1);
+	ChunkStreamerOptions options;
+	options.gpuSlots = 4;
+	options.prefetchChunks = 0;
+	options.maxUploadsPerFrame = 4;
+	ChunkStreamer streamer(file, options, jobs);
+
+	// Vue à une extrémité puis à l'autre : les 4 emplacements passent aux morceaux de l'autre bout
+	std::set<uint32_t> first, second;
+	for (int frame = 0; frame < 10; frame++)
+	{
+		streamer.Update(glm::vec3(minX - 1.0f, 0.0f, 0.0f));
+		for (const auto& upload : streamer.Uploads())
+			first.insert(upload.chunk);
+	}
+	for (int frame = 0; frame < 10; frame++)
+	{
+		streamer.Update(glm::vec3(maxX + 1.0f, 0.0f, 0.0f));
+		for (const auto& upload : streamer.Uploads())
+			second.insert(upload.chunk);
+	}
+
+	CHECK_EQ(first.size(), (size_t) 4);
+	CHECK_EQ(second.size(), (size_t) 4);
+	for (const auto chunk : second)
+		CHECK(first.count(chunk) == 0);
+	CHECK_EQ(streamer.Stats().gpuEvictions, (uint64_t) 4);
+	CHECK_EQ(streamer.Draws().size(), (size_t) 4);
+}
+
+TEST(ChunkStreaming, StalePoolHandleReturnsNull)
+{
+	AssetPool pool(MemoryCategory::CpuMesh, 256, 4);
+	const auto first = pool.Allocate();
+	CHECK(pool.Data(first) != nullptr);
+
+	pool.Free(first);
+	CHECK(pool.Data(first) == nullptr);
+
+	// La place est réattribuée : l'ancien handle reste invalide, le rendre à nouveau est sans effet
+	const auto second = pool.Allocate();
+	CHECK_EQ(second.index, first.index);
+	CHECK(pool.Data(first) == nullptr);
+	CHECK(pool.Data(second) != nullptr);
+	pool.Free(first);
+	CHECK(pool.Data(second) != nullptr);
+	CHECK_EQ(pool.BlocksInUse(), (size_t) 1);
+
+	CHECK(pool.Data(PoolHandle()) == nullptr);
+}
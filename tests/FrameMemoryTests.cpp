@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <thread>
+
+#include "../source/FrameArena.h"
+#include "../source/TripleBuffer.h"
+
+#include "TestSupport.h"
+
+TEST(FrameMemory, LinearArenaAlignsAndReusesBlocks)
+{
+	LinearArena arena(1024);
+	const auto a = arena.Allocate(3, 1);
+	const auto b = arena.Allocate(8, 64);
+	CHECK_EQ((uintptr_t) b % 64, (uintptr_t) 0);
+	CHECK(b != a);
+
+	// Plus grand qu'un bloc : bloc dédié
+	const auto big = arena.Allocate(4096);
+	CHECK(big != nullptr);
+	const auto blocks = arena.BlockAllocations();
+	const auto capacity = arena.Capacity();
+
+	// Après Reset, le même travail ne crée plus de bloc
+	arena.Reset();
+	CHECK_EQ(arena.Used(), (size_t) 0);
+	arena.Allocate(3, 1);
+	arena.Allocate(8, 64);
+	arena.Allocate(4096);
+	CHECK_EQ(arena.BlockAllocations(), blocks);
+	CHECK_EQ(arena.Capacity(), capacity);
+}
+
+TEST(FrameMemory, FrameArenaKeepsDataForFrameCountFrames)
+{
+	FrameArena arena(1024, 3);
+	arena.BeginFrame();
+	auto first = static_cast<int*>(arena.ThreadArena().Allocate(sizeof(int)));
+	*first = 7;
+
+	// Deux frames plus tard, la section de la première n'a pas été recyclée
+	arena.BeginFrame();
+	arena.ThreadArena().Allocate(sizeof(int));
+	arena.BeginFrame();
+	arena.ThreadArena().Allocate(sizeof(int));
+	CHECK_EQ(*first, 7);
+
+	// La quatrième frame reprend la première section, au même endroit
+	arena.BeginFrame();
+	CHECK(arena.ThreadArena().Allocate(sizeof(int)) == first);
+	CHECK_EQ(arena.Stats().frames, (uint64_t) 4);
+}
+
+TEST(FrameMemory, FrameArenaHasOneArenaPerThread)
+{
+	FrameArena arena;
+	arena.BeginFrame();
+	LinearArena* mine = &arena.ThreadArena();
+	LinearArena* other = nullptr;
+	std::thread([&]() { other = &arena.ThreadArena(); }).join();
+
+	CHECK(mine != other);
+	CHECK(&arena.ThreadArena() == mine);
+	CHECK_EQ(arena.Stats().threadArenas, (size_t) 2);
+}
+
+TEST(FrameMemory, TripleBufferHandsOverTheLatestValue)
+{
+	TripleBuffer<int> buffer;
+	CHECK(!buffer.Acquire());
+
+	buffer.Back() = 1;
+	buffer.Publish();
+	buffer.Back() = 2;
+	buffer.Publish();
+
+	// Le lecteur ne voit que la dernière valeur publiée, et la garde tant qu'il n'en prend pas d'autre
+	CHECK(buffer.Acquire());
+	CHECK_EQ(buffer.Front(), 2);
+	CHECK(!buffer.Acquire());
+	CHECK_EQ(buffer.Front(), 2);
+
+	buffer.Back() = 3;
+	CHECK_EQ(buffer.Front(), 2);
+	buffer.Publish();
+	CHECK(buffer.Acquire());
+	CHECK_EQ(buffer.Front(), 3);
+}
+
+TEST(FrameMemory, TripleBufferNeverShowsATornValue)
+{
+	struct Pair
+	{
+		uint64_t a = 0, b = 0;
+	};
+
+	TripleBuffer<Pair> buffer;
+	std::thread writer([&]()
+	{
+		for (uint64_t i = 1; i <= 200000; i++)
+		{
+			buffer.Back() = { i, ~i };
+			buffer.Publish();
+		}
+	});
+
+	uint64_t last = 0;
+	bool ordered = true, whole = true;
+	while (last < 200000)
+	{
+		if (!buffer.Acquire())
+			continue;
+		const auto value = buffer.Front();
+		whole = whole && value.b == ~value.a;
+		ordered = ordered && value.a > last;
+		last = value.a;
+	}
+	writer.join();
+
+	CHECK(whole);
+	CHECK(ordered);
+}
@@ -0,0 +1,131 @@
+#include <string>
+#include <vector>
+
+#include "../source/GlStateCache.h"
+
+#include "TestSupport.h"
+
+namespace
+{
+	// Appels reçus par la table factice, dans l'ordre
+	std::vector<std::string> calls;
+
+	void Record(const std::string& call) { calls.push_back(call); }
+
+	GlDispatch MakeMockDispatch()
+	{
+		calls.clear();
+
+		GlDispatch gl;
+		gl.useProgram = [](uint32_t program) { Record("useProgram " + std::to_string(program)); };
+		gl.bindTextureUnit = [](uint32_t unit, uint32_t texture) { Record("bindTextureUnit " + std::to_string(unit) + " " + std::to_string(texture)); };
+		gl.bindVertexArray = [](uint32_t vao) { Record("bindVertexArray " + std::to_string(vao)); };
+		gl.bindBufferRange = [](uint32_t, uint32_t index, uint32_t buffer, ptrdiff_t offset, ptrdiff_t)
+		{
+			Record("bindBufferRange " + std::to_string(index) + " " + std::to_string(buffer) + " " + std::to_string(offset));
+		};
+		gl.uniform1i = [](int32_t location, int32_t v) { Record("uniform1i " + std::to_string(location) + " " + std::to_string(v)); };
+		gl.uniform3f = [](int32_t location, float, float, float) { Record("uniform3f " + std::to_string(location)); };
+		gl.uniform3fv = [](int32_t location, int32_t, const float*) { Record("uniform3fv " + std::to_string(location)); };
+		gl.uniformMatrix4fv = [](int32_t location, int32_t, uint8_t, const float*) { Record("uniformMatrix4fv " + std::to_string(location)); };
+		return gl;
+	}
+}
+
+TEST(GlStateCache, FiltersRedundantBinds)
+{
+	GlStateCache cache(MakeMockDispatch());
+	cache.UseProgram(3);
+	cache.UseProgram(3);
+	cache.BindVertexArray(1);
+	cache.BindVertexArray(1);
+	cache.BindVertexArray(2);
+	cache.BindTextureUnit(0, 7);
+	cache.BindTextureUnit(0, 7);
+	cache.BindTextureUnit(1, 7);
+
+	const std::vector<std::string> expected = { "useProgram 3", "bindVertexArray 1", "bindVertexArray 2", "bindTextureUnit 0 7", "bindTextureUnit 1 7" };
+	CHECK(calls == expected);
+	CHECK_EQ(cache.TotalStats().issued, (size_t) 5);
+	CHECK_EQ(cache.TotalStats().skipped, (size_t) 3);
+}
+
+TEST(GlStateCache, ComparesWholeBufferRanges)
+{
+	GlStateCache cache(MakeMockDispatch());
+	cache.BindBufferRange(1, 0, 10, 0, 112);
+	cache.BindBufferRange(1, 0, 10, 0, 112);
+	cache.BindBufferRange(1, 0, 10, 256, 112); // même buffer, autre offset (anneau d'uniforms)
+	cache.BindBufferRange(1, 1, 10, 256, 112); // autre index
+	cache.BindBufferRange(2, 1, 10, 256, 112); // autre cible
+
+	CHECK_EQ(calls.size(), (size_t) 4);
+	CHECK_EQ(cache.TotalStats().skipped, (size_t) 1);
+}
+
+TEST(GlStateCache, RemembersUniformsPerProgram)
+{
+	GlStateCache cache(MakeMockDispatch());
+	const float a[] = { 1.0f, 2.0f, 3.0f };
+	const float b[] = { 1.0f, 2.0f, 4.0f };
+
+	cache.UseProgram(1);
+	cache.Uniform3fv(5, a);
+	cache.Uniform3fv(5, a);
+	cache.Uniform3f(5, 1.0f, 2.0f, 3.0f); // même valeur par une autre fonction
+	cache.Uniform3fv(5, b);
+
+	// Le programme 2 a ses propres valeurs, le 1 garde les siennes
+	cache.UseProgram(2);
+	cache.Uniform3fv(5, b);
+	cache.UseProgram(1);
+	cache.Uniform3fv(5, b);
+
+	const std::vector<std::string> expected = { "useProgram 1", "uniform3fv 5", "uniform3fv 5", "useProgram 2", "uniform3fv 5", "useProgram 1" };
+	CHECK(calls == expected);
+}
+
+TEST(GlStateCache, IgnoresMissingUniformsAndUnknownProgram)
+{
+	GlStateCache cache(MakeMockDispatch());
+
+	// Sans programme connu, tout est transmis
+	cache.Uniform1i(2, 4);
+	cache.Uniform1i(2, 4);
+	CHECK_EQ(calls.size(), (size_t) 2);
+
+	// Location -1 : rien n'est envoyé, l'appel est compté comme évité
+	cache.UseProgram(1);
+	cache.Uniform1i(-1, 4);
+	CHECK_EQ(calls.size(), (size_t) 3);
+	CHECK_EQ(cache.TotalStats().skipped, (size_t) 1);
+}
+
+TEST(GlStateCache, InvalidateForgetsState)
+{
+	GlStateCache cache(MakeMockDispatch());
+	const float identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+	cache.UseProgram(1);
+	cache.BindVertexArray(4);
+	cache.UniformMatrix4fv(0, identity);
+	cache.Invalidate();
+	cache.UseProgram(1);
+	cache.BindVertexArray(4);
+	cache.UniformMatrix4fv(0, identity);
+
+	CHECK_EQ(calls.size(), (size_t) 6);
+}
+
+TEST(GlStateCache, FrameStatsResetEachFrame)
+{
+	GlStateCache cache(MakeMockDispatch());
+	cache.UseProgram(1);
+	cache.UseProgram(1);
+	cache.BeginFrame();
+	cache.UseProgram(1);
+
+	CHECK_EQ(cache.FrameStats().issued, (size_t) 0);
+	CHECK_EQ(cache.FrameStats().skipped, (size_t) 1);
+	CHECK_EQ(cache.TotalStats().issued, (size_t) 1);
+	CHECK_EQ(cache.TotalStats().skipped, (size_t) 2);
+}
@@ -0,0 +1,84 @@
+#include <vector>
+
+#include "../source/FrameArena.h"
+#include "../source/IndirectDraws.h"
+
+#include "TestSupport.h"
+
+namespace
+{
+	Scene MakeScene()
+	{
+		Scene scene;
+		scene.AddMaterial({ glm::vec3(0.25f), glm::vec4(0.0f, 0.0f, 0.5f, 1.0f) });
+		scene.AddMaterial({ glm::vec3(0.75f), glm::vec4(0.5f, 0.0f, 0.5f, 1.0f) });
+		scene.AddEntity(1, 0, glm::mat4(1.0f), 0.1f, glm::vec2(0.1f, 0.2f));
+		scene.AddEntity(0, 1, glm::mat4(1.0f), 0.1f, glm::vec2(5.0f, 0.0f)); // hors champ
+		scene.AddEntity(0, 1, glm::mat4(2.0f), 0.1f, glm::vec2(-0.3f, 0.0f));
+		scene.AddEntity(9, 0, glm::mat4(1.0f), 0.1f, glm::vec2(0.0f, 0.0f)); // maillage inconnu
+		scene.AddEntity(2, 0, glm::mat4(1.0f), 0.1f, glm::vec2(0.0f, 0.0f)); // maillage vide
+		return scene;
+	}
+
+	const std::vector<DrawRange> meshRanges = { { 0, 300 }, { 300, 60 }, { 360, 0 } };
+}
+
+TEST(IndirectDraws, OneCommandPerVisibleEntity)
+{
+	const auto scene = MakeScene();
+	std::vector<DrawArraysIndirectCommand> commands;
+	std::vector<DrawUniforms> draws;
+	BuildIndirectDraws(scene, meshRanges, commands, draws);
+
+	CHECK_EQ(commands.size(), (size_t) 2);
+	CHECK_EQ(draws.size(), (size_t) 2);
+
+	CHECK_EQ(commands[0].first, 300u);
+	CHECK_EQ(commands[0].count, 60u);
+	CHECK_EQ(commands[0].instanceCount, 1u);
+	CHECK_EQ(commands[0].baseInstance, 0u);
+	CHECK_EQ(commands[1].first, 0u);
+	CHECK_EQ(commands[1].count, 300u);
+}
+
+TEST(IndirectDraws, DrawDataMatchesCommandIndex)
+{
+	const auto scene = MakeScene();
+	std::vector<DrawArraysIndirectCommand> commands;
+	std::vector<DrawUniforms> draws;
+	BuildIndirectDraws(scene, meshRanges, commands, draws);
+
+	// gl_DrawIDARB i lit draws[i] : entité 0 puis entité 2
+	CHECK_EQ(draws[0].translate.x, 0.1f);
+	CHECK_EQ(draws[0].translate.y, 0.2f);
+	CHECK_EQ(draws[0].albedo.x, 0.25f);
+	CHECK_EQ(draws[1].translate.x, -0.3f);
+	CHECK_EQ(draws[1].transform[0][0], 2.0f);
+	CHECK_EQ(draws[1].albedo.x, 0.75f);
+	CHECK_EQ(draws[1].uvRect.x, 0.5f);
+}
+
+TEST(IndirectDraws, KeepsSceneOrderAcrossChunks)
+{
+	Scene scene;
+	scene.AddMaterial({ glm::vec3(1.0f) });
+	for (size_t i = 0; i < 50000; i++)
+		scene.AddEntity((uint32_t) (i % 2), 0, glm::mat4(1.0f), 0.1f, glm::vec2(i % 5 == 0 ? 5.0f : (float) i / 50000.0f, 0.0f));
+
+	std::vector<DrawArraysIndirectCommand> commands;
+	std::vector<DrawUniforms> draws;
+	FrameArena arena;
+	arena.BeginFrame();
+	BuildIndirectDraws(scene, { { 0, 3 }, { 3, 6 } }, commands, draws, &arena.ThreadArena());
+
+	CHECK_EQ(commands.size(), (size_t) 40000);
+	size_t drawId = 0;
+	for (size_t i = 0; i < scene.Size(); i++)
+	{
+		if (i % 5 == 0)
+			continue;
+		CHECK_EQ(draws[drawId].translate.x, scene.translateX[i]);
+		CHECK_EQ(commands[drawId].first, i % 2 == 0 ? 0u : 3u);
+		drawId++;
+	}
+}
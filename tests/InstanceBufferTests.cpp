@@ -0,0 +1,122 @@
+#include <vector>
+
+#include "../source/FrameArena.h"
+#include "../source/InstanceBuffer.h"
+
+#include "TestSupport.h"
+
+namespace
+{
+	// Trois maillages entrelacés ; les entités dont x vaut 5 sont hors du volume de clip
+	Scene MakeScene(size_t count)
+	{
+		Scene scene;
+		scene.AddMaterial({ glm::vec3(1.0f, 0.0f, 0.0f), glm::vec4(0.0f, 0.0f, 0.5f, 0.5f) });
+		scene.AddMaterial({ glm::vec3(0.0f, 1.0f, 0.0f), glm::vec4(0.5f, 0.0f, 0.5f, 0.5f) });
+		for (size_t i = 0; i < count; i++)
+		{
+			const auto x = i % 4 == 3 ? 5.0f : -0.9f + 1.8f * (float) i / (float) count;
+			scene.AddEntity((uint32_t) (i % 3), (uint32_t) (i % 2), glm::mat4(1.0f), 0.1f, glm::vec2(x, 0.0f));
+		}
+		return scene;
+	}
+
+	void CheckInstances(const Scene& scene, const std::vector<InstanceData>& instances, const std::vector<InstanceBatch>& batches)
+	{
+		// Attendu : par maillage dans l'ordre de première apparition, les entités visibles dans l'ordre de la scène
+		size_t expected = 0;
+		for (const auto& batch : batches)
+		{
+			CHECK_EQ(batch.firstInstance, (uint32_t) expected);
+			size_t n = 0;
+			for (size_t i = 0; i < scene.Size(); i++)
+			{
+				if (scene.meshes[i] != batch.mesh || !scene.IsVisible(i))
+					continue;
+
+				const auto& instance = instances[batch.firstInstance + n];
+				CHECK_EQ(instance.translate.x, scene.translateX[i]);
+				CHECK_EQ(instance.albedo.x, scene.materials[scene.materialIndices[i]].albedo.x);
+				CHECK_EQ(instance.uvRect.x, scene.materials[scene.materialIndices[i]].uvRect.x);
+				n++;
+			}
+			CHECK_EQ(batch.instanceCount, (uint32_t) n);
+			expected += n;
+		}
+		CHECK_EQ(instances.size(), expected);
+	}
+}
+
+TEST(InstanceBuffer, GroupsVisibleEntitiesByMesh)
+{
+	const auto scene = MakeScene(12);
+	std::vector<InstanceData> instances;
+	std::vector<InstanceBatch> batches;
+	BuildInstances(scene, instances, batches);
+
+	CHECK_EQ(batches.size(), (size_t) 3);
+	CHECK_EQ(batches[0].mesh, 0u);
+	CHECK_EQ(batches[1].mesh, 1u);
+	CHECK_EQ(batches[2].mesh, 2u);
+	// 12 entités dont 3 hors champ (i = 3, 7, 11)
+	CHECK_EQ(instances.size(), (size_t) 9);
+	CheckInstances(scene, instances, batches);
+}
+
+TEST(InstanceBuffer, SkipsMeshesWithoutVisibleInstance)
+{
+	Scene scene;
+	scene.AddMaterial({ glm::vec3(1.0f) });
+	scene.AddEntity(7, 0, glm::mat4(1.0f), 0.1f, glm::vec2(5.0f, 0.0f));
+	scene.AddEntity(4, 0, glm::mat4(1.0f), 0.1f, glm::vec2(0.0f, 0.0f));
+
+	std::vector<InstanceData> instances;
+	std::vector<InstanceBatch> batches;
+	BuildInstances(scene, instances, batches);
+
+	CHECK_EQ(batches.size(), (size_t) 1);
+	CHECK_EQ(batches[0].mesh, 4u);
+	CHECK_EQ(batches[0].instanceCount, 1u);
+	CHECK_EQ(instances.size(), (size_t) 1);
+}
+
+TEST(InstanceBuffer, KeepsSceneOrderAcrossChunks)
+{
+	// Assez d'entités pour que les passes soient découpées en plusieurs tranches
+	const auto scene = MakeScene(100000);
+	std::vector<InstanceData> instances;
+	std::vector<InstanceBatch> batches;
+	BuildInstances(scene, instances, batches);
+	CheckInstances(scene, instances, batches);
+}
+
+TEST(InstanceBuffer, SameResultWithFrameArena)
+{
+	const auto scene = MakeScene(5000);
+	std::vector<InstanceData> heapInstances, arenaInstances;
+	std::vector<InstanceBatch> heapBatches, arenaBatches;
+	BuildInstances(scene, heapInstances, heapBatches);
+
+	FrameArena arena;
+	arena.BeginFrame();
+	BuildInstances(scene, arenaInstances, arenaBatches, &arena.ThreadArena());
+
+	CHECK_EQ(arenaInstances.size(), heapInstances.size());
+	CHECK_EQ(arenaBatches.size(), heapBatches.size());
+	for (size_t i = 0; i < heapInstances.size(); i++)
+		CHECK_EQ(arenaInstances[i].translate.x, heapInstances[i].translate.x);
+}
+
+TEST(InstanceBuffer, BoundingRadiusIgnoresTranslation)
+{
+	TriangleWithNormalList triangles(1);
+	triangles[0].p0 = glm::vec3(3.0f, 0.0f, 0.0f);
+	triangles[0].p1 = glm::vec3(0.0f, -4.0f, 0.0f);
+	triangles[0].p2 = glm::vec3(0.0f, 0.0f, 1.0f);
+
+	auto transform = glm::mat4(1.0f);
+	transform[0][0] = 2.0f; // x doublé
+	transform[0][3] = 100.0f; // translation en x, comme dans Scene::ClipCenter
+	transform[1][3] = -50.0f;
+	CHECK_EQ(BoundingRadius(triangles, transform), 6.0f);
+}
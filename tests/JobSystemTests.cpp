@@ -0,0 +1,199 @@
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "../source/JobSystem.h"
+
+#include "TestSupport.h"
+
+// Chaque test crée son propre pool de 4 threads, appelant compris, même sur une machine à un cœur :
+// le thread de si_tests qui le construit en est le thread principal.
+
+TEST(JobSystem, DependenciesRunAfterPrerequisites)
+{
+	JobSystem pool(4);
+	std::atomic<int> clock{ 0 };
+	std::vector<int> finishedAt(6, -1);
+	const auto stamp = [&](int job) { return [&, job]() { std::this_thread::yield(); finishedAt[job] = clock++; }; };
+
+	// 0 -> 1 -> 2, et 3 attend 0, 1 et 2 ; 4 attend 3 une fois celle-ci déjà terminée ; 5 attend un Handle nul
+	const auto a = pool.Submit(stamp(0));
+	const auto b = pool.Submit(stamp(1), { a });
+	const auto c = pool.Submit(stamp(2), { b });
+	const auto d = pool.Submit(stamp(3), { a, b, c });
+	pool.Wait(d);
+	const auto e = pool.Submit(stamp(4), { d });
+	const auto f = pool.Submit(stamp(5), { nullptr });
+	pool.Wait(e);
+	pool.Wait(f);
+
+	CHECK(finishedAt[0] < finishedAt[1]);
+	CHECK(finishedAt[1] < finishedAt[2]);
+	CHECK(finishedAt[2] < finishedAt[3]);
+	CHECK(finishedAt[3] < finishedAt[4]);
+	CHECK(pool.IsDone(f));
+}
+
+TEST(JobSystem, FanInWaitsForEveryPrerequisite)
+{
+	JobSystem pool(4);
+	std::atomic<int> done{ 0 };
+	std::vector<JobSystem::Handle> prerequisites;
+	for (int i = 0; i < 200; i++)
+		prerequisites.push_back(pool.Submit([&]() { done++; }));
+
+	int seen = -1;
+	pool.Wait(pool.Submit([&]() { seen = done.load(); }, prerequisites));
+	CHECK_EQ(seen, 200);
+}
+
+TEST(JobSystem, AsyncReturnsItsValue)
+{
+	JobSystem pool(4);
+	auto first = pool.Async([]() { return 20; });
+	auto second = pool.Async([&]() { return std::vector<int>(22, 1); }, { first.Job() });
+	CHECK_EQ(first.Get() + (int) second.Get().size(), 42);
+}
+
+TEST(JobSystem, ExceptionsPropagateThroughWaitAndGet)
+{
+	JobSystem pool(4);
+	const auto failing = pool.Submit([]() { throw std::runtime_error("job"); });
+	CHECK_THROWS(pool.Wait(failing), std::runtime_error);
+	// L'erreur reste attachée à la tâche : une seconde attente la relance aussi
+	CHECK_THROWS(pool.Wait(failing), std::runtime_error);
+
+	auto future = pool.Async([]() -> int { throw std::invalid_argument("async"); });
+	CHECK_THROWS(future.Get(), std::invalid_argument);
+
+	// Le pool reste utilisable
+	auto ok = pool.Async([]() { return 1; });
+	CHECK_EQ(ok.Get(), 1);
+}
+
+TEST(JobSystem, ExceptionsPropagateThroughParallelFor)
+{
+	JobSystem pool(4);
+	CHECK_THROWS(pool.ParallelFor(10000, [](size_t begin, size_t end)
+	{
+		if (begin <= 7777 && 7777 < end)
+			throw std::runtime_error("range");
+	}), std::runtime_error);
+
+	CHECK_THROWS(pool.ParallelForChunks(10000, 8, [](size_t chunk, size_t, size_t)
+	{
+		if (chunk == 3)
+			throw std::runtime_error("chunk");
+	}), std::runtime_error);
+
+	// Levée dans un ParallelFor imbriqué, lancé depuis les tranches d'un autre
+	std::atomic<int> outerRanges{ 0 };
+	CHECK_THROWS(pool.ParallelFor(64, [&](size_t begin, size_t end)
+	{
+		outerRanges++;
+		for (auto i = begin; i < end; i++)
+		{
+			pool.ParallelFor(1000, [&](size_t innerBegin, size_t innerEnd)
+			{
+				if (i == 42 && innerBegin <= 500 && 500 < innerEnd)
+					throw std::logic_error("nested");
+			}, 16);
+		}
+	}, 4), std::logic_error);
+	CHECK(outerRanges > 0);
+
+	// Un ParallelFor sans erreur après coup
+	std::atomic<size_t> sum{ 0 };
+	pool.ParallelFor(1000, [&](size_t begin, size_t end) { sum += end - begin; });
+	CHECK_EQ(sum.load(), (size_t) 1000);
+}
+
+TEST(JobSystem, MainJobsRunOnlyOnTheMainThread)
+{
+	JobSystem pool(4);
+	const auto mainId = std::this_thread::get_id();
+	std::atomic<int> offMain{ 0 };
+	std::atomic<int> ran{ 0 };
+	const auto check = [&]()
+	{
+		if (std::this_thread::get_id() != mainId)
+			offMain++;
+		ran++;
+	};
+
+	// Soumises depuis le thread principal et depuis des tâches du pool, avec et sans dépendance
+	std::vector<JobSystem::Handle> jobs;
+	for (int i = 0; i < 50; i++)
+		jobs.push_back(pool.SubmitMain(check));
+	for (int i = 0; i < 50; i++)
+	{
+		jobs.push_back(pool.Submit([&]() { pool.SubmitMain(check); }));
+	}
+	const auto worker = pool.Submit([]() {});
+	jobs.push_back(pool.SubmitMain(check, { worker }));
+
+	for (const auto& job : jobs)
+		pool.Wait(job);
+
+	// Les tâches principales soumises par les tâches du pool ne tournent qu'ici
+	while (ran < 101)
+		pool.RunMainThreadJobs();
+
+	CHECK_EQ(ran.load(), 101);
+	CHECK_EQ(offMain.load(), 0);
+}
+
+TEST(JobSystem, ParallelForCoversEveryIndexOnce)
+{
+	JobSystem pool(4);
+	for (size_t count : { 0, 1, 7, 1000, 100003 })
+	{
+		for (size_t grain : { 1, 64, 200000 })
+		{
+			std::vector<std::atomic<int>> hits(count);
+			pool.ParallelFor(count, [&](size_t begin, size_t end)
+			{
+				Check(begin < end && end <= count, "begin < end <= count", __FILE__, __LINE__);
+				for (auto i = begin; i < end; i++)
+					hits[i]++;
+			}, grain);
+
+			for (size_t i = 0; i < count; i++)
+				CHECK_EQ(hits[i].load(), 1);
+		}
+	}
+}
+
+TEST(JobSystem, ParallelForChunksCoversEveryIndexOnce)
+{
+	JobSystem pool(4);
+	for (size_t count : { 1, 3, 1000, 100003 })
+	{
+		for (size_t nChunks : { 1, 2, 4, 8, 13 })
+		{
+			std::vector<std::atomic<int>> hits(count);
+			std::vector<std::atomic<int>> chunks(nChunks);
+			std::vector<size_t> begins(nChunks), ends(nChunks);
+			pool.ParallelForChunks(count, nChunks, [&](size_t chunk, size_t begin, size_t end)
+			{
+				chunks[chunk]++;
+				begins[chunk] = begin;
+				ends[chunk] = end;
+				for (auto i = begin; i < end; i++)
+					hits[i]++;
+			});
+
+			for (size_t i = 0; i < count; i++)
+				CHECK_EQ(hits[i].load(), 1);
+
+			// Chaque tranche une fois, contiguës et dans l'ordre (tranches vides possibles si nChunks > count)
+			for (size_t chunk = 0; chunk < nChunks; chunk++)
+			{
+				CHECK_EQ(chunks[chunk].load(), 1);
+				CHECK_EQ(begins[chunk], chunk == 0 ? (size_t) 0 : ends[chunk - 1]);
+			}
+			CHECK_EQ(ends[nChunks - 1], count);
+		}
+	}
+}
@@ -0,0 +1,146 @@
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "../source/MeshCleanup.h"
+
+#include "TestSupport.h"
+
+namespace
+{
+	// Triangle bien formé distinct pour chaque i
+	Triangle MakeTriangle(size_t i)
+	{
+		const auto x = (float) (i % 1000);
+		const auto y = (float) (i / 1000);
+		return { glm::vec3(x, y, 0.0f), glm::vec3(x + 1.0f, y, 0.0f), glm::vec3(x, y + 1.0f, 0.5f) };
+	}
+
+	bool SameTriangle(const Triangle& a, const Triangle& b)
+	{
+		return a.p0 == b.p0 && a.p1 == b.p1 && a.p2 == b.p2;
+	}
+}
+
+TEST(MeshCleanup, RemovesZeroAreaTriangles)
+{
+	const auto nan = std::numeric_limits<float>::quiet_NaN();
+	const auto inf = std::numeric_limits<float>::infinity();
+	const glm::vec3 a(0.0f), b(1.0f, 0.0f, 0.0f), c(2.0f, 0.0f, 0.0f);
+
+	TriangleList triangles = {
+		MakeTriangle(0),
+		{ a, a, b },                                  // deux sommets confondus
+		{ a, b, c },                                  // alignés
+		{ a, a, a },                                  // réduit à un point
+		{ a, b, glm::vec3(nan, 0.0f, 0.0f) },          // coordonnée invalide
+		{ a, b, glm::vec3(0.0f, inf, 0.0f) },
+		MakeTriangle(1),
+	};
+
+	const auto report = RemoveDegenerateTriangles(triangles);
+	CHECK_EQ(report.degenerate, (size_t) 5);
+	CHECK_EQ(report.kept, (size_t) 2);
+	CHECK_EQ(triangles.size(), (size_t) 2);
+	CHECK(SameTriangle(triangles[0], MakeTriangle(0)));
+	CHECK(SameTriangle(triangles[1], MakeTriangle(1)));
+}
+
+TEST(MeshCleanup, RemovesSliversBelowQuality)
+{
+	// 2 * aire / arête² = 1e-8 : sous le seuil par défaut (1e-6), au-dessus de 1e-9
+	const Triangle sliver = { glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.5f, 1e-8f, 0.0f) };
+	// Même forme mille fois plus grande : la qualité ne dépend pas de l'échelle
+	const Triangle bigSliver = { glm::vec3(0.0f), glm::vec3(1000.0f, 0.0f, 0.0f), glm::vec3(500.0f, 1e-5f, 0.0f) };
+
+	TriangleList triangles = { sliver, MakeTriangle(0), bigSliver };
+	auto report = RemoveDegenerateTriangles(triangles);
+	CHECK_EQ(report.nearDegenerate, (size_t) 2);
+	CHECK_EQ(report.kept, (size_t) 1);
+
+	triangles = { sliver, MakeTriangle(0), bigSliver };
+	report = RemoveDegenerateTriangles(triangles, 1e-9f);
+	CHECK_EQ(report.Removed(), (size_t) 0);
+
+	// 0 désactive le test de qualité
+	triangles = { sliver };
+	CHECK_EQ(RemoveDegenerateTriangles(triangles, 0.0f).kept, (size_t) 1);
+}
+
+TEST(MeshCleanup, RemovesPermutedDuplicates)
+{
+	const auto t = MakeTriangle(7);
+	TriangleList triangles = {
+		t,
+		MakeTriangle(8),
+		{ t.p1, t.p2, t.p0 }, // rotation
+		{ t.p0, t.p2, t.p1 }, // ordre inversé (normale opposée)
+		{ t.p2, t.p1, t.p0 },
+		t,
+	};
+
+	const auto report = RemoveDegenerateTriangles(triangles);
+	CHECK_EQ(report.duplicate, (size_t) 4);
+	CHECK_EQ(report.kept, (size_t) 2);
+	// La première occurrence est gardée, dans l'ordre d'origine
+	CHECK(SameTriangle(triangles[0], t));
+	CHECK(SameTriangle(triangles[1], MakeTriangle(8)));
+}
+
+TEST(MeshCleanup, TreatsNegativeZeroAsZero)
+{
+	const Triangle positive = { glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) };
+	const Triangle negative = { glm::vec3(-0.0f, 0.0f, -0.0f), glm::vec3(1.0f, -0.0f, 0.0f), glm::vec3(-0.0f, 1.0f, -0.0f) };
+
+	TriangleList triangles = { negative, positive };
+	const auto report = RemoveDegenerateTriangles(triangles);
+	CHECK_EQ(report.duplicate, (size_t) 1);
+	CHECK_EQ(triangles.size(), (size_t) 1);
+	CHECK(std::signbit(triangles[0].p0.x));
+}
+
+TEST(MeshCleanup, KeepsOrderAcrossChunks)
+{
+	// Assez de triangles pour plusieurs tranches de tri et de recherche de groupes ;
+	// un triangle sur trois est recopié plus loin avec ses sommets permutés, un sur sept est dégénéré
+	const size_t count = 60000;
+	TriangleList triangles;
+	std::vector<size_t> expected;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (i % 7 == 0)
+		{
+			triangles.push_back({ glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(1.0f) });
+			continue;
+		}
+		triangles.push_back(MakeTriangle(i));
+		expected.push_back(i);
+	}
+	for (size_t i = 0; i < count; i += 3)
+	{
+		if (i % 7 != 0)
+		{
+			const auto t = MakeTriangle(i);
+			triangles.push_back({ t.p2, t.p0, t.p1 });
+		}
+	}
+
+	const auto total = triangles.size();
+	const auto report = RemoveDegenerateTriangles(triangles);
+	CHECK_EQ(report.kept, expected.size());
+	CHECK_EQ(report.degenerate, (count + 6) / 7);
+	CHECK_EQ(report.duplicate, total - expected.size() - report.degenerate);
+	for (size_t i = 0; i < expected.size(); i++)
+		CHECK(SameTriangle(triangles[i], MakeTriangle(expected[i])));
+}
+
+TEST(MeshCleanup, EmptyAndCleanMeshes)
+{
+	TriangleList triangles;
+	CHECK_EQ(RemoveDegenerateTriangles(triangles).kept, (size_t) 0);
+
+	triangles = { MakeTriangle(1), MakeTriangle(2) };
+	const auto report = RemoveDegenerateTriangles(triangles);
+	CHECK_EQ(report.Removed(), (size_t) 0);
+	CHECK_EQ(triangles.size(), (size_t) 2);
+}
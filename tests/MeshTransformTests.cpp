@@ -0,0 +1,94 @@
+#include <cmath>
+
+#include "../source/MeshModifier.h"
+#include "../source/MeshTransform.h"
+
+#include "TestSupport.h"
+
+namespace
+{
+	// Convention de shader.vert, vec4(p, 1) * transform : la colonne j donne la composante j, translation en w.
+	// Échelle non uniforme et cisaillement : l'inverse transposée diffère de la matrice elle-même.
+	glm::mat4 MakeTransform()
+	{
+		glm::mat4 transform(1.0f);
+		transform[0] = glm::vec4(2.0f, 0.5f, 0.0f, 5.0f);
+		transform[1] = glm::vec4(-0.3f, 0.7f, 0.2f, -1.0f);
+		transform[2] = glm::vec4(0.1f, 0.0f, 1.5f, 2.0f);
+		transform[3] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		return transform;
+	}
+
+	// Triangles variés, normales de face calculées comme au chargement
+	TriangleWithNormalList MakeTriangles(size_t count)
+	{
+		TriangleList triangles;
+		for (size_t i = 0; i < count; i++)
+		{
+			const auto a = (float) i * 0.37f;
+			const glm::vec3 p0(std::cos(a), std::sin(a), 0.1f * (float) (i % 11));
+			triangles.push_back({ p0, p0 + glm::vec3(1.0f, 0.2f * std::sin(a), 0.0f), p0 + glm::vec3(0.0f, 1.0f, std::cos(a)) });
+		}
+
+		TriangleWithNormalList withNormals;
+		CreateTriangleWithNormals(triangles, withNormals);
+		return withNormals;
+	}
+
+	bool Near(const glm::vec3& a, const glm::vec3& b, float tolerance)
+	{
+		return glm::length(a - b) <= tolerance * std::max(1.0f, glm::length(b));
+	}
+}
+
+TEST(MeshTransform, PositionsMatchScalarGlm)
+{
+	const auto transform = MakeTransform();
+	const auto source = MakeTriangles(1003);
+	auto baked = source;
+	BakeTransform(baked, transform);
+
+	for (size_t i = 0; i < source.size(); i++)
+	{
+		CHECK(Near(baked[i].p0, glm::vec3(glm::vec4(source[i].p0, 1.0f) * transform), 1e-5f));
+		CHECK(Near(baked[i].p1, glm::vec3(glm::vec4(source[i].p1, 1.0f) * transform), 1e-5f));
+		CHECK(Near(baked[i].p2, glm::vec3(glm::vec4(source[i].p2, 1.0f) * transform), 1e-5f));
+	}
+}
+
+TEST(MeshTransform, NormalsUseTheInverseTranspose)
+{
+	const auto transform = MakeTransform();
+	// Vecteurs lignes : p' = p * A, donc n' = n * transpose(inverse(A))
+	const auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+	const auto source = MakeTriangles(1003);
+	auto baked = source;
+	BakeTransform(baked, transform);
+
+	for (size_t i = 0; i < source.size(); i++)
+	{
+		const auto expected = glm::normalize(source[i].n0 * normalMatrix);
+		CHECK(Near(baked[i].n0, expected, 1e-5f));
+		CHECK(Near(baked[i].n1, expected, 1e-5f));
+		CHECK(Near(baked[i].n2, expected, 1e-5f));
+		CHECK(std::abs(glm::length(baked[i].n0) - 1.0f) < 1e-5f);
+
+		// Indépendamment de la matrice normale : la normale reste perpendiculaire à la face transformée
+		const auto face = glm::normalize(glm::cross(baked[i].p0 - baked[i].p1, baked[i].p0 - baked[i].p2));
+		CHECK(glm::dot(face, baked[i].n0) > 0.9999f);
+	}
+}
+
+TEST(MeshTransform, IdentityKeepsTheMesh)
+{
+	const auto source = MakeTriangles(50001);
+	auto baked = source;
+	BakeTransform(baked, glm::mat4(1.0f));
+
+	for (size_t i = 0; i < source.size(); i++)
+	{
+		CHECK(Near(baked[i].p0, source[i].p0, 1e-6f));
+		CHECK(Near(baked[i].p2, source[i].p2, 1e-6f));
+		CHECK(Near(baked[i].n1, source[i].n1, 1e-6f));
+	}
+}
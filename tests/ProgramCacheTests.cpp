@@ -0,0 +1,147 @@
+#include <vector>
+
+#include "../source/ProgramCache.h"
+
+#include "TestSupport.h"
+
+namespace
+{
+	const std::vector<std::string> sources = { "#version 430\nvoid main() {}", "#version 430\nout vec4 c;\nvoid main() { c = vec4(1); }" };
+
+	uint64_t DefaultKey()
+	{
+		return MakeProgramCacheKey(sources, "Vendor", "Renderer", "4.6", { "#define SHADOWS 1" });
+	}
+
+	ProgramBinary MakeBinary()
+	{
+		ProgramBinary binary;
+		binary.format = 0x8E21;
+		for (int i = 0; i < 300; i++)
+			binary.data.push_back((uint8_t) (i * 7));
+		return binary;
+	}
+
+	// Le fichier de la clé est écrit par Store puis réécrit après modification
+	template <typename F>
+	bool LoadAfterEdit(F edit)
+	{
+		TemporaryDirectory directory("ProgramCache");
+		ProgramCache cache(directory.Path());
+		const auto key = DefaultKey();
+		Check(cache.Store(key, MakeBinary()), "Store", __FILE__, __LINE__);
+
+		auto bytes = ReadFileBytes(cache.PathFor(key));
+		edit(bytes);
+		WriteFileBytes(cache.PathFor(key), bytes);
+
+		ProgramBinary loaded;
+		return cache.Load(key, loaded);
+	}
+
+	// Disposition de l'en-tête : magic[4], version, clé, format, taille, somme de contrôle
+	const size_t VersionOffset = 4;
+	const size_t HeaderSize = 32;
+}
+
+TEST(ProgramCache, KeyChangesWithEveryInput)
+{
+	const auto key = DefaultKey();
+	CHECK_EQ(key, DefaultKey());
+
+	auto otherSources = sources;
+	otherSources[1] += " ";
+	const std::vector<uint64_t> others = {
+		MakeProgramCacheKey(otherSources, "Vendor", "Renderer", "4.6", { "#define SHADOWS 1" }),
+		MakeProgramCacheKey({ sources[0] }, "Vendor", "Renderer", "4.6", { "#define SHADOWS 1" }),
+		MakeProgramCacheKey(sources, "Other", "Renderer", "4.6", { "#define SHADOWS 1" }),
+		MakeProgramCacheKey(sources, "Vendor", "Other", "4.6", { "#define SHADOWS 1" }),
+		MakeProgramCacheKey(sources, "Vendor", "Renderer", "4.5", { "#define SHADOWS 1" }),
+		MakeProgramCacheKey(sources, "Vendor", "Renderer", "4.6", { "#define SHADOWS 0" }),
+		MakeProgramCacheKey(sources, "Vendor", "Renderer", "4.6"),
+	};
+	for (size_t i = 0; i < others.size(); i++)
+	{
+		CHECK(others[i] != key);
+		for (size_t j = 0; j < i; j++)
+			CHECK(others[i] != others[j]);
+	}
+
+	// Les longueurs séparent les chaînes : déplacer un caractère d'une chaîne à l'autre change la clé
+	CHECK(MakeProgramCacheKey({}, "ab", "c", "") != MakeProgramCacheKey({}, "a", "bc", ""));
+}
+
+TEST(ProgramCache, StoreThenLoadRoundTrips)
+{
+	TemporaryDirectory directory("ProgramCache");
+	// Le dossier du cache est créé par Store
+	ProgramCache cache(directory.File("nested"));
+	const auto key = DefaultKey();
+	const auto binary = MakeBinary();
+
+	ProgramBinary loaded;
+	CHECK(!cache.Load(key, loaded));
+	CHECK(cache.Store(key, binary));
+	CHECK(cache.Load(key, loaded));
+	CHECK_EQ(loaded.format, binary.format);
+	CHECK(loaded.data == binary.data);
+
+	// Un binaire vide reste valide
+	CHECK(cache.Store(key + 1, ProgramBinary()));
+	CHECK(cache.Load(key + 1, loaded));
+	CHECK(loaded.data.empty());
+}
+
+TEST(ProgramCache, RejectsTruncatedFiles)
+{
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes.resize(bytes.size() - 1); }));
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes.resize(HeaderSize - 1); }));
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes.clear(); }));
+	// Octets en trop après le binaire
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes.push_back(0); }));
+}
+
+TEST(ProgramCache, RejectsCorruptedPayload)
+{
+	CHECK(LoadAfterEdit([](std::vector<uint8_t>&) {}));
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes[HeaderSize + 100] ^= 1; }));
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes.back() ^= 0x80; }));
+}
+
+TEST(ProgramCache, RejectsWrongMagicOrVersion)
+{
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes[0] = 'X'; }));
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes[VersionOffset]++; }));
+}
+
+TEST(ProgramCache, RejectsKeyMismatch)
+{
+	TemporaryDirectory directory("ProgramCache");
+	ProgramCache cache(directory.Path());
+	const auto key = DefaultKey();
+	const auto other = key ^ 1;
+	CHECK(cache.Store(key, MakeBinary()));
+
+	// Fichier d'une clé déposé sous le nom d'une autre : l'en-tête ne correspond pas
+	WriteFileBytes(cache.PathFor(other), ReadFileBytes(cache.PathFor(key)));
+	ProgramBinary loaded;
+	CHECK(!cache.Load(other, loaded));
+	CHECK(cache.Load(key, loaded));
+}
+
+TEST(ProgramCache, InvalidateRemovesTheEntry)
+{
+	TemporaryDirectory directory("ProgramCache");
+	ProgramCache cache(directory.Path());
+	const auto key = DefaultKey();
+	CHECK(cache.Store(key, MakeBinary()));
+	CHECK(cache.Store(key + 1, MakeBinary()));
+
+	cache.Invalidate(key);
+	ProgramBinary loaded;
+	CHECK(!cache.Load(key, loaded));
+	CHECK(!std::filesystem::exists(cache.PathFor(key)));
+	// Les autres entrées restent, et invalider une entrée absente ne lève pas
+	CHECK(cache.Load(key + 1, loaded));
+	cache.Invalidate(key);
+}
@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "../source/FrameArena.h"
+#include "../source/RenderQueue.h"
+
+#include "TestSupport.h"
+
+namespace
+{
+	// Trie les mêmes commandes avec RenderQueue::Sort et std::stable_sort et compare clés et entités
+	void CheckSortMatchesStableSort(const std::vector<uint64_t>& keys, LinearArena* arena = nullptr)
+	{
+		RenderQueue queue;
+		std::vector<RenderCommand> expected;
+		for (size_t i = 0; i < keys.size(); i++)
+		{
+			queue.Push(keys[i], (uint32_t) i);
+			expected.push_back({ keys[i], (uint32_t) i });
+		}
+
+		queue.Sort(arena);
+		std::stable_sort(expected.begin(), expected.end(), [](const RenderCommand& a, const RenderCommand& b) { return a.key < b.key; });
+
+		const auto& sorted = queue.Commands();
+		CHECK_EQ(sorted.size(), expected.size());
+		for (size_t i = 0; i < expected.size(); i++)
+		{
+			CHECK_EQ(sorted[i].key, expected[i].key);
+			CHECK_EQ(sorted[i].entity, expected[i].entity);
+		}
+	}
+}
+
+TEST(RenderQueue, SortMatchesStableSort)
+{
+	std::mt19937_64 rng(1);
+	// Tailles autour d'une tranche de tri (16384) pour couvrir une et plusieurs tranches
+	for (size_t count : { 0, 1, 2, 1000, 16384, 16385, 100000 })
+	{
+		std::vector<uint64_t> keys(count);
+		for (auto& key : keys)
+			key = rng();
+		CheckSortMatchesStableSort(keys);
+	}
+}
+
+TEST(RenderQueue, SortIsStableForEqualKeys)
+{
+	// Peu de clés distinctes : les entités d'une même clé doivent garder l'ordre d'enregistrement
+	std::mt19937 rng(2);
+	std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+	std::vector<uint64_t> keys(50000);
+	for (auto& key : keys)
+		key = MakeSortKey(rng() % 3, rng() % 5, rng() % 2, (float) (rng() % 4) / 4.0f);
+	CheckSortMatchesStableSort(keys);
+
+	// Octets identiques sur toutes les clés : les passes correspondantes sont sautées
+	for (auto& key : keys)
+		key = MakeSortKey(1, 7, 3, depth(rng));
+	CheckSortMatchesStableSort(keys);
+
+	// Toutes les clés égales
+	std::fill(keys.begin(), keys.end(), 42);
+	CheckSortMatchesStableSort(keys);
+}
+
+TEST(RenderQueue, SortWithFrameArena)
+{
+	std::mt19937_64 rng(3);
+	std::vector<uint64_t> keys(40000);
+	for (auto& key : keys)
+		key = rng();
+
+	FrameArena arena;
+	arena.BeginFrame();
+	CheckSortMatchesStableSort(keys, &arena.ThreadArena());
+}
+
+TEST(RenderQueue, SortKeyOrdersStateThenDepth)
+{
+	CHECK(MakeSortKey(0, 9, 9, 1.0f) < MakeSortKey(1, 0, 0, 0.0f));
+	CHECK(MakeSortKey(1, 0, 9, 1.0f) < MakeSortKey(1, 1, 0, 0.0f));
+	CHECK(MakeSortKey(1, 1, 0, 1.0f) < MakeSortKey(1, 1, 1, 0.0f));
+	CHECK(MakeSortKey(1, 1, 1, 0.25f) < MakeSortKey(1, 1, 1, 0.5f));
+	// Profondeurs hors de [0, 1] ou non finies : bornées
+	CHECK_EQ(MakeSortKey(0, 0, 0, -3.0f), MakeSortKey(0, 0, 0, 0.0f));
+	CHECK_EQ(MakeSortKey(0, 0, 0, 7.0f), MakeSortKey(0, 0, 0, 1.0f));
+	CHECK_EQ(MakeSortKey(0, 0, 0, std::nanf("")), MakeSortKey(0, 0, 0, 1.0f));
+}
+
+TEST(RenderQueue, SubmitSkipsUnchangedState)
+{
+	// Après tri : (p0 m0 mesh0) x2, (p0 m0 mesh1), (p0 m1 mesh1), (p1 m1 mesh1)
+	const std::vector<DrawState> states = {
+		{ 1, 1, 1 }, { 0, 0, 0 }, { 0, 1, 1 }, { 0, 0, 1 }, { 0, 0, 0 },
+	};
+	RenderQueue queue;
+	for (uint32_t i = 0; i < states.size(); i++)
+		queue.Push(MakeSortKey(states[i].program, states[i].material, states[i].mesh, 0.5f), i);
+	queue.Sort();
+
+	std::vector<uint32_t> programs, materials, meshes, drawn;
+	const auto stats = queue.Submit([&](uint32_t entity) { return states[entity]; },
+		[&](uint32_t program) { programs.push_back(program); },
+		[&](uint32_t material) { materials.push_back(material); },
+		[&](uint32_t mesh) { meshes.push_back(mesh); },
+		[&](const RenderCommand& command) { drawn.push_back(command.entity); });
+
+	CHECK_EQ(stats.draws, (size_t) 5);
+	CHECK_EQ(stats.programChanges, (size_t) 2);
+	// Changer de programme redéfinit le matériau et le maillage, même identiques
+	CHECK_EQ(stats.materialChanges, (size_t) 3);
+	CHECK_EQ(stats.meshChanges, (size_t) 3);
+	CHECK(programs == std::vector<uint32_t>({ 0, 1 }));
+	CHECK(materials == std::vector<uint32_t>({ 0, 1, 1 }));
+	CHECK(meshes == std::vector<uint32_t>({ 0, 1, 1 }));
+	CHECK(drawn == std::vector<uint32_t>({ 1, 4, 3, 2, 0 }));
+}
+
+TEST(RenderQueue, SubmitReadsStateBeyondKeyBits)
+{
+	// Matériaux 1 et 65537 : même champ de clé (16 bits), mais états différents relus à la soumission
+	const std::vector<DrawState> states = { { 0, 1, 0 }, { 0, 65537, 0 } };
+	RenderQueue queue;
+	for (uint32_t i = 0; i < states.size(); i++)
+		queue.Push(MakeSortKey(states[i].program, states[i].material, states[i].mesh, 0.5f), i);
+	queue.Sort();
+
+	std::vector<uint32_t> materials;
+	const auto stats = queue.Submit([&](uint32_t entity) { return states[entity]; },
+		[](uint32_t) {},
+		[&](uint32_t material) { materials.push_back(material); },
+		[](uint32_t) {},
+		[](const RenderCommand&) {});
+
+	CHECK_EQ(stats.materialChanges, (size_t) 2);
+	CHECK(materials == std::vector<uint32_t>({ 1, 65537 }));
+}
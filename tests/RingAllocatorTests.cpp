@@ -0,0 +1,155 @@
+#include <stdexcept>
+#include <vector>
+
+#include "../source/RingAllocator.h"
+
+#include "TestSupport.h"
+
+namespace
+{
+	// Barrières factices : un jeton par EndFrame, signalé à la main comme le ferait le GPU
+	struct FakeGpu
+	{
+		std::vector<int> fences;     // 1 si la barrière est franchie
+		std::vector<size_t> waited;  // barrières attendues, dans l'ordre
+		size_t released = 0;
+
+		FenceCallbacks Callbacks()
+		{
+			FenceCallbacks callbacks;
+			callbacks.insert = [this]()
+			{
+				fences.push_back(0);
+				return (void*) fences.size(); // jamais nul
+			};
+			callbacks.wait = [this](void* fence)
+			{
+				const auto index = (size_t) fence - 1;
+				waited.push_back(index);
+				const auto blocked = fences[index] == 0;
+				fences[index] = 1; // l'attente se termine quand le GPU a fini
+				return blocked;
+			};
+			callbacks.release = [this](void*) { released++; };
+			return callbacks;
+		}
+
+		void CompleteAll()
+		{
+			for (auto& fence : fences)
+				fence = 1;
+		}
+	};
+}
+
+TEST(RingAllocator, AlignsOffsetsAndSections)
+{
+	FakeGpu gpu;
+	// 100 octets par frame arrondis à 128 : la section 1 commence à 128
+	RingAllocator ring(100, 3, 64, gpu.Callbacks());
+	CHECK_EQ(ring.Capacity(), (size_t) 384);
+
+	ring.BeginFrame();
+	CHECK_EQ(ring.Allocate(10), (size_t) 0);
+	CHECK_EQ(ring.Allocate(10), (size_t) 64);
+	CHECK_EQ(ring.Allocate(64), RingAllocator::InvalidOffset); // 128 + 64 dépasse la section
+	ring.EndFrame();
+
+	ring.BeginFrame();
+	CHECK_EQ(ring.Allocate(1), (size_t) 128);
+	ring.EndFrame();
+
+	const auto& stats = ring.Stats();
+	CHECK_EQ(stats.allocations, (size_t) 3);
+	CHECK_EQ(stats.overflows, (size_t) 1);
+	CHECK_EQ(stats.bytes, (size_t) 75); // 10 + 54 de rembourrage + 10, puis 1
+	CHECK_EQ(stats.peakFrameBytes, (size_t) 74);
+}
+
+TEST(RingAllocator, WrapsAroundTheSections)
+{
+	FakeGpu gpu;
+	RingAllocator ring(256, 3, 16, gpu.Callbacks());
+
+	std::vector<size_t> offsets;
+	for (int frame = 0; frame < 7; frame++)
+	{
+		gpu.CompleteAll();
+		ring.BeginFrame();
+		offsets.push_back(ring.Allocate(16));
+		ring.EndFrame();
+	}
+
+	const std::vector<size_t> expected = { 0, 256, 512, 0, 256, 512, 0 };
+	CHECK(offsets == expected);
+	CHECK_EQ(ring.CurrentFrame(), (size_t) 0);
+	CHECK_EQ(ring.Stats().frames, (size_t) 7);
+}
+
+TEST(RingAllocator, WaitsForTheFenceBeforeReuse)
+{
+	FakeGpu gpu;
+	RingAllocator ring(64, 2, 16, gpu.Callbacks());
+
+	// Les deux premières frames prennent des sections neuves : aucune attente
+	ring.BeginFrame();
+	ring.EndFrame();
+	ring.BeginFrame();
+	ring.EndFrame();
+	CHECK(gpu.waited.empty());
+
+	// La troisième reprend la section 0 : elle attend la barrière de la frame 0, et seulement celle-là
+	ring.BeginFrame();
+	CHECK_EQ(gpu.waited.size(), (size_t) 1);
+	CHECK_EQ(gpu.waited[0], (size_t) 0);
+	CHECK_EQ(gpu.released, (size_t) 1);
+	ring.EndFrame();
+}
+
+TEST(RingAllocator, CountsOnlyBlockingWaitsAsStalls)
+{
+	FakeGpu gpu;
+	RingAllocator ring(64, 2, 16, gpu.Callbacks());
+	for (int frame = 0; frame < 2; frame++)
+	{
+		ring.BeginFrame();
+		ring.EndFrame();
+	}
+
+	// GPU en avance : la barrière est déjà franchie
+	gpu.fences[0] = 1;
+	ring.BeginFrame();
+	ring.EndFrame();
+	CHECK_EQ(ring.Stats().stalls, (size_t) 0);
+
+	// GPU en retard : l'attente bloque
+	ring.BeginFrame();
+	ring.EndFrame();
+	CHECK_EQ(ring.Stats().stalls, (size_t) 1);
+}
+
+TEST(RingAllocator, ReleasesPendingFencesOnDestruction)
+{
+	FakeGpu gpu;
+	{
+		RingAllocator ring(64, 3, 16, gpu.Callbacks());
+		for (int frame = 0; frame < 2; frame++)
+		{
+			ring.BeginFrame();
+			ring.EndFrame();
+		}
+	}
+	CHECK_EQ(gpu.released, (size_t) 2);
+}
+
+TEST(RingAllocator, RejectsMisuse)
+{
+	FakeGpu gpu;
+	CHECK_THROWS(RingAllocator(64, 0, 16, gpu.Callbacks()), std::invalid_argument);
+
+	RingAllocator ring(64, 2, 16, gpu.Callbacks());
+	CHECK_THROWS(ring.Allocate(4), std::logic_error);
+	CHECK_THROWS(ring.EndFrame(), std::logic_error);
+	ring.BeginFrame();
+	CHECK_THROWS(ring.BeginFrame(), std::logic_error);
+}
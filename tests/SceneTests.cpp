@@ -0,0 +1,61 @@
+#include <cmath>
+
+#include "../source/Scene.h"
+
+#include "TestSupport.h"
+
+namespace
+{
+	// Entités en nombre non multiple de 4 : la boucle SSE et la fin scalaire sont toutes deux parcourues
+	Scene MakeScene()
+	{
+		Scene scene;
+		scene.AddMaterial({ glm::vec3(1.0f) });
+		for (int i = 0; i < 7; i++)
+			scene.AddEntity(0, 0, glm::mat4(1.0f), 0.1f, glm::vec2(-0.5f + 0.1f * (float) i, 0.0f), glm::vec2(0.25f, -0.5f), glm::vec2(10.0f));
+		return scene;
+	}
+
+	bool Near(float a, float b)
+	{
+		return std::abs(a - b) < 1e-4f;
+	}
+}
+
+TEST(Scene, VelocityIsPerSecond)
+{
+	// Une seconde simulée à 30, 60 ou 240 pas par seconde mène au même endroit
+	for (int rate : { 30, 60, 240 })
+	{
+		auto scene = MakeScene();
+		for (int step = 0; step < rate; step++)
+			scene.Update(1.0f / (float) rate);
+
+		for (size_t i = 0; i < scene.Size(); i++)
+		{
+			CHECK(Near(scene.translateX[i], -0.5f + 0.1f * (float) i + 0.25f));
+			CHECK(Near(scene.translateY[i], -0.5f));
+		}
+	}
+}
+
+TEST(Scene, BouncesOffTheLimits)
+{
+	Scene scene;
+	scene.AddMaterial({ glm::vec3(1.0f) });
+	for (int i = 0; i < 5; i++)
+		scene.AddEntity(0, 0, glm::mat4(1.0f), 0.1f, glm::vec2(0.9f, -0.9f), glm::vec2(1.0f, -1.0f), glm::vec2(1.0f));
+
+	// Sortie des limites au premier pas : la vitesse s'inverse sur les deux axes
+	scene.Update(0.2f);
+	for (size_t i = 0; i < scene.Size(); i++)
+	{
+		CHECK(Near(scene.translateX[i], 1.1f));
+		CHECK_EQ(scene.velocityX[i], -1.0f);
+		CHECK_EQ(scene.velocityY[i], 1.0f);
+	}
+
+	scene.Update(0.2f);
+	CHECK(Near(scene.translateX[4], 0.9f));
+	CHECK(Near(scene.translateY[4], -0.9f));
+}
@@ -0,0 +1,189 @@
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "../source/ShaderPreprocessor.h"
+
+#include "TestSupport.h"
+
+namespace
+{
+	void WriteText(const std::string& path, const std::string& text)
+	{
+		std::ofstream file(path, std::ios::out | std::ios::trunc);
+		file << text;
+	}
+
+	size_t Count(const std::string& text, const std::string& pattern)
+	{
+		size_t count = 0;
+		for (auto at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1))
+			count++;
+		return count;
+	}
+
+	// Fichier et ligne qu'un compilateur GLSL attribuerait à la ligne contenant marker, en suivant les #line
+	std::pair<std::string, size_t> Locate(const ExpandedShader& shader, const std::string& marker)
+	{
+		std::istringstream lines(shader.source);
+		std::string line;
+		size_t source = 0, number = 1;
+		while (std::getline(lines, line))
+		{
+			if (line.compare(0, 6, "#line ") == 0)
+			{
+				std::istringstream directive(line.substr(6));
+				directive >> number >> source;
+				continue;
+			}
+			if (line.find(marker) != std::string::npos)
+				return { shader.files.at(source), number };
+			number++;
+		}
+		throw std::runtime_error("marker not found: " + marker);
+	}
+}
+
+TEST(ShaderPreprocessor, ResolvesIncludesOnce)
+{
+	TemporaryDirectory directory("ShaderPreprocessorIncludes");
+	std::filesystem::create_directories(directory.File("common"));
+	WriteText(directory.File("common/math.glsl"), "#pragma once\nfloat Square(float x) { return x * x; }\n");
+	WriteText(directory.File("common/light.glsl"), "#pragma once\n#include \"math.glsl\"\nfloat Light(float x) { return Square(x); }\n");
+	WriteText(directory.File("main.frag"),
+		"#version 330 core\n#include \"light.glsl\"\n#include \"math.glsl\"\n  #  include \"light.glsl\"\nvoid main() {}\n");
+
+	// math.glsl est relatif au fichier qui inclut, light.glsl vient du dossier d'includes
+	ShaderPreprocessor preprocessor(directory.File("common"));
+	const auto& shader = preprocessor.Expand(directory.File("main.frag"));
+
+	CHECK_EQ(Count(shader.source, "float Square"), (size_t) 1);
+	CHECK_EQ(Count(shader.source, "float Light"), (size_t) 1);
+	CHECK_EQ(Count(shader.source, "#version"), (size_t) 1);
+	CHECK_EQ(Count(shader.source, "#include"), (size_t) 0);
+	CHECK_EQ(Count(shader.source, "#pragma"), (size_t) 0);
+	CHECK(shader.source.find("float Square") < shader.source.find("float Light"));
+	CHECK(shader.source.find("float Light") < shader.source.find("void main"));
+	CHECK_EQ(shader.files.size(), (size_t) 3);
+
+	ShaderPreprocessor noIncludeDirectory;
+	CHECK_THROWS(noIncludeDirectory.Expand(directory.File("main.frag")), std::runtime_error);
+}
+
+TEST(ShaderPreprocessor, RejectsCyclesAndMalformedIncludes)
+{
+	TemporaryDirectory directory("ShaderPreprocessorCycles");
+	WriteText(directory.File("a.glsl"), "#include \"b.glsl\"\n");
+	WriteText(directory.File("b.glsl"), "#include \"c.glsl\"\n");
+	WriteText(directory.File("c.glsl"), "#include \"a.glsl\"\n");
+	WriteText(directory.File("self.glsl"), "#include \"self.glsl\"\n");
+	WriteText(directory.File("malformed.glsl"), "#include <a.glsl>\n");
+	WriteText(directory.File("missing.glsl"), "#include \"nowhere.glsl\"\n");
+
+	ShaderPreprocessor preprocessor;
+	CHECK_THROWS(preprocessor.Expand(directory.File("a.glsl")), std::runtime_error);
+	CHECK_THROWS(preprocessor.Expand(directory.File("self.glsl")), std::runtime_error);
+	CHECK_THROWS(preprocessor.Expand(directory.File("malformed.glsl")), std::runtime_error);
+	CHECK_THROWS(preprocessor.Expand(directory.File("missing.glsl")), std::runtime_error);
+
+	// Un fichier inclus deux fois sans cycle n'est pas une erreur, même sans #pragma once
+	WriteText(directory.File("twice.glsl"), "float Twice;\n");
+	WriteText(directory.File("diamond.glsl"), "#include \"twice.glsl\"\n#include \"twice.glsl\"\n");
+	CHECK_EQ(Count(preprocessor.Expand(directory.File("diamond.glsl")).source, "float Twice"), (size_t) 2);
+}
+
+TEST(ShaderPreprocessor, InjectsDefinesAfterVersion)
+{
+	TemporaryDirectory directory("ShaderPreprocessorDefines");
+	WriteText(directory.File("versioned.vert"), "// en-tête\n#version 330 core\nvoid main() { int x = LIGHT_COUNT; }\n");
+	WriteText(directory.File("plain.glsl"), "void main() { int x = LIGHT_COUNT; }\n");
+
+	ShaderPreprocessor preprocessor;
+	const ShaderDefines defines = { { "TEXTURED", "1" }, { "LIGHT_COUNT", "4" } };
+
+	const auto& versioned = preprocessor.Expand(directory.File("versioned.vert"), defines);
+	const auto version = versioned.source.find("#version 330 core\n");
+	CHECK(version != std::string::npos);
+	CHECK_EQ(versioned.source.find("#define TEXTURED 1\n#define LIGHT_COUNT 4\n"), version + 18);
+	CHECK_EQ(Locate(versioned, "void main").second, (size_t) 3);
+
+	// Sans #version, les defines vont en tête
+	const auto& plain = preprocessor.Expand(directory.File("plain.glsl"), defines);
+	CHECK_EQ(plain.source.find("#define TEXTURED 1\n"), (size_t) 0);
+	CHECK_EQ(Locate(plain, "void main").second, (size_t) 1);
+
+	// Sans defines, la source reste celle du fichier
+	const auto& none = preprocessor.Expand(directory.File("versioned.vert"));
+	CHECK_EQ(Count(none.source, "#define"), (size_t) 0);
+}
+
+TEST(ShaderPreprocessor, LineDirectivesMapToSourceFiles)
+{
+	TemporaryDirectory directory("ShaderPreprocessorLines");
+	WriteText(directory.File("inner.glsl"), "#pragma once\n\nfloat inner_marker;\n");
+	WriteText(directory.File("middle.glsl"), "// middle\n#include \"inner.glsl\"\nfloat middle_marker;\n");
+	WriteText(directory.File("main.frag"),
+		"#version 330 core\n// 2\n#include \"middle.glsl\"\n#include \"inner.glsl\"\nfloat main_marker;\nvoid main() {}\n");
+
+	ShaderPreprocessor preprocessor;
+	const auto& shader = preprocessor.Expand(directory.File("main.frag"), { { "QUALITY", "2" } });
+
+	const auto inner = Locate(shader, "inner_marker");
+	const auto middle = Locate(shader, "middle_marker");
+	const auto main = Locate(shader, "main_marker");
+	CHECK(inner.first.find("inner.glsl") != std::string::npos);
+	CHECK_EQ(inner.second, (size_t) 3);
+	CHECK(middle.first.find("middle.glsl") != std::string::npos);
+	CHECK_EQ(middle.second, (size_t) 3);
+	CHECK_EQ(main.first, directory.File("main.frag"));
+	CHECK_EQ(main.second, (size_t) 5);
+	CHECK_EQ(Locate(shader, "void main").second, (size_t) 6);
+}
+
+TEST(ShaderPreprocessor, PermutationsAreCartesianProducts)
+{
+	const auto permutations = MakePermutations({ { "TEXTURED", { "0", "1" } }, { "LIGHT_COUNT", { "1", "2", "4" } } });
+	CHECK_EQ(permutations.size(), (size_t) 6);
+	for (const auto& permutation : permutations)
+		CHECK_EQ(permutation.size(), (size_t) 2);
+	CHECK_EQ(permutations[0][0].value, std::string("0"));
+	CHECK_EQ(permutations[0][1].value, std::string("1"));
+	CHECK_EQ(permutations[1][1].value, std::string("2"));
+	CHECK_EQ(permutations[5][0].value, std::string("1"));
+	CHECK_EQ(permutations[5][1].value, std::string("4"));
+
+	CHECK_EQ(MakePermutations({}).size(), (size_t) 1);
+	CHECK_EQ(MakePermutations({ { "EMPTY", {} } }).size(), (size_t) 0);
+}
+
+TEST(ShaderPreprocessor, PermutationHashesAndCache)
+{
+	TemporaryDirectory directory("ShaderPreprocessorHashes");
+	const std::string text = "#version 330 core\nvoid main() { int x = TEXTURED + LIGHT_COUNT; }\n";
+	WriteText(directory.File("a.frag"), text);
+	WriteText(directory.File("copy.frag"), text);
+
+	ShaderPreprocessor preprocessor;
+	const auto permutations = MakePermutations({ { "TEXTURED", { "0", "1" } }, { "LIGHT_COUNT", { "1", "2", "4" } } });
+
+	std::set<uint64_t> hashes;
+	for (const auto& defines : permutations)
+		hashes.insert(preprocessor.Expand(directory.File("a.frag"), defines).hash);
+	CHECK_EQ(hashes.size(), permutations.size());
+	CHECK_EQ(preprocessor.CacheMisses(), permutations.size());
+	CHECK_EQ(preprocessor.CacheHits(), (size_t) 0);
+
+	// Même permutation : servie par le cache, même objet
+	const auto& first = preprocessor.Expand(directory.File("a.frag"), permutations[3]);
+	const auto& again = preprocessor.Expand(directory.File("a.frag"), permutations[3]);
+	CHECK(&first == &again);
+	CHECK_EQ(preprocessor.CacheHits(), (size_t) 2);
+
+	// Le hash ne dépend que du texte développé : un fichier identique donne les mêmes hashes
+	for (const auto& defines : permutations)
+		CHECK(hashes.count(preprocessor.Expand(directory.File("copy.frag"), defines).hash) == 1);
+	CHECK_EQ(preprocessor.CacheMisses(), 2 * permutations.size());
+}
@@ -0,0 +1,58 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <vector>
+
+#include "TestSupport.h"
+
+namespace
+{
+	struct TestCase
+	{
+		const char* suite;
+		const char* name;
+		TestFunction function;
+	};
+
+	std::vector<TestCase>& Registry()
+	{
+		static std::vector<TestCase> tests;
+		return tests;
+	}
+}
+
+TestRegistrar::TestRegistrar(const char* suite, const char* name, TestFunction function)
+{
+	Registry().push_back({ suite, name, function });
+}
+
+// si_tests [suite] : sans argument, toutes les suites
+int main(int argc, char** argv)
+{
+	const auto suite = argc > 1 ? argv[1] : nullptr;
+
+	size_t run = 0, failed = 0;
+	for (const auto& test : Registry())
+	{
+		if (suite && std::strcmp(suite, test.suite) != 0)
+			continue;
+
+		run++;
+		try
+		{
+			test.function();
+			std::printf("[ ok ] %s.%s\n", test.suite, test.name);
+		}
+		catch (const std::exception& e)
+		{
+			failed++;
+			std::printf("[fail] %s.%s\n       %s\n", test.suite, test.name, e.what());
+		}
+	}
+
+	std::printf("%zu tests, %zu failed\n", run, failed);
+	if (run == 0)
+		std::printf("No test in suite %s\n", suite ? suite : "(all)");
+	return failed == 0 && run > 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
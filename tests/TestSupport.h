@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Tests du cœur sans dépendance externe : chaque TEST s'enregistre au chargement, si_tests exécute ceux d'une suite
+// (ou tous) et renvoie un code d'échec si l'un d'eux lève. CTest lance une entrée par suite.
+//   TEST(BufferAllocator, MergesFreedNeighbours) { ... CHECK(...); CHECK_EQ(a, b); }
+
+using TestFunction = void (*)();
+
+struct TestRegistrar
+{
+	TestRegistrar(const char* suite, const char* name, TestFunction function);
+};
+
+class TestFailure : public std::runtime_error
+{
+public:
+	using std::runtime_error::runtime_error;
+};
+
+template <typename A, typename B>
+void CheckEqual(const A& a, const B& b, const char* expression, const char* file, int line)
+{
+	if (a == b)
+		return;
+
+	std::ostringstream message;
+	message << file << ":" << line << ": CHECK_EQ(" << expression << ") : " << a << " != " << b;
+	throw TestFailure(message.str());
+}
+
+inline void Check(bool condition, const char* expression, const char* file, int line)
+{
+	if (!condition)
+		throw TestFailure(std::string(file) + ":" + std::to_string(line) + ": CHECK(" + expression + ")");
+}
+
+// Dossier vide propre au test, supprimé avec son contenu à la destruction
+class TemporaryDirectory
+{
+public:
+	explicit TemporaryDirectory(const std::string& name)
+		: path(std::filesystem::temp_directory_path() / ("si_tests_" + name))
+	{
+		std::filesystem::remove_all(path);
+		std::filesystem::create_directories(path);
+	}
+
+	~TemporaryDirectory()
+	{
+		std::error_code error;
+		std::filesystem::remove_all(path, error);
+	}
+
+	TemporaryDirectory(const TemporaryDirectory&) = delete;
+	TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+	std::string Path() const { return path.string(); }
+	std::string File(const std::string& name) const { return (path / name).string(); }
+
+private:
+	std::filesystem::path path;
+};
+
+// Contenu brut d'un fichier, pour tronquer ou corrompre les fichiers de cache
+inline std::vector<uint8_t> ReadFileBytes(const std::string& path)
+{
+	std::ifstream file(path, std::ios::in | std::ios::binary);
+	return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+inline void WriteFileBytes(const std::string& path, const std::vector<uint8_t>& bytes)
+{
+	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	file.write((const char*) bytes.data(), bytes.size());
+}
+
+#define TEST(suite, name) \
+	static void suite##_##name(); \
+	static const TestRegistrar suite##_##name##_registrar(#suite, #name, &suite##_##name); \
+	static void suite##_##name()
+
+#define CHECK(condition) Check((condition), #condition, __FILE__, __LINE__)
+#define CHECK_EQ(a, b) CheckEqual((a), (b), #a ", " #b, __FILE__, __LINE__)
+
+// Vérifie que l'expression lève une exception du type donné
+#define CHECK_THROWS(expression, type) \
+	do \
+	{ \
+		bool thrown = false; \
+		try { (void) (expression); } catch (const type&) { thrown = true; } \
+		Check(thrown, #expression " throws " #type, __FILE__, __LINE__); \
+	} while (false)
@@ -0,0 +1,195 @@
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../source/TextureCache.h"
+
+#include "TestSupport.h"
+
+namespace
+{
+	// Chaîne de mips d'une image RGB synthétique, compressée en BC1 si demandé, avec une table d'atlas
+	LoadedTexture MakeTexture(TextureCompression compression)
+	{
+		TextureImage base;
+		base.width = 64;
+		base.height = 32;
+		base.channels = 3;
+		for (int y = 0; y < base.height; y++)
+			for (int x = 0; x < base.width; x++)
+				for (int c = 0; c < 3; c++)
+					base.pixels.push_back((uint8_t) (x * 4 + y * 3 + c * 50));
+
+		LoadedTexture texture;
+		texture.levels = BuildMipChain(base);
+		if (compression == TextureCompression::Bc1)
+		{
+			for (auto& level : texture.levels)
+				level.pixels = EncodeBc1(level);
+		}
+		texture.compression = compression;
+		texture.uvRects = { glm::vec4(0.0f, 0.0f, 0.5f, 1.0f), glm::vec4(0.5f, 0.0f, 1.0f, 1.0f) };
+		return texture;
+	}
+
+	bool SameTexture(const LoadedTexture& a, const LoadedTexture& b)
+	{
+		if (a.compression != b.compression || a.levels.size() != b.levels.size() || a.uvRects.size() != b.uvRects.size())
+			return false;
+		for (size_t i = 0; i < a.levels.size(); i++)
+		{
+			const auto& x = a.levels[i];
+			const auto& y = b.levels[i];
+			if (x.width != y.width || x.height != y.height || x.channels != y.channels || x.pixels != y.pixels)
+				return false;
+		}
+		for (size_t i = 0; i < a.uvRects.size(); i++)
+			if (a.uvRects[i] != b.uvRects[i])
+				return false;
+		return true;
+	}
+
+	size_t FilesIn(const std::string& directory)
+	{
+		size_t count = 0;
+		for (const auto& entry : std::filesystem::directory_iterator(directory))
+			count += entry.is_regular_file() ? 1 : 0;
+		return count;
+	}
+
+	const uint64_t Key = 0x5EEDF00Dull;
+
+	// Le fichier de la clé est écrit par Store puis réécrit après modification
+	template <typename F>
+	bool LoadAfterEdit(F edit)
+	{
+		TemporaryDirectory directory("TextureCache");
+		TextureCache cache(directory.Path());
+		Check(cache.Store(Key, MakeTexture(TextureCompression::Bc1)), "Store", __FILE__, __LINE__);
+
+		auto bytes = ReadFileBytes(cache.PathFor(Key));
+		edit(bytes);
+		WriteFileBytes(cache.PathFor(Key), bytes);
+
+		LoadedTexture loaded;
+		return cache.Load(Key, loaded);
+	}
+
+	// Disposition de l'en-tête : magic[4], version, clé, niveaux, canaux, compression, tables, somme de contrôle
+	const size_t VersionOffset = 4;
+	const size_t HeaderSize = 40;
+}
+
+TEST(TextureCache, StoreThenLoadRoundTrips)
+{
+	TemporaryDirectory directory("TextureCache");
+	// Le dossier du cache est créé par Store
+	TextureCache cache(directory.File("nested"));
+
+	for (const auto compression : { TextureCompression::None, TextureCompression::Bc1 })
+	{
+		const auto key = Key + (uint64_t) compression;
+		const auto texture = MakeTexture(compression);
+
+		LoadedTexture loaded;
+		CHECK(!cache.Load(key, loaded));
+		CHECK(cache.Store(key, texture));
+		CHECK(cache.Load(key, loaded));
+		CHECK(SameTexture(loaded, texture));
+	}
+
+	// Une texture sans niveau n'est pas écrite
+	CHECK(!cache.Store(Key + 10, LoadedTexture()));
+	CHECK_EQ(FilesIn(directory.File("nested")), (size_t) 2);
+}
+
+TEST(TextureCache, RejectsTruncatedFiles)
+{
+	CHECK(LoadAfterEdit([](std::vector<uint8_t>&) {}));
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes.resize(bytes.size() - 1); }));
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes.resize(HeaderSize + 4); }));
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes.resize(HeaderSize - 1); }));
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes.clear(); }));
+	// Octets en trop après le dernier niveau
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes.push_back(0); }));
+}
+
+TEST(TextureCache, RejectsCorruptedFiles)
+{
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes.back() ^= 0x80; }));
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes[bytes.size() / 2] ^= 1; }));
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes[0] = 'X'; }));
+	// Largeur du premier niveau aberrante
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes[HeaderSize + 3] = 0x7F; }));
+}
+
+TEST(TextureCache, RejectsStaleFiles)
+{
+	// Autre version du format
+	CHECK(!LoadAfterEdit([](std::vector<uint8_t>& bytes) { bytes[VersionOffset]++; }));
+
+	// Fichier d'une clé déposé sous le nom d'une autre : l'en-tête ne correspond pas
+	TemporaryDirectory directory("TextureCache");
+	TextureCache cache(directory.Path());
+	CHECK(cache.Store(Key, MakeTexture(TextureCompression::None)));
+	WriteFileBytes(cache.PathFor(Key ^ 1), ReadFileBytes(cache.PathFor(Key)));
+	LoadedTexture loaded;
+	CHECK(!cache.Load(Key ^ 1, loaded));
+	CHECK(cache.Load(Key, loaded));
+
+	// Image modifiée ou autres options : autre clé, l'ancien fichier n'est plus lu
+	const auto image = directory.File("image.png");
+	WriteFileBytes(image, { 1, 2, 3 });
+	TextureOptions options;
+	const auto before = MakeTextureCacheKey(image, options);
+	CHECK_EQ(before, MakeTextureCacheKey(image, options));
+	WriteFileBytes(image, { 1, 2, 3, 4 });
+	CHECK(MakeTextureCacheKey(image, options) != before);
+	options.compression = TextureCompression::Bc1;
+	CHECK(MakeTextureCacheKey(image, options) != MakeTextureCacheKey(image, TextureOptions()));
+}
+
+TEST(TextureCache, ConcurrentStoresOfTheSameKey)
+{
+	TemporaryDirectory directory("TextureCache");
+	const TextureCache cache(directory.Path());
+	const auto plain = MakeTexture(TextureCompression::None);
+	const auto compressed = MakeTexture(TextureCompression::Bc1);
+
+	// Chaque écriture a son fichier temporaire : aucune n'échoue ni n'en corrompt une autre
+	std::vector<int> failures(4, 0);
+	std::vector<std::thread> writers;
+	for (int writer = 0; writer < 4; writer++)
+	{
+		writers.emplace_back([&, writer]()
+		{
+			for (int i = 0; i < 50; i++)
+			{
+				if (!cache.Store(Key, writer % 2 ? compressed : plain))
+					failures[writer]++;
+			}
+		});
+	}
+
+	// Un lecteur pendant les écritures voit l'une ou l'autre texture, jamais un mélange
+	int mixed = 0;
+	for (int i = 0; i < 200; i++)
+	{
+		LoadedTexture loaded;
+		if (cache.Load(Key, loaded) && !SameTexture(loaded, plain) && !SameTexture(loaded, compressed))
+			mixed++;
+	}
+	for (auto& writer : writers)
+		writer.join();
+
+	for (const auto count : failures)
+		CHECK_EQ(count, 0);
+	CHECK_EQ(mixed, 0);
+
+	LoadedTexture loaded;
+	CHECK(cache.Load(Key, loaded));
+	CHECK(SameTexture(loaded, plain) || SameTexture(loaded, compressed));
+	// Plus aucun fichier temporaire
+	CHECK_EQ(FilesIn(directory.Path()), (size_t) 1);
+}